@@ -0,0 +1,898 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcbench.c
+ *
+ *
+ * Purpose:   This program measures every kernel of the crc
+ *            library for every model of the catalogue
+ *            (crcmodel.h). The buffers go from 1 B up to
+ *            1 GiB in steps of four, with an aligned and
+ *            a misaligned start. The throughput is reported
+ *            in cycles per byte and GB/s, as a table on
+ *            stdout and optionally as JSON (-o), so the
+ *            numbers of two releases can be compared.
+ *
+ *
+ * Remarks:   - This program requires the crc library,
+ *              which does not reside in the gcc stdlibs.
+ *
+ *            - The cycles are taken from the time stamp
+ *              counter, which ticks with the nominal clock
+ *              on most recent cpus. Without it (not x86)
+ *              nanoseconds are reported instead.
+ *
+ *            - Every measurement runs for at least
+ *              MIN_SECONDS. A kernel is skipped at a size
+ *              where a single pass would take longer than
+ *              the budget (-t), predicted from the smaller
+ *              size before. This keeps the bitwise kernel
+ *              away from the big buffers.
+ *
+ *            - All checksums are compared against the
+ *              specialized kernel of the model (crcmodel.c),
+ *              a mismatch aborts the program.
+ *
+ *            - Built with zlib=1 the crc32 function of the
+ *              local zlib is a baseline for CRC-32/ISO-HDLC.
+ *
+ *            - -b measures short messages instead: BATCH_MESSAGES
+ *              messages of a size (or mixed sizes) hashed one
+ *              call per message through a crc_ctx, the model
+ *              kernel and crc16_algorithm_lut, and all at once
+ *              with crc_batch. The throughput per message is
+ *              reported against the crc_ctx loop.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crcapi.h>
+#include <crcmodel.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined( __x86_64__ )
+#include <x86intrin.h>
+#endif
+
+#ifdef CRC_BENCH_ZLIB
+#include <zlib.h>
+#endif
+
+#define MIN_SIZE        1UL
+#define MAX_SIZE        ( 1024UL * 1024UL * 1024UL )
+#define MIN_SECONDS     0.02
+#define MAX_ROUNDS      ( 1UL << 24U )
+#define DEF_BUDGET      1.0
+#define MISALIGNMENT    1U
+#define BUF_ALIGNMENT   64UL
+
+/* kernels which are not reached through a crc_ctx */
+#define BENCH_MODEL     ( CRC_KERNEL_COUNT + 0U )
+#define BENCH_CRC16     ( CRC_KERNEL_COUNT + 1U )
+#define BENCH_CRC16_LUT ( CRC_KERNEL_COUNT + 2U )
+#define BENCH_ZLIB      ( CRC_KERNEL_COUNT + 3U )
+
+/* model of the zlib baseline */
+#define ZLIB_MODEL      "CRC-32/ISO-HDLC"
+
+/* short messages of the batch comparison (-b), the sizes of the
+ * mixed set are scattered from BATCH_MIN_LEN to BATCH_MAX_LEN.
+ * All the messages of a set stay in the caches. */
+#define BATCH_MESSAGES  1024U
+#define BATCH_MIN_LEN   64UL
+#define BATCH_MAX_LEN   1500UL
+#define BATCH_MIXED     0UL
+
+/* the ways to hash a set of messages */
+#define BATCH_RUN_LOOP      0U
+#define BATCH_RUN_MODEL     1U
+#define BATCH_RUN_CRC16_LUT 2U
+#define BATCH_RUN_BATCH     3U
+#define BATCH_RUN_COUNT     4U
+
+
+typedef struct bench_kernel
+{
+  const char* name;
+  uint8_t     id;
+
+} bench_kernel_t;
+
+
+typedef struct bench_run
+{
+  const crc_model_t* model;
+  crc_ctx_t*         ctx;
+  uint8_t            id;
+
+  /* throughput at the size before, to predict the next one */
+  double             last_bytes_per_second;
+
+} bench_run_t;
+
+
+typedef struct bench_result
+{
+  double   cycles_per_byte;
+  double   gb_per_second;
+  uint64_t crc;
+  uint8_t  skipped;
+
+} bench_result_t;
+
+
+/* in the order of the table, the model kernel comes first and
+ * is the reference of the others */
+static const bench_kernel_t kernels[] =
+{
+  { "model",     BENCH_MODEL         },
+  { "bitwise",   CRC_KERNEL_BITWISE  },
+  { "crc16",     BENCH_CRC16         },
+  { "crc16_lut", BENCH_CRC16_LUT     },
+  { "lut",       CRC_KERNEL_LUT      },
+  { "slice4",    CRC_KERNEL_SLICE_4  },
+  { "slice8",    CRC_KERNEL_SLICE_8  },
+  { "slice16",   CRC_KERNEL_SLICE_16 },
+  { "clmul",     CRC_KERNEL_CLMUL    },
+  { "sse42",     CRC_KERNEL_SSE42    }
+};
+
+#define KERNEL_COUNT ( ( uint32_t )( sizeof( kernels ) / sizeof( kernels[ 0 ] ) ) )
+
+/* indexed by BATCH_RUN_*, the loop is the reference */
+static const char* batch_run_names[ BATCH_RUN_COUNT ] =
+{
+  "loop", "model", "crc16_lut", "batch"
+};
+
+static const size_t batch_sizes[] =
+{
+  BATCH_MIN_LEN, 256UL, 576UL, BATCH_MAX_LEN, BATCH_MIXED
+};
+
+#define BATCH_SIZE_COUNT ( ( uint32_t )( sizeof( batch_sizes ) / sizeof( batch_sizes[ 0 ] ) ) )
+
+
+typedef struct batch_set
+{
+  const uint8_t* data[ BATCH_MESSAGES ];
+  size_t         len[ BATCH_MESSAGES ];
+  size_t         bytes;
+
+} batch_set_t;
+
+
+static FILE*       json         = NULL;
+static uint32_t    json_results = 0U;
+static size_t      max_size     = MAX_SIZE;
+static double      budget       = DEF_BUDGET;
+static const char* model_filter = NULL;
+static long        width_filter = 0L;
+static uint8_t     batch_mode   = 0x00U;
+
+static batch_set_t batch_set;
+static uint64_t    batch_crcs[ BATCH_RUN_COUNT ][ BATCH_MESSAGES ];
+
+/* keeps the compiler from dropping the repeated passes */
+static uint64_t    sink         = 0UL;
+
+
+static uint64_t get_cycles( void );
+static void fill_random( uint8_t* buf, size_t len );
+static uint64_t run_kernel( const bench_run_t* run, const uint8_t* data, size_t len );
+static uint8_t init_run( bench_run_t* run, const crc_model_t* model, uint8_t id );
+static void measure( bench_run_t* run, const uint8_t* data, size_t len,
+                     bench_result_t* result );
+static void report( const crc_model_t* model, const char* kernel, size_t len,
+                    uint8_t offset, const bench_result_t* result, double zlib_gbps );
+static void bench_model( const crc_model_t* model, uint8_t* buf );
+static void fill_batch_set( const uint8_t* buf, size_t size );
+static void run_batch( uint8_t run, const crc_model_t* model, crc_ctx_t* ctx,
+                       const crc_batch_t* batch );
+static void measure_batch( uint8_t run, const crc_model_t* model, crc_ctx_t* ctx,
+                           const crc_batch_t* batch, bench_result_t* result,
+                           double* ns_per_message );
+static void report_batch( const crc_model_t* model, uint8_t run, size_t size,
+                          const bench_result_t* result, double ns_per_message,
+                          double loop_ns );
+static void bench_batch( const crc_model_t* model, const uint8_t* buf );
+static void parse_args( int argc, char** argv );
+static void print_usage( FILE* out );
+
+
+static uint64_t get_cycles( void )
+{
+#if defined( __x86_64__ )
+  return ( uint64_t )__rdtsc();
+#else
+  /* no time stamp counter, nanoseconds instead */
+  return ( uint64_t )( get_monotonic_seconds() * 1e9 );
+#endif
+}
+
+
+/* xorshift64, rand() takes ages for a GiB */
+static void fill_random( uint8_t* buf, size_t len )
+{
+  uint64_t x = 0x9E3779B97F4A7C15UL;
+  size_t i;
+
+  for( i = 0U; i < len; i++ )
+  {
+    x ^= x << 13U;
+    x ^= x >> 7U;
+    x ^= x << 17U;
+    *( buf + i ) = ( uint8_t )( x >> 32U );
+  }
+}
+
+
+static uint64_t run_kernel( const bench_run_t* run, const uint8_t* data, size_t len )
+{
+  uint16_t crc16 = 0x0000U;
+
+  switch( run->id )
+  {
+    case BENCH_MODEL:
+      return run->model->oneshot( data, len );
+    case BENCH_CRC16:
+      crc16_algorithm( data, ( uint32_t )len, &run->model->params, &crc16,
+                       0xFFU, 0x00U );
+      return ( uint64_t )crc16;
+    case BENCH_CRC16_LUT:
+      crc16_algorithm_lut( data, ( uint32_t )len, &run->model->params, &crc16,
+                           0xFFU, 0x00U );
+      return ( uint64_t )crc16;
+#ifdef CRC_BENCH_ZLIB
+    case BENCH_ZLIB:
+      return ( uint64_t )crc32( 0UL, ( const Bytef* )data, ( uInt )len );
+#endif
+    default:
+      crc_ctx_reset( run->ctx );
+      crc_ctx_update( run->ctx, data, len );
+      return crc_ctx_final( run->ctx );
+  }
+}
+
+
+/* 0x00U if the kernel does not go with the model on this cpu */
+static uint8_t init_run( bench_run_t* run, const crc_model_t* model, uint8_t id )
+{
+  run->model = model;
+  run->ctx   = NULL;
+  run->id    = id;
+  run->last_bytes_per_second = 0.0;
+
+  switch( id )
+  {
+    case BENCH_MODEL:
+      return 0xFFU;
+    case BENCH_CRC16:
+      return ( model->params.degree == 16U ) ? 0xFFU : 0x00U;
+    case BENCH_CRC16_LUT:
+      if( model->params.degree != 16U )
+      {
+        return 0x00U;
+      }
+      /* the tables are global, one model at a time */
+      init_lut_crc_16( &model->params );
+      return 0xFFU;
+    case BENCH_ZLIB:
+      return strcmp( model->name, ZLIB_MODEL ) ? 0x00U : 0xFFU;
+  }
+
+  if( !crc_kernel_supported( id, &model->params ) )
+  {
+    return 0x00U;
+  }
+  if( !( run->ctx = crc_ctx_init( &model->params, id ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    exit( EXIT_FAILURE );
+  }
+  /* no fallback to another kernel */
+  if( crc_ctx_kernel( run->ctx ) != id )
+  {
+    crc_ctx_free( run->ctx );
+    run->ctx = NULL;
+    return 0x00U;
+  }
+  return 0xFFU;
+}
+
+
+static void measure( bench_run_t* run, const uint8_t* data, size_t len,
+                     bench_result_t* result )
+{
+  uint64_t rounds, r;
+  uint64_t cycles;
+  double seconds;
+
+  ( void )memset( ( void* )result, 0x00, sizeof( bench_result_t ) );
+
+  if( ( run->last_bytes_per_second > 0.0 ) &&
+      ( ( double )len / run->last_bytes_per_second > budget ) )
+  {
+    result->skipped = 0xFFU;
+    return;
+  }
+
+  /* the first pass warms up the caches and sizes the rounds,
+   * it is the measurement if it took long enough */
+  rounds  = 1UL;
+  seconds = get_monotonic_seconds();
+  cycles  = get_cycles();
+  result->crc = run_kernel( run, data, len );
+  cycles  = get_cycles() - cycles;
+  seconds = get_monotonic_seconds() - seconds;
+
+  if( seconds < MIN_SECONDS )
+  {
+    rounds = ( seconds > 0.0 ) ? ( uint64_t )( MIN_SECONDS / seconds ) + 1UL : MAX_ROUNDS;
+    if( rounds > MAX_ROUNDS )
+    {
+      rounds = MAX_ROUNDS;
+    }
+
+    seconds = get_monotonic_seconds();
+    cycles  = get_cycles();
+    for( r = 0UL; r < rounds; r++ )
+    {
+      sink ^= run_kernel( run, data, len );
+    }
+    cycles  = get_cycles() - cycles;
+    seconds = get_monotonic_seconds() - seconds;
+  }
+
+  if( !cycles )
+  {
+    cycles = 1UL;
+  }
+  if( seconds <= 0.0 )
+  {
+    seconds = 1e-9;
+  }
+
+  result->cycles_per_byte = ( double )cycles / ( ( double )rounds * ( double )len );
+  result->gb_per_second   = ( double )rounds * ( double )len / seconds * 1e-9;
+  run->last_bytes_per_second = result->gb_per_second * 1e9;
+}
+
+
+static void report( const crc_model_t* model, const char* kernel, size_t len,
+                    uint8_t offset, const bench_result_t* result, double zlib_gbps )
+{
+  if( result->skipped )
+  {
+    ( void )fprintf( stdout, "%-16s %-10s %10lu %6d %12s %10s\n", model->name, kernel,
+                             ( unsigned long )len, offset, "skipped", "-" );
+  }
+  else
+  {
+    ( void )fprintf( stdout, "%-16s %-10s %10lu %6d %12.3f %10.3f", model->name, kernel,
+                             ( unsigned long )len, offset,
+                             result->cycles_per_byte, result->gb_per_second );
+    if( zlib_gbps > 0.0 )
+    {
+      ( void )fprintf( stdout, " %8.2fx", result->gb_per_second / zlib_gbps );
+    }
+    ( void )fprintf( stdout, "\n" );
+  }
+
+  if( !json )
+  {
+    return;
+  }
+
+  ( void )fprintf( json, "%s    { \"model\": \"%s\", \"width\": %d, \"kernel\": \"%s\", "
+                         "\"bytes\": %lu, \"offset\": %d, ",
+                         json_results++ ? ",\n" : "",
+                         model->name, model->params.degree, kernel,
+                         ( unsigned long )len, offset );
+  if( result->skipped )
+  {
+    ( void )fprintf( json, "\"skipped\": true }" );
+    return;
+  }
+  ( void )fprintf( json, "\"cycles_per_byte\": %.4f, \"gb_per_s\": %.4f",
+                         result->cycles_per_byte, result->gb_per_second );
+  if( zlib_gbps > 0.0 )
+  {
+    ( void )fprintf( json, ", \"zlib_speedup\": %.3f", result->gb_per_second / zlib_gbps );
+  }
+  ( void )fprintf( json, " }" );
+}
+
+
+static void bench_model( const crc_model_t* model, uint8_t* buf )
+{
+  bench_run_t runs[ KERNEL_COUNT ];
+  uint8_t active[ KERNEL_COUNT ];
+  bench_run_t zlib_run;
+  bench_result_t result;
+  uint64_t reference;
+  double zlib_gbps;
+  uint8_t has_zlib = 0x00U;
+  uint8_t has_reference;
+  uint8_t offset;
+  size_t len;
+  uint32_t k;
+
+  for( k = 0U; k < KERNEL_COUNT; k++ )
+  {
+    active[ k ] = init_run( &runs[ k ], model, kernels[ k ].id );
+  }
+#ifdef CRC_BENCH_ZLIB
+  has_zlib = init_run( &zlib_run, model, BENCH_ZLIB );
+#else
+  ( void )zlib_run;
+#endif
+
+  for( len = MIN_SIZE; len <= max_size; len <<= 2U )
+  {
+    for( offset = 0U; offset <= MISALIGNMENT; offset += MISALIGNMENT )
+    {
+      zlib_gbps     = 0.0;
+      reference     = 0UL;
+      has_reference = 0x00U;
+
+      if( has_zlib )
+      {
+        measure( &zlib_run, buf + offset, len, &result );
+        report( model, "zlib", len, offset, &result, 0.0 );
+        zlib_gbps = result.skipped ? 0.0 : result.gb_per_second;
+      }
+
+      for( k = 0U; k < KERNEL_COUNT; k++ )
+      {
+        if( !active[ k ] )
+        {
+          continue;
+        }
+
+        /* the lut tables of crc16_algorithm_lut are global */
+        if( kernels[ k ].id == BENCH_CRC16_LUT )
+        {
+          init_lut_crc_16( &model->params );
+        }
+
+        measure( &runs[ k ], buf + offset, len, &result );
+        report( model, kernels[ k ].name, len, offset, &result, zlib_gbps );
+
+        if( result.skipped )
+        {
+          continue;
+        }
+        if( !has_reference )
+        {
+          reference = result.crc;
+          has_reference = 0xFFU;
+        }
+        else if( result.crc != reference )
+        {
+          ( void )fprintf( stderr, "%s: kernel %s returned 0x%lx instead of 0x%lx "
+                                   "for %lu bytes.\n", model->name, kernels[ k ].name,
+                                   ( unsigned long )result.crc, ( unsigned long )reference,
+                                   ( unsigned long )len );
+          exit( EXIT_FAILURE );
+        }
+      }
+    }
+  }
+
+  for( k = 0U; k < KERNEL_COUNT; k++ )
+  {
+    crc_ctx_free( runs[ k ].ctx );
+  }
+}
+
+/* the messages lie one after another in the buffer */
+static void fill_batch_set( const uint8_t* buf, size_t size )
+{
+  uint32_t i;
+
+  batch_set.bytes = 0UL;
+  for( i = 0U; i < BATCH_MESSAGES; i++ )
+  {
+    batch_set.len[ i ] = ( size != BATCH_MIXED ) ? size :
+                         BATCH_MIN_LEN + ( ( size_t )i * 2654435761UL ) %
+                                         ( BATCH_MAX_LEN - BATCH_MIN_LEN + 1UL );
+    batch_set.data[ i ] = buf + batch_set.bytes;
+    batch_set.bytes    += batch_set.len[ i ];
+  }
+}
+
+
+static void run_batch( uint8_t run, const crc_model_t* model, crc_ctx_t* ctx,
+                       const crc_batch_t* batch )
+{
+  uint64_t* crcs = batch_crcs[ run ];
+  uint16_t crc16;
+  uint32_t i;
+
+  switch( run )
+  {
+    case BATCH_RUN_LOOP:
+      for( i = 0U; i < BATCH_MESSAGES; i++ )
+      {
+        crc_ctx_reset( ctx );
+        crc_ctx_update( ctx, batch_set.data[ i ], batch_set.len[ i ] );
+        crcs[ i ] = crc_ctx_final( ctx );
+      }
+      break;
+    case BATCH_RUN_MODEL:
+      for( i = 0U; i < BATCH_MESSAGES; i++ )
+      {
+        crcs[ i ] = model->oneshot( batch_set.data[ i ], batch_set.len[ i ] );
+      }
+      break;
+    case BATCH_RUN_CRC16_LUT:
+      for( i = 0U; i < BATCH_MESSAGES; i++ )
+      {
+        crc16 = 0x0000U;
+        crc16_algorithm_lut( batch_set.data[ i ], ( uint32_t )batch_set.len[ i ],
+                             &model->params, &crc16, 0xFFU, 0x00U );
+        crcs[ i ] = ( uint64_t )crc16;
+      }
+      break;
+    default:
+      crc_batch( batch, batch_set.data, batch_set.len, BATCH_MESSAGES, crcs );
+      break;
+  }
+
+  sink ^= crcs[ BATCH_MESSAGES - 1U ];
+}
+
+
+static void measure_batch( uint8_t run, const crc_model_t* model, crc_ctx_t* ctx,
+                           const crc_batch_t* batch, bench_result_t* result,
+                           double* ns_per_message )
+{
+  uint64_t rounds, r;
+  uint64_t cycles;
+  double seconds;
+
+  ( void )memset( ( void* )result, 0x00, sizeof( bench_result_t ) );
+
+  /* warm up, the checksums of this pass are compared */
+  run_batch( run, model, ctx, batch );
+
+  rounds = 0UL;
+  seconds = get_monotonic_seconds();
+  cycles  = get_cycles();
+  do
+  {
+    for( r = 0UL; r < 16UL; r++ )
+    {
+      run_batch( run, model, ctx, batch );
+    }
+    rounds += r;
+  }
+  while( ( get_monotonic_seconds() - seconds < MIN_SECONDS ) && ( rounds < MAX_ROUNDS ) );
+  cycles  = get_cycles() - cycles;
+  seconds = get_monotonic_seconds() - seconds;
+
+  result->cycles_per_byte = ( double )cycles / ( ( double )rounds * ( double )batch_set.bytes );
+  result->gb_per_second   = ( double )rounds * ( double )batch_set.bytes / seconds * 1e-9;
+  *ns_per_message = seconds * 1e9 / ( ( double )rounds * ( double )BATCH_MESSAGES );
+}
+
+
+static void report_batch( const crc_model_t* model, uint8_t run, size_t size,
+                          const bench_result_t* result, double ns_per_message,
+                          double loop_ns )
+{
+  char bytes[ 16 ];
+
+  if( size == BATCH_MIXED )
+  {
+    ( void )sprintf( bytes, "%lu-%lu", BATCH_MIN_LEN, BATCH_MAX_LEN );
+  }
+  else
+  {
+    ( void )sprintf( bytes, "%lu", ( unsigned long )size );
+  }
+
+  ( void )fprintf( stdout, "%-16s %-10s %10s %12.3f %10.1f %10.2f %8.2fx\n",
+                           model->name, batch_run_names[ run ], bytes,
+                           result->cycles_per_byte, ns_per_message,
+                           1e3 / ns_per_message, loop_ns / ns_per_message );
+
+  if( !json )
+  {
+    return;
+  }
+
+  ( void )fprintf( json, "%s    { \"model\": \"%s\", \"width\": %d, \"kernel\": \"%s\", "
+                         "\"message_bytes\": \"%s\", \"messages\": %u, ",
+                         json_results++ ? ",\n" : "",
+                         model->name, model->params.degree, batch_run_names[ run ],
+                         bytes, BATCH_MESSAGES );
+  ( void )fprintf( json, "\"cycles_per_byte\": %.4f, \"gb_per_s\": %.4f, "
+                         "\"ns_per_message\": %.2f, \"loop_speedup\": %.3f }",
+                         result->cycles_per_byte, result->gb_per_second,
+                         ns_per_message, loop_ns / ns_per_message );
+}
+
+
+static void bench_batch( const crc_model_t* model, const uint8_t* buf )
+{
+  bench_result_t result;
+  crc_ctx_t* ctx;
+  crc_batch_t* batch;
+  double ns_per_message, loop_ns;
+  uint32_t s, i;
+  uint8_t run;
+
+  ctx   = crc_ctx_init( &model->params, CRC_KERNEL_AUTO );
+  batch = crc_batch_init( &model->params );
+  if( !ctx || !batch )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    exit( EXIT_FAILURE );
+  }
+
+  /* the lut tables of crc16_algorithm_lut are global */
+  if( model->params.degree == 16U )
+  {
+    init_lut_crc_16( &model->params );
+  }
+
+  for( s = 0U; s < BATCH_SIZE_COUNT; s++ )
+  {
+    fill_batch_set( buf, batch_sizes[ s ] );
+    loop_ns = 0.0;
+
+    for( run = 0U; run < BATCH_RUN_COUNT; run++ )
+    {
+      if( ( run == BATCH_RUN_CRC16_LUT ) && ( model->params.degree != 16U ) )
+      {
+        continue;
+      }
+
+      measure_batch( run, model, ctx, batch, &result, &ns_per_message );
+      if( run == BATCH_RUN_LOOP )
+      {
+        loop_ns = ns_per_message;
+      }
+      report_batch( model, run, batch_sizes[ s ], &result, ns_per_message, loop_ns );
+
+      for( i = 0U; i < BATCH_MESSAGES; i++ )
+      {
+        if( batch_crcs[ run ][ i ] != batch_crcs[ BATCH_RUN_LOOP ][ i ] )
+        {
+          ( void )fprintf( stderr, "%s: %s returned 0x%lx instead of 0x%lx "
+                                   "for message %u of %lu bytes.\n", model->name,
+                                   batch_run_names[ run ],
+                                   ( unsigned long )batch_crcs[ run ][ i ],
+                                   ( unsigned long )batch_crcs[ BATCH_RUN_LOOP ][ i ],
+                                   i, ( unsigned long )batch_set.len[ i ] );
+          exit( EXIT_FAILURE );
+        }
+      }
+    }
+  }
+
+  crc_batch_free( batch );
+  crc_ctx_free( ctx );
+}
+
+
+static void print_usage( FILE* out )
+{
+  ( void )fprintf( out, "\nUsage: \n"
+                        " crcbench [-o file.json] [-m model] [-w width]\n"
+                        "          [-s max_bytes] [-t seconds] [-b]\n\n"
+                        "   -o   Write the results as JSON, - is stdout.\n"
+                        "   -m   Only this model of the catalogue.\n"
+                        "   -w   Only the models of this width.\n" );
+  ( void )fprintf( out, "   -s   Largest buffer, default 1 GiB.\n"
+                        "   -t   Skip a kernel at a size where one pass\n"
+                        "        would take longer, default 1 s.\n"
+                        "   -b   Short messages, one call per message\n"
+                        "        against crc_batch.\n\n" );
+}
+
+
+static void parse_args( int argc, char** argv )
+{
+  int option = 0;
+  long parsed_number;
+
+  while( ( option = getopt( argc, argv, "o:m:w:s:t:b" ) ) != -1 )
+  {
+    switch( option )
+    {
+      case 'o':
+      {
+        if( !strcmp( optarg, "-" ) )
+        {
+          json = stdout;
+        }
+        else if( !( json = fopen( optarg, "w" ) ) )
+        {
+          ( void )fprintf( stderr, "Failed to open %s.\n", optarg );
+          exit( EXIT_FAILURE );
+        }
+        break;
+      }
+      case 'm':
+      {
+        if( !crc_model_find( optarg ) )
+        {
+          ( void )fprintf( stderr, "Unknown model: %s\n", optarg );
+          exit( EXIT_FAILURE );
+        }
+        model_filter = optarg;
+        break;
+      }
+      case 'w':
+      {
+        width_filter = try_strtol( optarg );
+        break;
+      }
+      case 's':
+      {
+        parsed_number = try_strtol( optarg );
+        if( ( parsed_number < ( long )MIN_SIZE ) || ( parsed_number > ( long )MAX_SIZE ) )
+        {
+          ( void )fprintf( stderr, "The largest buffer must be 1 up to %lu bytes.\n",
+                                   MAX_SIZE );
+          exit( EXIT_FAILURE );
+        }
+        max_size = ( size_t )parsed_number;
+        break;
+      }
+      case 't':
+      {
+        budget = atof( optarg );
+        if( budget <= 0.0 )
+        {
+          ( void )fprintf( stderr, "The budget must be positive.\n" );
+          exit( EXIT_FAILURE );
+        }
+        break;
+      }
+      case 'b':
+      {
+        batch_mode = 0xFFU;
+        break;
+      }
+      default:
+      {
+        print_usage( stderr );
+        exit( EXIT_FAILURE );
+      }
+    }
+  }
+}
+
+
+int main( int argc, char** argv )
+{
+  const crc_model_t* model;
+  uint8_t* mem;
+  uint8_t* buf;
+  uint32_t i;
+
+  parse_args( argc, argv );
+
+  /* every message of a set gets bytes of its own */
+  if( batch_mode )
+  {
+    max_size = BATCH_MESSAGES * BATCH_MAX_LEN;
+  }
+
+  /* aligned start plus room for the misaligned one */
+  if( !( mem = ( uint8_t* )malloc( max_size + BUF_ALIGNMENT + MISALIGNMENT ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    exit( EXIT_FAILURE );
+  }
+  buf = mem + ( ( BUF_ALIGNMENT - ( ( uintptr_t )mem & ( BUF_ALIGNMENT - 1UL ) ) ) &
+                ( BUF_ALIGNMENT - 1UL ) );
+  fill_random( buf, max_size + MISALIGNMENT );
+
+  ( void )fprintf( stdout, "cpu features: pclmul %s, sse4.2 %s\n",
+                           crc_clmul_supported() ? "yes" : "no",
+                           crc_sse42_supported() ? "yes" : "no" );
+  if( batch_mode )
+  {
+    ( void )fprintf( stdout, "%-16s %-10s %10s %12s %10s %10s %9s\n", "model", "kernel",
+                             "bytes",
+#if defined( __x86_64__ )
+                             "cycles/B",
+#else
+                             "ns/B",
+#endif
+                             "ns/msg", "Mmsg/s", "vs loop" );
+  }
+  else
+  {
+    ( void )fprintf( stdout, "%-16s %-10s %10s %6s %12s %10s%s\n", "model", "kernel",
+                             "bytes", "offset",
+#if defined( __x86_64__ )
+                             "cycles/B",
+#else
+                             "ns/B",
+#endif
+                             "GB/s",
+#ifdef CRC_BENCH_ZLIB
+                             "  vs zlib"
+#else
+                             ""
+#endif
+                             );
+  }
+
+  if( json )
+  {
+    ( void )fprintf( json, "{\n  \"cpu\": { \"pclmul\": %s, \"sse42\": %s },\n"
+                           "  \"cycle_source\": \"%s\",\n"
+                           "  \"zlib\": ",
+                           crc_clmul_supported() ? "true" : "false",
+                           crc_sse42_supported() ? "true" : "false",
+#if defined( __x86_64__ )
+                           "tsc"
+#else
+                           "ns"
+#endif
+                           );
+#ifdef CRC_BENCH_ZLIB
+    ( void )fprintf( json, "\"%s\",\n", zlibVersion() );
+#else
+    ( void )fprintf( json, "null,\n" );
+#endif
+    ( void )fprintf( json, "  \"results\": [\n" );
+  }
+
+  for( i = 0U; i < crc_model_count(); i++ )
+  {
+    model = crc_model_get( i );
+    if( ( model_filter && ( model != crc_model_find( model_filter ) ) ) ||
+        ( width_filter && ( model->params.degree != width_filter ) ) )
+    {
+      continue;
+    }
+    if( batch_mode )
+    {
+      bench_batch( model, buf );
+    }
+    else
+    {
+      bench_model( model, buf );
+    }
+    if( json )
+    {
+      ( void )fflush( json );
+    }
+  }
+
+  if( json )
+  {
+    ( void )fprintf( json, "\n  ]\n}\n" );
+    if( ( json != stdout ) && fclose( json ) )
+    {
+      ( void )fprintf( stderr, "Failed to write the results.\n" );
+      free( mem );
+      exit( EXIT_FAILURE );
+    }
+  }
+
+  free( mem );
+
+  return EXIT_SUCCESS;
+}
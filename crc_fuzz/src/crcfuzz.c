@@ -0,0 +1,1157 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcfuzz.c
+ *
+ *
+ * Purpose:   Differential fuzzer of the crc kernels. Every
+ *            case is crunched by the bitwise shift register
+ *            of the crc program (calculate_crc_bitwise in
+ *            crcbit.c) and by every other engine, which must
+ *            all agree with it:
+ *
+ *            - a crc_ctx for every kernel the cpu supports
+ *            - the fragment api of crcapi.h (first_call,
+ *              more_fragments) of every kernel, the CRC16
+ *              ones for models of degree 16
+ *            - the specialized kernel of the model (crcmodel.h)
+ *            - crc_combine of two parts of the case
+ *            - crc_batch with the fragments and the whole
+ *              case as independent messages
+ *            - crc_file_mmap and crc_files_uring (-d)
+ *            - the single file paths of the crc program
+ *              (-o 0 to 8) with the files of -d, an empty
+ *              file and an empty pipe
+ *
+ *            The data starts at a random offset from a 64 byte
+ *            boundary and is split into random fragments,
+ *            empty ones included.
+ *
+ *
+ * Remarks:   - Without file operands the cases are generated
+ *              from a seed (-s), so a run can be repeated. The
+ *              run ends after -n cases or -t seconds, whichever
+ *              comes first, to gate optimisation work (make
+ *              fuzz). The files of -d (test_files) are checked
+ *              first with every model.
+ *
+ *            - Every case is a byte string, the same format a
+ *              fuzzer feeds in:
+ *
+ *              byte 0      model, index of the catalogue or
+ *                          the model count for a custom one
+ *              byte 1      offset of the data (0 to 63)
+ *              byte 2-5    seed of the fragments
+ *              byte 6-31   custom model only: width - 1,
+ *                          poly, init, xorout (little endian,
+ *                          64 bit each) and refin | refout << 1
+ *              the rest    data
+ *
+ *            - A mismatch is reported with the case, which is
+ *              written to CRASH_FILE, and ends the program.
+ *              crcfuzz file... replays cases, e.g. afl-fuzz
+ *              ... -- crcfuzz @@.
+ *
+ *            - Built with libfuzzer=1 the program is a libFuzzer
+ *              target (LLVMFuzzerTestOneInput) without main. With
+ *              libfuzzer=1 or afl=1 a mismatch aborts, so the
+ *              fuzzer sees a crash.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crcapi.h>
+#include <crcbit.h>
+#include <crcbyte.h>
+#include <crcmodel.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+
+#define HEADER_LEN       6U
+#define CUSTOM_LEN       26U
+#define OFFSET_MASK      63U
+#define BUF_ALIGNMENT    64UL
+#define MAX_FRAGMENTS    64U
+#define MAX_CASE_LEN     ( 1UL << 18U )
+#define MAX_INPUT_LEN    ( HEADER_LEN + CUSTOM_LEN + MAX_CASE_LEN )
+#define MAX_TEST_FILES   256U
+
+#define DEF_BUDGET       10.0
+#define DEF_SEED         1UL
+#define CASES_PER_MODEL  32U
+#define FILE_SEEDS       8U
+
+/* messages of a crc_batch check: the fragments, then the
+ * whole case once per lane, so the lanes are always filled */
+#define BATCH_MESSAGES   ( MAX_FRAGMENTS + CRC_BATCH_LANES )
+
+#define CRC_32C_POLY     0x1EDC6F41U
+
+#define CRASH_FILE       "crcfuzz-crash.bin"
+
+/* -o 0 to 8 of the crc program */
+#define FILE_PATH_LEVELS 9U
+#define MAX_LINE_LEN     256U
+
+
+typedef void ( *fragment_func )( const uint8_t*, const uint32_t, const crc_param_t*,
+                                 uint64_t*, uint8_t, uint8_t );
+
+typedef void ( *fragment_16_func )( const uint8_t*, const uint32_t, const crc_param_t*,
+                                    uint16_t*, uint8_t, uint8_t );
+
+typedef struct fragment_engine
+{
+  const char*   name;
+  fragment_func func;
+
+} fragment_engine_t;
+
+typedef struct fragment_16_engine
+{
+  const char*      name;
+  fragment_16_func func;
+
+} fragment_16_engine_t;
+
+
+/* one case, decoded */
+typedef struct fuzz_case
+{
+  crc_param_t        params;
+  const crc_model_t* model;
+  const uint8_t*     data;
+  size_t             len;
+  uint8_t            offset;
+  uint32_t           seed;
+
+  uint32_t           fragments[ MAX_FRAGMENTS ];
+  uint32_t           fragment_count;
+
+} fuzz_case_t;
+
+
+static const fragment_engine_t fragment_engines[] =
+{
+  { "crc_algorithm",            &crc_algorithm            },
+  { "crc_algorithm_lut",        &crc_algorithm_lut        },
+  { "crc_algorithm_slicing_4",  &crc_algorithm_slicing_4  },
+  { "crc_algorithm_slicing_8",  &crc_algorithm_slicing_8  },
+  { "crc_algorithm_slicing_16", &crc_algorithm_slicing_16 },
+  { "crc_algorithm_clmul",      &crc_algorithm_clmul      },
+  { "crc_algorithm_dispatch",   &crc_algorithm_dispatch   }
+};
+
+static const fragment_16_engine_t fragment_16_engines[] =
+{
+  { "crc16_algorithm",            &crc16_algorithm            },
+  { "crc16_algorithm_lut",        &crc16_algorithm_lut        },
+  { "crc16_algorithm_slicing_4",  &crc16_algorithm_slicing_4  },
+  { "crc16_algorithm_slicing_8",  &crc16_algorithm_slicing_8  },
+  { "crc16_algorithm_slicing_16", &crc16_algorithm_slicing_16 }
+};
+
+#define FRAGMENT_ENGINES    ( sizeof( fragment_engines ) / sizeof( fragment_engines[ 0 ] ) )
+#define FRAGMENT_16_ENGINES ( sizeof( fragment_16_engines ) / sizeof( fragment_16_engines[ 0 ] ) )
+
+
+/* engines of the parameter set of the last case */
+static crc_param_t   engine_params;
+static uint8_t       engines_ready = 0x00U;
+static crc_ctx_t*    ctxs[ CRC_KERNEL_COUNT ];
+static crc_combine_t combine;
+static crc_batch_t*  batch = NULL;
+static uint8_t       is_crc_32c = 0x00U;
+
+static uint8_t*      arena_mem = NULL;
+static uint8_t*      arena     = NULL;
+
+/* the case which is checked, written out on a mismatch */
+static const uint8_t* input     = NULL;
+static size_t         input_len = 0U;
+
+static uint64_t      cases  = 0UL;
+static uint64_t      checks = 0UL;
+static uint64_t      bytes  = 0UL;
+
+static double        budget       = DEF_BUDGET;
+static uint64_t      max_cases    = 0UL;
+static uint64_t      seed         = DEF_SEED;
+static const char*   model_filter = NULL;
+static const char*   test_dir     = NULL;
+
+
+static uint32_t next_random( uint32_t* state );
+static uint64_t next_random_64( uint64_t* state );
+static uint64_t load_64( const uint8_t* p );
+static void store_64( uint8_t* p, uint64_t v );
+static void print_params( FILE* out, const fuzz_case_t* c );
+static void mismatch( const fuzz_case_t* c, const char* engine,
+                      uint64_t expected, uint64_t got );
+static void prepare_engines( const crc_param_t* crc_params );
+static void split_fragments( fuzz_case_t* c );
+static void check_batch( const fuzz_case_t* c, const uint8_t* buf, uint64_t expected );
+static void check_case( fuzz_case_t* c );
+static void fuzz_one( const uint8_t* data, size_t size );
+#ifndef CRC_FUZZ_LIBFUZZER
+static size_t read_file( const char* file, uint8_t* buf, size_t len );
+static int compare_names( const void* a, const void* b );
+static uint8_t run_file_path( uint8_t level, const char* file, uint8_t degree,
+                              uint64_t* p_crc );
+static void check_file_paths( const fuzz_case_t* c, const char* file,
+                              const char* label, uint64_t expected );
+static void check_test_files( const char* dir, uint8_t* gen );
+static size_t generate_case( uint8_t* gen, uint64_t* state, uint64_t n );
+static void print_usage( FILE* out );
+static void parse_args( int argc, char** argv );
+#endif
+
+
+/* xorshift32, the fragments of a case only depend on its seed */
+static uint32_t next_random( uint32_t* state )
+{
+  uint32_t x = *state ? *state : 0x9E3779B9U;
+
+  x ^= x << 13U;
+  x ^= x >> 17U;
+  x ^= x << 5U;
+  *state = x;
+
+  return x;
+}
+
+
+/* xorshift64 of the generated cases */
+static uint64_t next_random_64( uint64_t* state )
+{
+  uint64_t x = *state;
+
+  x ^= x << 13U;
+  x ^= x >> 7U;
+  x ^= x << 17U;
+  *state = x;
+
+  return x;
+}
+
+
+static uint64_t load_64( const uint8_t* p )
+{
+  uint64_t v = 0UL;
+  uint8_t i;
+
+  for( i = 0U; i < 8U; i++ )
+  {
+    v |= ( uint64_t )*( p + i ) << ( 8U * i );
+  }
+  return v;
+}
+
+
+static void store_64( uint8_t* p, uint64_t v )
+{
+  uint8_t i;
+
+  for( i = 0U; i < 8U; i++ )
+  {
+    *( p + i ) = ( uint8_t )( v >> ( 8U * i ) );
+  }
+}
+
+
+static void print_params( FILE* out, const fuzz_case_t* c )
+{
+  ( void )fprintf( out, "model:     %s (width %d, poly 0x%lx, init 0x%lx, xorout 0x%lx, "
+                        "refin %d, refout %d)\n",
+                        c->model ? c->model->name : "custom", c->params.degree,
+                        get_param_value( &c->params.coeff, c->params.degree ),
+                        get_param_value( &c->params.initial_xor, c->params.degree ),
+                        get_param_value( &c->params.final_xor, c->params.degree ),
+                        c->params.reflect_input, c->params.reflect_remainder );
+}
+
+
+static void mismatch( const fuzz_case_t* c, const char* engine,
+                      uint64_t expected, uint64_t got )
+{
+  FILE* crash;
+  uint8_t written;
+  uint32_t i;
+
+  ( void )fprintf( stderr, "\nMismatch of %s\n", engine );
+  print_params( stderr, c );
+  ( void )fprintf( stderr, "bytes:     %lu at offset %d\nfragments:",
+                           ( unsigned long )c->len, c->offset );
+  for( i = 0U; i < c->fragment_count; i++ )
+  {
+    ( void )fprintf( stderr, " %u", c->fragments[ i ] );
+  }
+  ( void )fprintf( stderr, "\nexpected:  0x%lx (bitwise)\ngot:       0x%lx\n",
+                           expected, got );
+
+#ifndef CRC_FUZZ_LIBFUZZER
+  /* the fuzzers keep the case themselves */
+  if( input && ( crash = fopen( CRASH_FILE, "wb" ) ) )
+  {
+    written = ( fwrite( ( const void* )input, 1U, input_len, crash ) == input_len ) ?
+              0xFFU : 0x00U;
+    if( !fclose( crash ) && written )
+    {
+      ( void )fprintf( stderr, "The case was written to %s, "
+                               "crcfuzz %s replays it.\n", CRASH_FILE, CRASH_FILE );
+    }
+  }
+#else
+  ( void )crash;
+  ( void )written;
+#endif
+
+#if defined( CRC_FUZZ_LIBFUZZER ) || defined( CRC_FUZZ_AFL )
+  abort();
+#else
+  exit( EXIT_FAILURE );
+#endif
+}
+
+
+/* The contexts and the tables of the fragment api are only
+ * built again when the parameter set changes. */
+static void prepare_engines( const crc_param_t* crc_params )
+{
+  uint8_t k;
+
+  if( engines_ready && !memcmp( ( const void* )&engine_params,
+                                ( const void* )crc_params, sizeof( crc_param_t ) ) )
+  {
+    return;
+  }
+
+  for( k = 0U; k < CRC_KERNEL_COUNT; k++ )
+  {
+    crc_ctx_free( ctxs[ k ] );
+    ctxs[ k ] = NULL;
+
+    if( ( k != CRC_KERNEL_AUTO ) && !crc_kernel_supported( k, crc_params ) )
+    {
+      continue;
+    }
+    if( !( ctxs[ k ] = crc_ctx_init( crc_params, k ) ) )
+    {
+      ( void )fprintf( stderr, "Failed to initialize the %s kernel.\n",
+                               crc_kernel_name( k ) );
+      exit( EXIT_FAILURE );
+    }
+  }
+
+  init_lut_crc( crc_params );
+  init_lut_crc_slicing( crc_params );
+  init_clmul_crc( crc_params );
+  ( void )init_crc_dispatch( crc_params );
+  init_crc_combine( &combine, crc_params );
+
+  crc_batch_free( batch );
+  if( !( batch = crc_batch_init( crc_params ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to initialize the crc batch.\n" );
+    exit( EXIT_FAILURE );
+  }
+
+  is_crc_32c = ( ( crc_params->degree == 32U ) && crc_params->reflect_input &&
+                 ( get_param_value( &crc_params->coeff, 32U ) == CRC_32C_POLY ) ) ?
+               0xFFU : 0x00U;
+  if( is_crc_32c )
+  {
+    init_crc32c_sse42();
+  }
+  if( crc_params->degree == 16U )
+  {
+    init_lut_crc_16( crc_params );
+    init_lut_crc_16_slicing( crc_params );
+  }
+
+  engine_params = *crc_params;
+  engines_ready = 0xFFU;
+}
+
+
+/* A quarter of the cases is one piece, the others get empty
+ * pieces, short ones for the tails and multiples of 64 bytes
+ * for the block loops. The last piece takes the rest. */
+static void split_fragments( fuzz_case_t* c )
+{
+  uint32_t state = c->seed;
+  uint32_t r;
+  size_t left = c->len;
+  size_t piece;
+
+  c->fragment_count = 0U;
+
+  if( next_random( &state ) % 4U )
+  {
+    while( left && ( c->fragment_count < MAX_FRAGMENTS - 1U ) )
+    {
+      r = next_random( &state );
+      switch( r % 8U )
+      {
+        case 0:
+          piece = 0U;
+          break;
+        case 1:
+        case 2:
+        case 3:
+          piece = ( size_t )( ( r >> 8U ) % 17U );
+          break;
+        case 4:
+          piece = ( size_t )( ( ( r >> 8U ) % 4U ) + 1U ) * BUF_ALIGNMENT;
+          break;
+        default:
+          piece = ( size_t )( r >> 8U ) % ( left + 1U );
+          break;
+      }
+      if( piece > left )
+      {
+        piece = left;
+      }
+      c->fragments[ c->fragment_count++ ] = ( uint32_t )piece;
+      left -= piece;
+    }
+  }
+  c->fragments[ c->fragment_count++ ] = ( uint32_t )left;
+}
+
+
+/* The lanes of crc_batch start and finish their messages at
+ * different times, the fragments give them uneven lengths. */
+static void check_batch( const fuzz_case_t* c, const uint8_t* buf, uint64_t expected )
+{
+  const uint8_t* data[ BATCH_MESSAGES ];
+  size_t len[ BATCH_MESSAGES ];
+  uint64_t want[ BATCH_MESSAGES ];
+  uint64_t got[ BATCH_MESSAGES ];
+  size_t pos, count = 0U;
+  uint32_t i;
+
+  for( i = 0U, pos = 0U; ( c->fragment_count > 1U ) && ( i < c->fragment_count );
+       pos += c->fragments[ i++ ] )
+  {
+    data[ count ] = buf + pos;
+    len[ count ]  = ( size_t )c->fragments[ i ];
+    want[ count ] = calculate_crc_bitwise( ( const crc_param_t* )&c->params,
+                                           data[ count ], len[ count ] );
+    count++;
+  }
+  for( i = 0U; i < CRC_BATCH_LANES; i++ )
+  {
+    data[ count ] = buf;
+    len[ count ]  = c->len;
+    want[ count ] = expected;
+    count++;
+  }
+
+  crc_batch( batch, data, len, count, got );
+
+  for( i = 0U; i < count; i++ )
+  {
+    if( got[ i ] != want[ i ] )
+    {
+      ( void )fprintf( stderr, "\ncrc_batch message %u of %lu, %lu bytes at %lu",
+                               i, ( unsigned long )count, ( unsigned long )len[ i ],
+                               ( unsigned long )( data[ i ] - buf ) );
+      mismatch( c, "crc_batch", want[ i ], got[ i ] );
+    }
+  }
+  checks++;
+}
+
+
+static void check_case( fuzz_case_t* c )
+{
+  const uint8_t* buf;
+  uint64_t expected, got, crc_a, crc_b, reg;
+  uint16_t crc16;
+  size_t pos, len_a;
+  uint32_t i, e;
+  uint8_t k;
+
+  expected = calculate_crc_bitwise( ( const crc_param_t* )&c->params, c->data, c->len );
+
+  prepare_engines( ( const crc_param_t* )&c->params );
+  split_fragments( c );
+
+  ( void )memcpy( ( void* )( arena + c->offset ), ( const void* )c->data, c->len );
+  buf = arena + c->offset;
+
+  for( k = 0U; k < CRC_KERNEL_COUNT; k++ )
+  {
+    if( !ctxs[ k ] )
+    {
+      continue;
+    }
+    crc_ctx_reset( ctxs[ k ] );
+    for( i = 0U, pos = 0U; i < c->fragment_count; pos += c->fragments[ i++ ] )
+    {
+      crc_ctx_update( ctxs[ k ], buf + pos, ( size_t )c->fragments[ i ] );
+    }
+    if( ( got = crc_ctx_final( ctxs[ k ] ) ) != expected )
+    {
+      mismatch( c, ( k == CRC_KERNEL_AUTO ) ? "crc_ctx (auto)" : crc_kernel_name( k ),
+                expected, got );
+    }
+    checks++;
+  }
+
+  for( e = 0U; e <= FRAGMENT_ENGINES; e++ )
+  {
+    if( ( e == FRAGMENT_ENGINES ) && !is_crc_32c )
+    {
+      break;
+    }
+    got = 0UL;
+    for( i = 0U, pos = 0U; i < c->fragment_count; pos += c->fragments[ i++ ] )
+    {
+      if( e == FRAGMENT_ENGINES )
+      {
+        crc_algorithm_sse42( buf + pos, c->fragments[ i ], ( const crc_param_t* )&c->params,
+                             &got, !i, ( i < c->fragment_count - 1U ) ? 0xFFU : 0x00U );
+      }
+      else
+      {
+        fragment_engines[ e ].func( buf + pos, c->fragments[ i ],
+                                    ( const crc_param_t* )&c->params, &got,
+                                    !i, ( i < c->fragment_count - 1U ) ? 0xFFU : 0x00U );
+      }
+    }
+    if( got != expected )
+    {
+      mismatch( c, ( e == FRAGMENT_ENGINES ) ? "crc_algorithm_sse42" :
+                                               fragment_engines[ e ].name, expected, got );
+    }
+    checks++;
+  }
+
+  for( e = 0U; ( c->params.degree == 16U ) && ( e < FRAGMENT_16_ENGINES ); e++ )
+  {
+    crc16 = 0U;
+    for( i = 0U, pos = 0U; i < c->fragment_count; pos += c->fragments[ i++ ] )
+    {
+      fragment_16_engines[ e ].func( buf + pos, c->fragments[ i ],
+                                     ( const crc_param_t* )&c->params, &crc16,
+                                     !i, ( i < c->fragment_count - 1U ) ? 0xFFU : 0x00U );
+    }
+    if( ( uint64_t )crc16 != expected )
+    {
+      mismatch( c, fragment_16_engines[ e ].name, expected, ( uint64_t )crc16 );
+    }
+    checks++;
+  }
+
+  if( c->model )
+  {
+    reg = c->model->init();
+    for( i = 0U, pos = 0U; i < c->fragment_count; pos += c->fragments[ i++ ] )
+    {
+      reg = c->model->update( reg, buf + pos, ( size_t )c->fragments[ i ] );
+    }
+    if( ( got = c->model->final( reg ) ) != expected )
+    {
+      mismatch( c, "model update", expected, got );
+    }
+    if( ( got = c->model->oneshot( buf, c->len ) ) != expected )
+    {
+      mismatch( c, "model oneshot", expected, got );
+    }
+    checks += 2UL;
+  }
+
+  /* the first fragment and the rest */
+  len_a = ( size_t )c->fragments[ 0 ];
+  crc_ctx_reset( ctxs[ CRC_KERNEL_AUTO ] );
+  crc_ctx_update( ctxs[ CRC_KERNEL_AUTO ], buf, len_a );
+  crc_a = crc_ctx_final( ctxs[ CRC_KERNEL_AUTO ] );
+  crc_ctx_reset( ctxs[ CRC_KERNEL_AUTO ] );
+  crc_ctx_update( ctxs[ CRC_KERNEL_AUTO ], buf + len_a, c->len - len_a );
+  crc_b = crc_ctx_final( ctxs[ CRC_KERNEL_AUTO ] );
+  if( ( got = crc_combine( &combine, crc_a, crc_b, ( uint64_t )( c->len - len_a ) ) ) !=
+      expected )
+  {
+    mismatch( c, "crc_combine", expected, got );
+  }
+  checks++;
+
+  check_batch( c, buf, expected );
+
+  cases++;
+  bytes += ( uint64_t )c->len;
+}
+
+
+/* Decodes a case (see the remarks on top) and checks it.
+ * Too short inputs are no case, longer data is cut off. */
+static void fuzz_one( const uint8_t* data, size_t size )
+{
+  fuzz_case_t c;
+  uint32_t models;
+  uint32_t model;
+  uint64_t mask;
+  uint8_t width;
+
+  if( !arena )
+  {
+    if( !( arena_mem = ( uint8_t* )malloc( MAX_CASE_LEN + 2UL * BUF_ALIGNMENT ) ) )
+    {
+      ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+      exit( EXIT_FAILURE );
+    }
+    arena = arena_mem + ( ( BUF_ALIGNMENT - ( ( uintptr_t )arena_mem & ( BUF_ALIGNMENT - 1UL ) ) ) &
+                          ( BUF_ALIGNMENT - 1UL ) );
+  }
+
+  if( size < HEADER_LEN )
+  {
+    return;
+  }
+
+  input     = data;
+  input_len = size;
+
+  ( void )memset( ( void* )&c, 0x00, sizeof( c ) );
+
+  models   = crc_model_count();
+  model    = ( uint32_t )*data % ( models + 1U );
+  c.offset = ( uint8_t )( *( data + 1 ) & OFFSET_MASK );
+  c.seed   = ( uint32_t )*( data + 2 ) | ( ( uint32_t )*( data + 3 ) << 8U ) |
+             ( ( uint32_t )*( data + 4 ) << 16U ) | ( ( uint32_t )*( data + 5 ) << 24U );
+  data += HEADER_LEN;
+  size -= HEADER_LEN;
+
+  if( model < models )
+  {
+    c.model  = crc_model_get( model );
+    c.params = c.model->params;
+  }
+  else
+  {
+    if( size < CUSTOM_LEN )
+    {
+      return;
+    }
+    width = ( uint8_t )( ( *data % 64U ) + 1U );
+    mask  = ( width < 64U ) ? ( ( 1UL << width ) - 1UL ) : ~0UL;
+    /* the generator of a crc has the x^0 term */
+    ( void )crc_param_set( &c.params, width, ( load_64( data + 1 ) & mask ) | 1UL,
+                           load_64( data + 9 ) & mask, load_64( data + 17 ) & mask,
+                           ( uint8_t )( *( data + 25 ) & 1U ),
+                           ( uint8_t )( ( *( data + 25 ) >> 1U ) & 1U ) );
+    data += CUSTOM_LEN;
+    size -= CUSTOM_LEN;
+  }
+
+  c.data = data;
+  c.len  = ( size > MAX_CASE_LEN ) ? MAX_CASE_LEN : size;
+
+  check_case( &c );
+}
+
+
+#ifdef CRC_FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput( const uint8_t* data, size_t size );
+
+int LLVMFuzzerTestOneInput( const uint8_t* data, size_t size )
+{
+  fuzz_one( data, size );
+  return 0;
+}
+
+#else
+
+
+static size_t read_file( const char* file, uint8_t* buf, size_t len )
+{
+  FILE* in;
+  size_t got;
+
+  if( !strcmp( file, "-" ) )
+  {
+    return fread( ( void* )buf, 1U, len, stdin );
+  }
+  if( !( in = fopen( file, "rb" ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to open %s.\n", file );
+    exit( EXIT_FAILURE );
+  }
+  got = fread( ( void* )buf, 1U, len, in );
+  ( void )fclose( in );
+
+  return got;
+}
+
+
+static int compare_names( const void* a, const void* b )
+{
+  return strcmp( *( const char* const* )a, *( const char* const* )b );
+}
+
+
+/* Runs the single file path of -o level (calculate_crc in crcbyte.c,
+ * crcbit.c for 0) with stdout redirected into a temporary file
+ * and reads the checksum back from the line which prints it. */
+static uint8_t run_file_path( uint8_t level, const char* file, uint8_t degree,
+                              uint64_t* p_crc )
+{
+  char line[ MAX_LINE_LEN ];
+  const char* hex;
+  FILE* out;
+  int saved;
+  uint8_t found = 0x00U;
+
+  ( void )fflush( stdout );
+  if( !( out = tmpfile() ) || ( ( saved = dup( STDOUT_FILENO ) ) == ( -1 ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to redirect stdout.\n" );
+    exit( EXIT_FAILURE );
+  }
+  ( void )dup2( fileno( out ), STDOUT_FILENO );
+
+  switch( level )
+  {
+    case 0:
+      calculate_crc_from_file_bitwise( file, degree );
+      break;
+    case 1:
+      calculate_crc_from_file_bytewise( file, degree );
+      break;
+    case 2:
+      calculate_crc_from_file_bytewise_lut( file, degree );
+      break;
+    case 3:
+    case 4:
+    case 5:
+      calculate_crc_from_file_bytewise_slicing( file, degree,
+                                                ( uint8_t )( 1U << ( level - 1U ) ) );
+      break;
+    case 6:
+      calculate_crc_from_file_bytewise_clmul( file, degree );
+      break;
+    case 7:
+      calculate_crc_from_file_bytewise_sse42( file, degree );
+      break;
+    default:
+      calculate_crc_from_file_bytewise_dispatch( file, degree );
+      break;
+  }
+
+  ( void )fflush( stdout );
+  ( void )dup2( saved, STDOUT_FILENO );
+  ( void )close( saved );
+
+  rewind( out );
+  while( fgets( line, ( int )sizeof( line ), out ) )
+  {
+    if( !strncmp( line, "CRC", 3U ) && ( hex = strstr( line, ": 0x" ) ) )
+    {
+      *p_crc = strtoul( hex + 4, NULL, 16 );
+      found = 0xFFU;
+    }
+  }
+  ( void )fclose( out );
+
+  return found;
+}
+
+
+/* The file in one piece through every level of the crc program,
+ * the crc32 instruction only for CRC-32C. label names the file
+ * in the report of a mismatch. */
+static void check_file_paths( const fuzz_case_t* c, const char* file,
+                              const char* label, uint64_t expected )
+{
+  char engine[ MAX_LINE_LEN ];
+  uint64_t got = 0UL;
+  uint8_t level;
+
+  set_bitwise_params( ( const crc_param_t* )&c->params );
+  set_bytewise_params( ( const crc_param_t* )&c->params );
+
+  for( level = 0U; level < FILE_PATH_LEVELS; level++ )
+  {
+    if( ( level == 7U ) && !is_crc_32c )
+    {
+      continue;
+    }
+    if( !run_file_path( level, file, c->params.degree, &got ) || ( got != expected ) )
+    {
+      ( void )snprintf( engine, sizeof( engine ), "crc -o %u", level );
+      ( void )fprintf( stderr, "\n%s:", label );
+      mismatch( c, engine, expected, got );
+    }
+    checks++;
+  }
+}
+
+
+/* Every file with every model and FILE_SEEDS offsets and
+ * fragmentations, then the file api of the library and the
+ * single file paths of the crc program. The latter also get
+ * an empty file and an empty pipe. */
+static void check_test_files( const char* dir, uint8_t* gen )
+{
+  static char paths[ MAX_TEST_FILES ][ PATH_MAX + 1 ];
+  char empty_paths[ 2 ][ PATH_MAX + 1 ];
+  const char* names[ MAX_TEST_FILES ];
+  uint64_t crcs[ MAX_TEST_FILES ];
+  uint8_t ok[ MAX_TEST_FILES ];
+  fuzz_case_t c;
+  struct dirent* entry;
+  struct stat file_stat;
+  DIR* d;
+  FILE* empty;
+  int fds[ 2 ];
+  const crc_model_t* model;
+  uint64_t expected, got;
+  size_t len;
+  uint32_t n = 0U;
+  uint32_t i, m, s;
+
+  if( !( d = opendir( dir ) ) )
+  {
+    ( void )fprintf( stdout, "No test files in %s.\n", dir );
+  }
+  while( d && ( entry = readdir( d ) ) && ( n < MAX_TEST_FILES ) )
+  {
+    ( void )snprintf( paths[ n ], sizeof( paths[ n ] ), "%s/%s", dir, entry->d_name );
+    if( !stat( paths[ n ], &file_stat ) && S_ISREG( file_stat.st_mode ) )
+    {
+      names[ n ] = paths[ n ];
+      n++;
+    }
+  }
+  if( d )
+  {
+    ( void )closedir( d );
+  }
+  qsort( ( void* )names, n, sizeof( const char* ), &compare_names );
+
+  /* the write end is closed, every open of the pipe reads its end */
+  if( !( empty = tmpfile() ) || pipe( fds ) )
+  {
+    ( void )fprintf( stderr, "Failed to create the empty inputs.\n" );
+    exit( EXIT_FAILURE );
+  }
+  ( void )close( fds[ 1 ] );
+  ( void )snprintf( empty_paths[ 0 ], sizeof( empty_paths[ 0 ] ), "/dev/fd/%d", fileno( empty ) );
+  ( void )snprintf( empty_paths[ 1 ], sizeof( empty_paths[ 1 ] ), "/dev/fd/%d", fds[ 0 ] );
+
+  for( m = 0U; m < crc_model_count(); m++ )
+  {
+    model = crc_model_get( m );
+    if( model_filter && ( model != crc_model_find( model_filter ) ) )
+    {
+      continue;
+    }
+    for( i = 0U; i < n; i++ )
+    {
+      len = read_file( names[ i ], gen + HEADER_LEN, MAX_CASE_LEN );
+      for( s = 0U; s < FILE_SEEDS; s++ )
+      {
+        *gen         = ( uint8_t )m;
+        *( gen + 1 ) = ( uint8_t )( s * 9U );
+        *( gen + 2 ) = ( uint8_t )( s + 1U );
+        ( void )memset( ( void* )( gen + 3 ), 0x00, 3U );
+        fuzz_one( gen, HEADER_LEN + len );
+      }
+    }
+
+    ( void )memset( ( void* )&c, 0x00, sizeof( c ) );
+    c.model  = model;
+    c.params = model->params;
+    input    = NULL;
+    prepare_engines( ( const crc_param_t* )&c.params );
+
+    /* the files are not cut off here */
+    ( void )crc_files_uring( ( const char* const* )names, n, ( const crc_param_t* )&c.params, crcs, ok, 8U );
+    for( i = 0U; i < n; i++ )
+    {
+      len = read_file( names[ i ], gen, MAX_INPUT_LEN );
+      c.data = gen;
+      c.len  = len;
+      expected = calculate_crc_bitwise( ( const crc_param_t* )&c.params, gen, len );
+
+      if( !ok[ i ] || ( crcs[ i ] != expected ) )
+      {
+        ( void )fprintf( stderr, "\n%s:", names[ i ] );
+        mismatch( &c, "crc_files_uring", expected, crcs[ i ] );
+      }
+      if( !crc_file_mmap( names[ i ], ( const crc_param_t* )&c.params, &got ) ||
+          ( got != expected ) )
+      {
+        ( void )fprintf( stderr, "\n%s:", names[ i ] );
+        mismatch( &c, "crc_file_mmap", expected, got );
+      }
+      checks += 2UL;
+
+      check_file_paths( &c, names[ i ], names[ i ], expected );
+    }
+
+    c.data   = gen;
+    c.len    = 0U;
+    expected = calculate_crc_bitwise( ( const crc_param_t* )&c.params, gen, 0U );
+    check_file_paths( &c, empty_paths[ 0 ], "empty file", expected );
+    check_file_paths( &c, empty_paths[ 1 ], "empty pipe", expected );
+  }
+
+  set_bitwise_params( NULL );
+  set_bytewise_params( NULL );
+  ( void )fclose( empty );
+  ( void )close( fds[ 0 ] );
+
+  ( void )fprintf( stdout, "%u test files of %s, an empty file and "
+                           "an empty pipe checked.\n", n, dir );
+}
+
+
+/* Case n of the run in the format of fuzz_one, the models take
+ * turns in blocks of CASES_PER_MODEL, the custom one included. */
+static size_t generate_case( uint8_t* gen, uint64_t* state, uint64_t n )
+{
+  const crc_model_t* model;
+  uint8_t* data = gen + HEADER_LEN;
+  size_t len, i;
+  uint32_t r;
+
+  *gen = ( uint8_t )( ( n / CASES_PER_MODEL ) % ( crc_model_count() + 1U ) );
+
+  if( model_filter )
+  {
+    model = crc_model_find( model_filter );
+    for( i = 0U; i < crc_model_count(); i++ )
+    {
+      if( crc_model_get( ( uint32_t )i ) == model )
+      {
+        *gen = ( uint8_t )i;
+      }
+    }
+  }
+
+  r = ( uint32_t )next_random_64( state );
+  *( gen + 1 ) = ( uint8_t )r;
+  *( gen + 2 ) = ( uint8_t )( r >> 8U );
+  *( gen + 3 ) = ( uint8_t )( r >> 16U );
+  *( gen + 4 ) = ( uint8_t )( r >> 24U );
+  *( gen + 5 ) = ( uint8_t )next_random_64( state );
+
+  if( *gen == crc_model_count() )
+  {
+    *data = ( uint8_t )next_random_64( state );
+    store_64( data + 1, next_random_64( state ) );
+    store_64( data + 9, next_random_64( state ) );
+    store_64( data + 17, next_random_64( state ) );
+    *( data + 25 ) = ( uint8_t )next_random_64( state );
+    data += CUSTOM_LEN;
+  }
+
+  /* mostly short, now and then long enough for the
+   * 8 KiB blocks of the crc32 instruction */
+  r = ( uint32_t )next_random_64( state );
+  switch( r % 16U )
+  {
+    case 0:
+      len = 0U;
+      break;
+    case 10:
+    case 11:
+    case 12:
+    case 13:
+      len = ( size_t )( ( r >> 4U ) % 8193U );
+      break;
+    case 14:
+      len = ( size_t )( ( r >> 4U ) % 65537U );
+      break;
+    case 15:
+      len = ( size_t )( ( r >> 4U ) % ( MAX_CASE_LEN + 1UL ) );
+      break;
+    default:
+      len = ( size_t )( ( r >> 4U ) % 257U );
+      break;
+  }
+
+  switch( next_random_64( state ) % 8UL )
+  {
+    case 0:
+      ( void )memset( ( void* )data, 0x00, len );
+      break;
+    case 1:
+      ( void )memset( ( void* )data, 0xFF, len );
+      break;
+    case 2:
+      for( i = 0U; i < len; i++ )
+      {
+        *( data + i ) = ( uint8_t )i;
+      }
+      break;
+    default:
+      for( i = 0U; i < len; i++ )
+      {
+        *( data + i ) = ( uint8_t )( next_random_64( state ) >> 32U );
+      }
+      break;
+  }
+
+  return ( size_t )( data - gen ) + len;
+}
+
+
+static void print_usage( FILE* out )
+{
+  ( void )fprintf( out, "\nUsage: \n"
+                        " crcfuzz [-s seed] [-n cases] [-t seconds] [-m model]\n"
+                        "         [-d test_files]\n"
+                        " crcfuzz case...\n\n" );
+  ( void )fprintf( out, "   -s   Seed of the cases (default 1).\n"
+                        "   -n   Number of cases, 0 (default) until\n"
+                        "        the budget is used up.\n"
+                        "   -t   Budget in seconds (default 10).\n"
+                        "   -m   Only this model of the catalogue.\n"
+                        "   -d   Directory of files which are checked\n"
+                        "        with every model first.\n\n" );
+  ( void )fprintf( out, " Cases (e.g. " CRASH_FILE ") are replayed, - reads stdin.\n\n" );
+}
+
+
+static void parse_args( int argc, char** argv )
+{
+  int option = 0;
+  long parsed_number;
+
+  while( ( option = getopt( argc, argv, "s:n:t:m:d:" ) ) != -1 )
+  {
+    switch( option )
+    {
+      case 's':
+      {
+        seed = strtoul( optarg, NULL, 0 );
+        break;
+      }
+      case 'n':
+      {
+        if( ( parsed_number = try_strtol( optarg ) ) < 0L )
+        {
+          ( void )fprintf( stderr, "The number of cases must not be negative.\n" );
+          exit( EXIT_FAILURE );
+        }
+        max_cases = ( uint64_t )parsed_number;
+        break;
+      }
+      case 't':
+      {
+        budget = atof( optarg );
+        if( budget <= 0.0 )
+        {
+          ( void )fprintf( stderr, "The budget must be positive.\n" );
+          exit( EXIT_FAILURE );
+        }
+        break;
+      }
+      case 'm':
+      {
+        if( !crc_model_find( optarg ) )
+        {
+          ( void )fprintf( stderr, "Unknown model: %s\n", optarg );
+          exit( EXIT_FAILURE );
+        }
+        model_filter = optarg;
+        break;
+      }
+      case 'd':
+      {
+        test_dir = optarg;
+        break;
+      }
+      default:
+      {
+        print_usage( stderr );
+        exit( EXIT_FAILURE );
+      }
+    }
+  }
+}
+
+
+int main( int argc, char** argv )
+{
+  uint8_t* gen;
+  uint64_t state;
+  double start, seconds;
+  size_t len;
+
+  parse_args( argc, argv );
+
+  if( !( gen = ( uint8_t* )malloc( MAX_INPUT_LEN ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    exit( EXIT_FAILURE );
+  }
+
+  if( optind < argc )
+  {
+    for( ; optind < argc; optind++ )
+    {
+      len = read_file( argv[ optind ], gen, MAX_INPUT_LEN );
+      fuzz_one( gen, len );
+    }
+    ( void )fprintf( stdout, "%lu cases replayed, %lu checks, no mismatch.\n",
+                             ( unsigned long )cases, ( unsigned long )checks );
+    free( gen );
+    return EXIT_SUCCESS;
+  }
+
+  ( void )fprintf( stdout, "cpu features: pclmul %s, sse4.2 %s\n",
+                           crc_clmul_supported() ? "yes" : "no",
+                           crc_sse42_supported() ? "yes" : "no" );
+
+  start = get_monotonic_seconds();
+
+  if( test_dir )
+  {
+    check_test_files( test_dir, gen );
+  }
+
+  state = seed ? seed : DEF_SEED;
+  while( ( !max_cases || ( cases < max_cases ) ) &&
+         ( get_monotonic_seconds() - start < budget ) )
+  {
+    len = generate_case( gen, &state, cases );
+    fuzz_one( gen, len );
+  }
+  seconds = get_monotonic_seconds() - start;
+
+  ( void )fprintf( stdout, "%lu cases, %lu bytes, %lu checks in %.1f s (seed %lu), "
+                           "no mismatch.\n",
+                           ( unsigned long )cases, ( unsigned long )bytes,
+                           ( unsigned long )checks, seconds, ( unsigned long )seed );
+
+  free( gen );
+  free( arena_mem );
+
+  return EXIT_SUCCESS;
+}
+
+#endif /* CRC_FUZZ_LIBFUZZER */
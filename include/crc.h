@@ -31,5 +31,51 @@
 #define FILE_BUF_SIZE ( 64UL * 1024UL * 1024UL )
 #endif
 
+/* chunk size and default number of reads in flight of the 
+ * io_uring input mode, the buffers are registered (pinned) */
+#ifndef URING_BUF_SIZE
+#define URING_BUF_SIZE ( 4UL * 1024UL * 1024UL )
+#endif
+
+#ifndef URING_QUEUE_DEPTH
+#define URING_QUEUE_DEPTH 8U
+#endif
+
+/* buffer size and number of buffers of the pipeline 
+ * input mode, the reader thread runs that far ahead */
+#ifndef PIPE_BUF_SIZE
+#define PIPE_BUF_SIZE ( 4UL * 1024UL * 1024UL )
+#endif
+
+#ifndef PIPE_DEPTH
+#define PIPE_DEPTH 4U
+#endif
+
+/* chunk size of the modes which bypass the page cache */
+#ifndef DIRECT_BUF_SIZE
+#define DIRECT_BUF_SIZE ( 16UL * 1024UL * 1024UL )
+#endif
+
+/* chunk size for pipes and other inputs of unknown length */
+#ifndef STREAM_BUF_SIZE
+#define STREAM_BUF_SIZE ( 4UL * 1024UL * 1024UL )
+#endif
+
+/* Files up to SMALL_FILE_SIZE are read in one go into a small
+ * buffer, buffers up to POOL_BUF_SIZE are kept for the next file.
+ * Only larger files get a chunk buffer of their own. */
+#ifndef SMALL_FILE_SIZE
+#define SMALL_FILE_SIZE 4096UL
+#endif
+
+#ifndef POOL_BUF_SIZE
+#define POOL_BUF_SIZE ( 1UL * 1024UL * 1024UL )
+#endif
+
+/* chunk size of the bitwise engine (-o 0) */
+#ifndef BIT_BUF_SIZE
+#define BIT_BUF_SIZE ( 1UL * 1024UL * 1024UL )
+#endif
+
 #endif /* __CRC_H_ */
 
@@ -27,18 +27,196 @@
 
 #include <crctypes.h>
 #include <stdint.h>
+#include <stddef.h>
 
-void crc16_algorithm( uint8_t* data, const uint32_t len, 
+void crc16_algorithm( const uint8_t* data, const uint32_t len, 
                       const crc_param_t* crc_params, uint16_t* p_crc,
                       uint8_t first_call,
                       uint8_t more_fragments );
 
 void init_lut_crc_16( const crc_param_t* crc_params );
 
-void crc16_algorithm_lut( uint8_t* data, const uint32_t len,
+void crc16_algorithm_lut( const uint8_t* data, const uint32_t len,
                           const crc_param_t* crc_params, uint16_t* p_crc,
                           uint8_t first_call,
                           uint8_t more_fragments );
 
+/* Slicing-by-N variants of crc16_algorithm_lut. The tables
+ * have to be initialized with init_lut_crc_16_slicing. */
+void init_lut_crc_16_slicing( const crc_param_t* crc_params );
+
+void crc16_algorithm_slicing_4( const uint8_t* data, const uint32_t len,
+                                const crc_param_t* crc_params, uint16_t* p_crc,
+                                uint8_t first_call,
+                                uint8_t more_fragments );
+
+void crc16_algorithm_slicing_8( const uint8_t* data, const uint32_t len,
+                                const crc_param_t* crc_params, uint16_t* p_crc,
+                                uint8_t first_call,
+                                uint8_t more_fragments );
+
+void crc16_algorithm_slicing_16( const uint8_t* data, const uint32_t len,
+                                 const crc_param_t* crc_params, uint16_t* p_crc,
+                                 uint8_t first_call,
+                                 uint8_t more_fragments );
+
+/* Width generic variants for every polynomial degree
+ * from 1 up to 64. The checksum is returned in the lower
+ * bits of *p_crc. */
+void crc_algorithm( const uint8_t* data, const uint32_t len, 
+                    const crc_param_t* crc_params, uint64_t* p_crc,
+                    uint8_t first_call,
+                    uint8_t more_fragments );
+
+void init_lut_crc( const crc_param_t* crc_params );
+
+void crc_algorithm_lut( const uint8_t* data, const uint32_t len,
+                        const crc_param_t* crc_params, uint64_t* p_crc,
+                        uint8_t first_call,
+                        uint8_t more_fragments );
+
+/* The tables have to be initialized with init_lut_crc_slicing. */
+void init_lut_crc_slicing( const crc_param_t* crc_params );
+
+void crc_algorithm_slicing_4( const uint8_t* data, const uint32_t len,
+                              const crc_param_t* crc_params, uint64_t* p_crc,
+                              uint8_t first_call,
+                              uint8_t more_fragments );
+
+void crc_algorithm_slicing_8( const uint8_t* data, const uint32_t len,
+                              const crc_param_t* crc_params, uint64_t* p_crc,
+                              uint8_t first_call,
+                              uint8_t more_fragments );
+
+void crc_algorithm_slicing_16( const uint8_t* data, const uint32_t len,
+                               const crc_param_t* crc_params, uint64_t* p_crc,
+                               uint8_t first_call,
+                               uint8_t more_fragments );
+
+/* Folding with carry-less multiplication (PCLMULQDQ).
+ * The constants have to be initialized with init_clmul_crc.
+ * Falls back to a lookup table if the cpu does not support
+ * the instruction. The data is never written. */
+void init_clmul_crc( const crc_param_t* crc_params );
+
+uint8_t crc_clmul_supported( void );
+
+void crc_algorithm_clmul( const uint8_t* data, const uint32_t len,
+                          const crc_param_t* crc_params, uint64_t* p_crc,
+                          uint8_t first_call,
+                          uint8_t more_fragments );
+
+/* CRC-32C (Castagnoli) with the SSE4.2 crc32 instruction. 
+ * The tables have to be initialized with init_crc32c_sse42.
+ * Falls back to a lookup table if the cpu does not support
+ * the instruction. The data is never written. */
+void init_crc32c_sse42( void );
+
+uint8_t crc_sse42_supported( void );
+
+void crc_algorithm_sse42( const uint8_t* data, const uint32_t len,
+                          const crc_param_t* crc_params, uint64_t* p_crc,
+                          uint8_t first_call,
+                          uint8_t more_fragments );
+
+/* Runtime kernel dispatch. init_crc_dispatch picks the
+ * fastest kernel (CRC_KERNEL_* in crctypes.h) which the cpu 
+ * supports for the parameter set, initializes its tables and
+ * returns its id. crc_algorithm_dispatch runs that kernel.
+ * crc_select_kernel only reports the choice. A kernel can 
+ * be forced with crc_force_kernel, CRC_KERNEL_AUTO resets. */
+uint8_t init_crc_dispatch( const crc_param_t* crc_params );
+
+void crc_algorithm_dispatch( const uint8_t* data, const uint32_t len,
+                             const crc_param_t* crc_params, uint64_t* p_crc,
+                             uint8_t first_call,
+                             uint8_t more_fragments );
+
+uint8_t crc_select_kernel( const crc_param_t* crc_params );
+uint8_t crc_kernel_supported( uint8_t kernel, const crc_param_t* crc_params );
+uint8_t crc_force_kernel( uint8_t kernel );
+
+/* returns CRC_KERNEL_COUNT for unknown names */
+uint8_t crc_kernel_from_name( const char* name );
+const char* crc_kernel_name( uint8_t kernel );
+
+/* Re-entrant streaming api. A context holds the parameter
+ * set, its own precomputed tables and the running register.
+ * crc_ctx_init picks the kernel like init_crc_dispatch (an
+ * unsupported kernel falls back to the automatic choice)
+ * and returns NULL on failure. crc_ctx_final returns the
+ * checksum of everything passed to crc_ctx_update since
+ * init or reset, further updates may follow. Updates do not
+ * allocate or lock, one context per thread. */
+typedef struct crc_ctx crc_ctx_t;
+
+crc_ctx_t* crc_ctx_init( const crc_param_t* crc_params, uint8_t kernel );
+
+void crc_ctx_update( crc_ctx_t* ctx, const uint8_t* data, size_t len );
+
+uint64_t crc_ctx_final( const crc_ctx_t* ctx );
+
+void crc_ctx_reset( crc_ctx_t* ctx );
+
+void crc_ctx_free( crc_ctx_t* ctx );
+
+/* CRC_KERNEL_* id of the kernel the context uses */
+uint8_t crc_ctx_kernel( const crc_ctx_t* ctx );
+
+/* Multi-buffer api. crc_batch writes the checksum of data[ i ]
+ * with len[ i ] bytes to crcs[ i ], for count independent
+ * messages. CRC_BATCH_LANES messages are crunched interleaved,
+ * so the latencies of the lanes overlap. The parameter set is
+ * prepared once by crc_batch_init (NULL on failure), a batch
+ * is only read by crc_batch and can be shared by threads. */
+#define CRC_BATCH_LANES 4U
+
+typedef struct crc_batch crc_batch_t;
+
+crc_batch_t* crc_batch_init( const crc_param_t* crc_params );
+
+void crc_batch( const crc_batch_t* batch, const uint8_t* const* data,
+                const size_t* len, size_t count, uint64_t* crcs );
+
+void crc_batch_free( crc_batch_t* batch );
+
+/* Combination of the checksums of two adjacent blocks:
+ * crc( A || B ) from crc( A ), crc( B ) and len( B ), both
+ * checksums complete (final xor and reflection applied).
+ * init_crc_combine precomputes x^(8 * 2^k) mod P for the
+ * parameter set, crc_combine costs O( log len( B ) ). */
+#define CRC_COMBINE_POWERS 64U
+
+typedef struct crc_combine
+{
+  crc_param_t params;
+
+  /* left aligned polynomial and x^(8 * 2^k) mod P */
+  uint64_t    poly;
+  uint64_t    xpow[ CRC_COMBINE_POWERS ];
+
+} crc_combine_t;
+
+void init_crc_combine( crc_combine_t* comb, const crc_param_t* crc_params );
+
+uint64_t crc_combine( const crc_combine_t* comb, uint64_t crc_a, 
+                      uint64_t crc_b, uint64_t len_b );
+
+/* Checksum of a whole file, which is mapped into memory
+ * and crunched by the automatically picked kernel. Returns 0xFF on
+ * success and 0x00 if the file can not be opened/mapped. */
+uint8_t crc_file_mmap( const char* file, const crc_param_t* crc_params,
+                       uint64_t* p_crc );
+
+/* Checksums of many (small) files. Up to queue_depth files are
+ * in flight, their opens, reads and closes are batched into
+ * shared io_uring submissions. ok[ i ] is 0xFF if crcs[ i ] holds
+ * the checksum of files[ i ] and 0x00 if it could not be read.
+ * Without io_uring the files are read one after another. Returns
+ * the number of checksums, n if every file could be read. */
+size_t crc_files_uring( const char* const* files, size_t n,
+                        const crc_param_t* crc_params, uint64_t* crcs,
+                        uint8_t* ok, uint32_t queue_depth );
+
 #endif /* __CRC_API_H_ */
 
@@ -26,11 +26,33 @@
 #ifndef __CRCBIT_H_
 #define __CRCBIT_H_
 
+#include <crctypes.h>
+
 #include <stdint.h>
+#include <stddef.h>
 
 
 void calculate_crc_from_file_bitwise( const char* file, 
                                       uint8_t polynomial_degree );
 
+/* Model (crcparam_even.h layout) which replaces the parameter set
+ * of the degree, its own degree is used then. NULL resets. */
+void set_bitwise_params( const crc_param_t* crc_params );
+
+/* Parameter set of calculate_crc_from_file_bitwise for the degree,
+ * the model of set_bitwise_params if there is one. NULL for an
+ * unsupported degree. */
+const crc_param_t* get_bitwise_params( uint8_t degree );
+
+/* Checksum of a buffer with the shift register of
+ * calculate_crc_from_file_bitwise, the reference of the
+ * table driven and vectorized kernels (crc_fuzz). The
+ * model has the layout of crcparam_even.h, degree 1 to 64. */
+uint64_t calculate_crc_bitwise( const crc_param_t* crc_params, 
+                                const uint8_t* data, size_t len );
+
+/* chunk size in bytes, 0 restores the default BIT_BUF_SIZE */
+void set_bitwise_chunk_size( size_t size );
+
 #endif /* __CRCBIT_H_ */
 
@@ -26,7 +26,20 @@
 #ifndef __CRCBYTE_H_
 #define __CRCBYTE_H_
 
+#include <crctypes.h>
+
 #include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+
+/* how the input file is brought into memory */
+#define CRC_INPUT_READ    0U /* read() into a FILE_BUF_SIZE buffer */
+#define CRC_INPUT_MMAP    1U /* mapped, kernels read the page cache */
+#define CRC_INPUT_URING   2U /* io_uring, several reads in flight */
+#define CRC_INPUT_PIPE    3U /* reader thread fills a ring of buffers */
+#define CRC_INPUT_DIRECT  4U /* O_DIRECT, bypasses the page cache */
+#define CRC_INPUT_NOCACHE 5U /* read(), pages dropped behind (DONTNEED) */
 
 
 void calculate_crc_from_file_bytewise( const char* file, 
@@ -35,5 +48,51 @@ void calculate_crc_from_file_bytewise( const char* file,
 void calculate_crc_from_file_bytewise_lut( const char* file, 
                                            uint8_t polynomial_degree );
 
+/* slices must be 4, 8 or 16 */
+void calculate_crc_from_file_bytewise_slicing( const char* file, 
+                                               uint8_t polynomial_degree,
+                                               uint8_t slices );
+
+void calculate_crc_from_file_bytewise_clmul( const char* file, 
+                                             uint8_t polynomial_degree );
+
+/* CRC-32C only, polynomial_degree must be 32 */
+void calculate_crc_from_file_bytewise_sse42( const char* file, 
+                                             uint8_t polynomial_degree );
+
+/* uses the kernel picked by the runtime dispatcher */
+void calculate_crc_from_file_bytewise_dispatch( const char* file, 
+                                                uint8_t polynomial_degree );
+
+/* One checksum per line for every file, then the p50 and p99
+ * latency per file. kernel is one of the CRC_KERNEL_* ids, with
+ * CRC_KERNEL_AUTO the dispatcher picks it. Sized for many small
+ * files, the files are read with read() in any input mode. */
+void calculate_crc_of_files( const char* const* files, uint32_t n, 
+                             uint8_t polynomial_degree, uint8_t kernel );
+
+/* input mode of the calculate_crc_from_file_bytewise_* 
+ * functions, one of CRC_INPUT_*, default is CRC_INPUT_READ */
+void set_bytewise_input_mode( uint8_t mode );
+
+/* reads in flight with CRC_INPUT_URING (1 up to URING_MAX_QUEUE_DEPTH,
+ * default URING_QUEUE_DEPTH) or buffers of the CRC_INPUT_PIPE ring 
+ * (1 up to PIPE_MAX_DEPTH, default PIPE_DEPTH) */
+void set_bytewise_queue_depth( uint32_t depth );
+
+/* chunk size of all input modes but CRC_INPUT_MMAP in bytes, 
+ * 0 restores the defaults (FILE_BUF_SIZE, URING_BUF_SIZE, 
+ * PIPE_BUF_SIZE, DIRECT_BUF_SIZE and STREAM_BUF_SIZE) */
+void set_bytewise_chunk_size( size_t size );
+
+/* Model which replaces the parameter set of the degree, any degree
+ * from 1 up to 64 goes then and the polynomial_degree arguments are
+ * ignored. NULL resets. The tables are the generated ones of the
+ * catalogue (crcmodel.h) or built when the model is first used. */
+void set_bytewise_params( const crc_param_t* crc_params );
+
+/* prints the kernel the dispatcher picks for every parameter set */
+void print_dispatch_report( FILE* out );
+
 #endif /* __CRCBYTE_H_ */
 
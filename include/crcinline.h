@@ -0,0 +1,142 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcinline.h
+ *
+ *
+ * Purpose:   The table driven model kernel as always
+ *            inlined functions and the macro which stamps
+ *            out the functions of a model from its spec.
+ *
+ *
+ * Remarks:   - crcmodel.c stamps out the kernels of the
+ *              library with it (extern), the amalgamation
+ *              lib/crcsingle.h (static inline), so both
+ *              crunch with the same code.
+ *
+ *            - Reflected models keep the register reflected
+ *              and right aligned, the others left aligned
+ *              in 64 bit. So any width from 1 up to 64 goes
+ *              without a shift per byte.
+ *
+ *            - table is slice 0 of the 64 bit tables of
+ *              crctabgen.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#ifndef __CRC_INLINE_H_
+#define __CRC_INLINE_H_
+
+#include <crcparam_even.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CRC_INLINE static inline __attribute__( ( always_inline ) )
+
+/* all ones in the lower width bits */
+#define CRC_WIDTH_MASK( width ) \
+  ( ( width ) >= 64U ? 0xFFFFFFFFFFFFFFFFUL : ( ( 1UL << ( width ) ) - 1UL ) )
+
+
+CRC_INLINE uint64_t crc_inline_reflect( uint64_t v, uint8_t width );
+CRC_INLINE uint64_t crc_inline_init( uint8_t width, uint64_t initial, uint8_t refin );
+CRC_INLINE uint64_t crc_inline_update( const uint64_t* table, uint8_t refin,
+                                       uint64_t reg, const uint8_t* data, size_t len );
+CRC_INLINE uint64_t crc_inline_final( uint8_t width, uint64_t final, uint8_t refin,
+                                      uint8_t refout, uint64_t reg );
+
+
+CRC_INLINE uint64_t crc_inline_reflect( uint64_t v, uint8_t width )
+{
+  uint64_t r = 0UL;
+  uint8_t i;
+
+  for( i = 0U; i < width; i++ )
+  {
+    r = ( r << 1U ) | ( v & 1UL );
+    v >>= 1U;
+  }
+  return r;
+}
+
+
+CRC_INLINE uint64_t crc_inline_init( uint8_t width, uint64_t initial, uint8_t refin )
+{
+  initial &= CRC_WIDTH_MASK( width );
+  return refin ? crc_inline_reflect( initial, width ) : initial << ( 64U - width );
+}
+
+
+CRC_INLINE uint64_t crc_inline_update( const uint64_t* table, uint8_t refin,
+                                       uint64_t reg, const uint8_t* data, size_t len )
+{
+  if( refin )
+  {
+    while( len-- )
+    {
+      reg = ( reg >> 8U ) ^ table[ ( reg ^ *data++ ) & 0xFFU ];
+    }
+    return reg;
+  }
+
+  while( len-- )
+  {
+    reg = ( reg << 8U ) ^ table[ ( reg >> 56U ) ^ *data++ ];
+  }
+  return reg;
+}
+
+
+CRC_INLINE uint64_t crc_inline_final( uint8_t width, uint64_t final, uint8_t refin,
+                                      uint8_t refout, uint64_t reg )
+{
+  if( !refin )
+  {
+    reg >>= ( 64U - width );
+  }
+  if( !refin != !refout )
+  {
+    reg = crc_inline_reflect( reg, width );
+  }
+  return ( reg ^ final ) & CRC_WIDTH_MASK( width );
+}
+
+
+/* NAME, NAME_init, NAME_update and NAME_final (see crcmodel.h)
+ * of a model, linkage is extern or CRC_INLINE. Called with the
+ * spec of CRC_MODEL_LIST, which is expanded to its six values. */
+#define CRC_INLINE_MODEL( linkage, name, table, width, poly, initial, final, refin, refout ) \
+                                                                         \
+  linkage uint64_t name##_init( void )                                   \
+  {                                                                      \
+    return crc_inline_init( width, initial, refin );                     \
+  }                                                                      \
+                                                                         \
+  linkage uint64_t name##_update( uint64_t reg, const uint8_t* data, size_t len ) \
+  {                                                                      \
+    return crc_inline_update( table, refin, reg, data, len );            \
+  }                                                                      \
+                                                                         \
+  linkage uint64_t name##_final( uint64_t reg )                          \
+  {                                                                      \
+    return crc_inline_final( width, final, refin, refout, reg );         \
+  }                                                                      \
+                                                                         \
+  linkage uint64_t name( const uint8_t* data, size_t len )               \
+  {                                                                      \
+    return crc_inline_final( width, final, refin, refout,                \
+                             crc_inline_update( table, refin,            \
+                                                crc_inline_init( width, initial, refin ), \
+                                                data, len ) );           \
+  }
+
+#endif /* __CRC_INLINE_H_ */
@@ -0,0 +1,140 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crckernel.h
+ *
+ *
+ * Purpose:   Internal interface between the kernel
+ *            modules of the library. Every kernel has
+ *            a core which gets its precomputed tables
+ *            passed in, so several parameter sets can
+ *            be crunched at the same time.
+ *
+ *
+ * Remarks:   - Not part of the public api (crcapi.h).
+ *
+ *            - The cores take and return the plain
+ *              crc register: right aligned, not reflected,
+ *              with the initial xor applied but without
+ *              the final xor. They never write the data.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#ifndef __CRC_KERNEL_H_
+#define __CRC_KERNEL_H_
+
+#include <crctypes.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CRC_MAX_SLICES 16U
+
+
+/* Tables of the table driven kernels. slice[ k ][ i ] holds the
+ * crc of the byte i followed by k zero bytes. For reflected input
+ * the tables are reflected and right aligned, otherwise they are
+ * left aligned in the 64 bit word. */
+typedef struct crc_lut_tables
+{
+  uint64_t slice[ CRC_MAX_SLICES ][ 0x100U ];
+
+} crc_lut_tables_t;
+
+
+typedef struct crc_clmul_consts
+{
+  /* x^(F + 64) mod P' in the upper and
+   * x^F mod P' in the lower quad word. */
+  uint64_t fold_512[ 2 ];
+  uint64_t fold_128[ 2 ];
+
+  /* Bit reversed x^(F - 1) mod P' in the upper and
+   * x^(F + 63) mod P' in the lower quad word. The missing
+   * power of x makes up for the product of two reversed
+   * factors being shifted by one bit. */
+  uint64_t fold_512_r[ 2 ];
+  uint64_t fold_128_r[ 2 ];
+
+  /* floor( x^128 / P' ) without the x^64 term */
+  uint64_t mu;
+
+  /* P' without the x^64 term */
+  uint64_t poly;
+
+  uint64_t lut[ 0x100U ];
+  uint8_t  reflect_lut[ 0x100U ];
+
+  uint8_t  degree;
+
+} crc_clmul_consts_t;
+
+
+/* long_shift[ k ][ i ] shifts the byte i at position k of the
+ * reflected register over 8192 zero bytes, short_shift over 256. */
+typedef struct crc32c_tables
+{
+  uint32_t long_shift[ 4 ][ 0x100U ];
+  uint32_t short_shift[ 4 ][ 0x100U ];
+  uint32_t lut[ 0x100U ];
+
+} crc32c_tables_t;
+
+
+uint64_t crc_bitwise_update( const crc_param_t* crc_params, uint64_t crc,
+                             const uint8_t* data, size_t len );
+
+/* builds the first slices tables, slices is 1 up to CRC_MAX_SLICES */
+void crc_lut_build( crc_lut_tables_t* tables, const crc_param_t* crc_params,
+                    uint8_t slices );
+
+/* slices must not exceed the number of tables built */
+uint64_t crc_lut_update( const crc_lut_tables_t* tables,
+                         const crc_param_t* crc_params, uint64_t crc,
+                         const uint8_t* data, size_t len, uint8_t slices );
+
+/* The generated const tables (crctables.h) of the parameters or
+ * NULL. Models with the same width, polynomial and refin share one
+ * set. All CRC_MAX_SLICES slices are there. The 16 bit tables are
+ * the ones of the CRC16 kernels in crcbyte.c and only exist for
+ * models of degree 16. */
+const crc_lut_tables_t* crc_lut_find( const crc_param_t* crc_params );
+
+const uint16_t ( *crc_lut_16_find( const crc_param_t* crc_params ) )[ 0x100U ];
+
+void crc_clmul_build( crc_clmul_consts_t* consts, const crc_param_t* crc_params );
+
+uint64_t crc_clmul_update( const crc_clmul_consts_t* consts,
+                           const crc_param_t* crc_params, uint64_t crc,
+                           const uint8_t* data, size_t len );
+
+/* Folding lanes of crc_batch, one 128 bit remainder acc per
+ * message. crc_clmul_lane_start adds the register in table
+ * orientation (see crc_lut_tables_t) to the first 16 bytes,
+ * crc_clmul_lanes folds blocks more 16 byte blocks into each
+ * of the CRC_BATCH_LANES lanes and advances data[ i ],
+ * crc_clmul_lane_finish reduces acc back to the register.
+ * Only to be called if crc_clmul_supported. */
+void crc_clmul_lane_start( uint64_t* acc, uint8_t reflect, uint64_t crc,
+                           const uint8_t* data );
+
+void crc_clmul_lanes( const crc_clmul_consts_t* consts, uint8_t reflect,
+                      uint64_t ( *acc )[ 2 ], const uint8_t** data, size_t blocks );
+
+uint64_t crc_clmul_lane_finish( const crc_clmul_consts_t* consts, uint8_t reflect,
+                                const uint64_t* acc );
+
+void crc32c_build( crc32c_tables_t* tables );
+
+uint32_t crc32c_update( const crc32c_tables_t* tables, uint32_t crc,
+                        const uint8_t* data, size_t len );
+
+#endif /* __CRC_KERNEL_H_ */
@@ -0,0 +1,100 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcmodel.h
+ *
+ *
+ * Purpose:   Kernels which are specialized at compile
+ *            time for every model of crcparam_even.h
+ *            (CRC_MODEL_LIST) and the registry which
+ *            maps the models to them.
+ *
+ *
+ * Remarks:   - The registry is the catalogue of the named
+ *              models with their check values. Models
+ *              which are not listed are set up at runtime
+ *              with crc_param_set, the kernels build their
+ *              tables for them when they are first used.
+ *
+ *            - For every model NAME of the list there is
+ *
+ *              NAME( data, len )           checksum of a buffer
+ *              NAME_init()                 start register
+ *              NAME_update( reg, data, len )
+ *              NAME_final( reg )           checksum of the register
+ *
+ *              The register between init and final is in
+ *              the internal orientation of the kernel,
+ *              only the result of final is a checksum.
+ *
+ *            - The lookup tables are generated at build
+ *              time (crctabgen), so no init is needed.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#ifndef __CRC_MODEL_H_
+#define __CRC_MODEL_H_
+
+#include <crctypes.h>
+#include <crcparam_even.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+typedef uint64_t ( *crc_model_oneshot_func )( const uint8_t*, size_t );
+typedef uint64_t ( *crc_model_init_func )( void );
+typedef uint64_t ( *crc_model_update_func )( uint64_t, const uint8_t*, size_t );
+typedef uint64_t ( *crc_model_final_func )( uint64_t );
+
+typedef struct crc_model
+{
+  const char*            name;
+  const char*            symbol;
+  crc_param_t            params;
+  uint64_t               check;
+  crc_model_oneshot_func oneshot;
+  crc_model_init_func    init;
+  crc_model_update_func  update;
+  crc_model_final_func   final;
+
+} crc_model_t;
+
+
+#define CRC_MODEL_DECLARE( name, title, spec, check )                    \
+  uint64_t name( const uint8_t* data, size_t len );                      \
+  uint64_t name##_init( void );                                          \
+  uint64_t name##_update( uint64_t reg, const uint8_t* data, size_t len ); \
+  uint64_t name##_final( uint64_t reg );
+
+CRC_MODEL_LIST( CRC_MODEL_DECLARE )
+
+
+uint32_t crc_model_count( void );
+
+/* NULL if index >= crc_model_count() */
+const crc_model_t* crc_model_get( uint32_t index );
+
+/* Catalogue name (case does not matter) or function name prefix,
+ * e.g. "CRC-32/ISCSI" or "crc32_iscsi". NULL if there is no such model. */
+const crc_model_t* crc_model_find( const char* name );
+
+/* the model with exactly these parameters or NULL */
+const crc_model_t* crc_model_find_params( const crc_param_t* crc_params );
+
+/* Fills crc_params with a model which is not in the catalogue, the
+ * values are right aligned and not reflected. The bits above degree
+ * are dropped. Returns 0x00U if the degree is not 1 up to 64. */
+uint8_t crc_param_set( crc_param_t* crc_params, uint8_t degree,
+                       uint64_t coeff, uint64_t initial, uint64_t final,
+                       uint8_t refin, uint8_t refout );
+
+#endif /* __CRC_MODEL_H_ */
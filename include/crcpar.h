@@ -0,0 +1,44 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcpar.h
+ * 
+ *
+ * Purpose:   Interface of the multithreaded crc
+ *            calculation of a single file.
+ *
+ * 
+ * Remarks:   -
+ *
+ *
+ * Date:      10/2026 
+ * 
+ */
+
+#ifndef __CRCPAR_H_
+#define __CRCPAR_H_
+
+#include <crctypes.h>
+
+#include <stdint.h>
+
+#define CRC_PAR_MAX_THREADS 256U
+
+
+/* Same parameter sets and output as 
+ * calculate_crc_from_file_bitwise, threads is 1 
+ * up to CRC_PAR_MAX_THREADS. */
+void calculate_crc_from_file_parallel( const char* file, 
+                                       uint8_t polynomial_degree,
+                                       uint16_t threads );
+
+/* Model which replaces the parameter set of the degree, its own
+ * degree is used then. NULL resets. */
+void set_parallel_params( const crc_param_t* crc_params );
+
+#endif /* __CRCPAR_H_ */
@@ -16,8 +16,20 @@
  *            the most sgnificant bit is omitted.
  *
  * 
- * Remarks:   - Watch the endianness when 
- *              initializing unions in C89 manner.
+ * Remarks:   - Every model is spelled out once as a
+ *              spec: degree, coefficients, initial xor,
+ *              final xor, reflect input and reflect
+ *              remainder. The crc_param_t initializers
+ *              and the specialized kernels (crcmodel.c,
+ *              CRC_MODEL_LIST) are generated from it.
+ *
+ *            - The bitwise engine (crcbit.c) takes its
+ *              defaults from here too, there is no second
+ *              header to keep in sync.
+ *
+ *            - The union fields are initialized byte
+ *              by byte in C89 manner, CRC_PARAM_FIELD 
+ *              lays the value out little endian.
  *            
  *            - The initial values defined here
  *              are specified for the crc_param_t
@@ -31,85 +43,190 @@
 #ifndef __CRCPARAM_EVEN_H_
 #define __CRCPARAM_EVEN_H_
 
+#include <stdint.h>
+
+
+#define CRC_PARAM_BYTE( v, n ) \
+  ( ( uint8_t )( ( ( uint64_t )( v ) >> ( 8U * ( n ) ) ) & 0xFFU ) )
+
+#define CRC_PARAM_FIELD( v )                                          \
+  { { CRC_PARAM_BYTE( v, 0U ), CRC_PARAM_BYTE( v, 1U ),               \
+      CRC_PARAM_BYTE( v, 2U ), CRC_PARAM_BYTE( v, 3U ),               \
+      CRC_PARAM_BYTE( v, 4U ), CRC_PARAM_BYTE( v, 5U ),               \
+      CRC_PARAM_BYTE( v, 6U ), CRC_PARAM_BYTE( v, 7U ) } }
+
+#define CRC_PARAM_INIT_( degree, coeff, initial, final, refin, refout ) \
+  { degree, CRC_PARAM_FIELD( coeff ), CRC_PARAM_FIELD( initial ),      \
+    CRC_PARAM_FIELD( final ), refin, refout }
+
+/* the extra level expands a spec into its six arguments */
+#define CRC_PARAM_INIT( spec ) CRC_PARAM_INIT_( spec )
+
+
+/*                           degree coefficients          initial
+ *                           final xor                    refl. in  refl. rem. */
 
 /* some CRC 3 values */
 
-#define CRC_3_WIKIPEDIA    {                \
-/* polynomial degree */      3U,            \
-/* coefficients */           { { 0x03U } }, \
-/* initial */                { { 0x00U } }, \
-/* final xor */              { { 0x00U } }, \
-/* reflect input */          0x00U,         \
-/* reflect remainder */      0x00U          \
-                           }
+#define CRC_3_WIKIPEDIA_SPEC      3U, 0x03U,                0x00U,                \
+                                  0x00U,                    0x00U,    0x00U
 
+#define CRC_3_GSM_SPEC            3U, 0x03U,                0x00U,                \
+                                  0x07U,                    0x00U,    0x00U
+
+#define CRC_3_ROHC_SPEC           3U, 0x03U,                0x07U,                \
+                                  0x00U,                    0xFFU,    0xFFU
+
+/* some CRC 5 and CRC 7 values */
+
+#define CRC_5_USB_SPEC            5U, 0x05U,                0x1FU,                \
+                                  0x1FU,                    0xFFU,    0xFFU
+
+#define CRC_7_MMC_SPEC            7U, 0x09U,                0x00U,                \
+                                  0x00U,                    0x00U,    0x00U
 
 /* some CRC 8 values */
 
-#define CRC_8_CCITT        {                \
-/* polynomial degree */      8U,            \
-/* coefficients */           { { 0x07U } }, \
-/* initial */                { { 0x00U } }, \
-/* final xor */              { { 0x00U } }, \
-/* reflect input */          0x00U,         \
-/* reflect remainder */      0x00U          \
-                           }
+#define CRC_8_CCITT_SPEC          8U, 0x07U,                0x00U,                \
+                                  0x00U,                    0x00U,    0x00U
+
+#define CRC_8_AUTOSAR_SPEC        8U, 0x2FU,                0xFFU,                \
+                                  0xFFU,                    0x00U,    0x00U
+
+#define CRC_8_MAXIM_DOW_SPEC      8U, 0x31U,                0x00U,                \
+                                  0x00U,                    0xFFU,    0xFFU
+
+#define CRC_8_SAE_J1850_SPEC      8U, 0x1DU,                0xFFU,                \
+                                  0xFFU,                    0x00U,    0x00U
+
+/* some CRC 10 and CRC 15 values */
 
+#define CRC_10_ATM_SPEC          10U, 0x0233U,              0x0000U,              \
+                                  0x0000U,                  0x00U,    0x00U
+
+#define CRC_15_CAN_SPEC          15U, 0x4599U,              0x0000U,              \
+                                  0x0000U,                  0x00U,    0x00U
 
 /* some CRC 16 values */
 
-#define CRC_16_CCITT_FALSE {                       \
-/* polynomial degree */      16U,                  \
-/* coefficients */           { { 0x21U, 0x10U } }, \
-/* initial */                { { 0xFFU, 0xFFU } }, \
-/* final xor */              { { 0x00U, 0x00U } }, \
-/* reflect input */          0x00U,                \
-/* reflect remainder */      0x00U                 \
-                           }
-
-#define CRC_16_KERMIT      {                       \
-/* polynomial degree */      16U,                  \
-/* coefficients */           { { 0x21U, 0x10U } }, \
-/* initial */                { { 0x00U, 0x00U } }, \
-/* final xor */              { { 0x00U, 0x00U } }, \
-/* reflect input */          0xFFU,                \
-/* reflect remainder */      0xFFU                 \
-                           }
-
-/* just for testing purposes */
-#define CRC_16_SHITTY      {                       \
-/* polynomial degree */      16U,                  \
-/* coefficients */           { { 0x21U, 0xFFU } }, \
-/* initial */                { { 0x00U, 0x00U } }, \
-/* final xor */              { { 0x00U, 0x00U } }, \
-/* reflect input */          0x00U,                \
-/* reflect remainder */      0x00U                 \
-                           }
+#define CRC_16_CCITT_FALSE_SPEC  16U, 0x1021U,              0xFFFFU,              \
+                                  0x0000U,                  0x00U,    0x00U
+
+#define CRC_16_KERMIT_SPEC       16U, 0x1021U,              0x0000U,              \
+                                  0x0000U,                  0xFFU,    0xFFU
+
+#define CRC_16_ARC_SPEC          16U, 0x8005U,              0x0000U,              \
+                                  0x0000U,                  0xFFU,    0xFFU
+
+#define CRC_16_IBM_SDLC_SPEC     16U, 0x1021U,              0xFFFFU,              \
+                                  0xFFFFU,                  0xFFU,    0xFFU
+
+#define CRC_16_MODBUS_SPEC       16U, 0x8005U,              0xFFFFU,              \
+                                  0x0000U,                  0xFFU,    0xFFU
+
+#define CRC_16_USB_SPEC          16U, 0x8005U,              0xFFFFU,              \
+                                  0xFFFFU,                  0xFFU,    0xFFU
+
+#define CRC_16_XMODEM_SPEC       16U, 0x1021U,              0x0000U,              \
+                                  0x0000U,                  0x00U,    0x00U
+
+/* just for testing purposes, not in CRC_MODEL_LIST */
+#define CRC_16_SHITTY_SPEC       16U, 0xFF21U,              0x0000U,              \
+                                  0x0000U,                  0x00U,    0x00U
+
+/* some CRC 24 values */
 
+#define CRC_24_OPENPGP_SPEC      24U, 0x864CFBU,            0xB704CEU,            \
+                                  0x000000U,                0x00U,    0x00U
 
 /* some CRC 32 values */
 
-#define CRC_32             {                                     \
-/* polynomial degree */      32U,                                \
-/* coefficients */           { { 0xB7U, 0x1DU, 0xC1U, 0x04U } }, \
-/* initial */                { { 0xFFU, 0xFFU, 0xFFU, 0xFFU } }, \
-/* final xor */              { { 0xFFU, 0xFFU, 0xFFU, 0xFFU } }, \
-/* reflect input */          0xFFU,                              \
-/* reflect remainder */      0xFFU                               \
-                           }
+#define CRC_32_SPEC              32U, 0x04C11DB7U,          0xFFFFFFFFU,          \
+                                  0xFFFFFFFFU,              0xFFU,    0xFFU
 
+/* Castagnoli, used by iSCSI, SCTP, ext4, ... */
+#define CRC_32_C_SPEC            32U, 0x1EDC6F41U,          0xFFFFFFFFU,          \
+                                  0xFFFFFFFFU,              0xFFU,    0xFFU
 
-/* some CRC 64 values */
+#define CRC_32_AUTOSAR_SPEC      32U, 0xF4ACFB13U,          0xFFFFFFFFU,          \
+                                  0xFFFFFFFFU,              0xFFU,    0xFFU
+
+#define CRC_32_BZIP2_SPEC        32U, 0x04C11DB7U,          0xFFFFFFFFU,          \
+                                  0xFFFFFFFFU,              0x00U,    0x00U
+
+#define CRC_32_CKSUM_SPEC        32U, 0x04C11DB7U,          0x00000000U,          \
+                                  0xFFFFFFFFU,              0x00U,    0x00U
+
+#define CRC_32_JAMCRC_SPEC       32U, 0x04C11DB7U,          0xFFFFFFFFU,          \
+                                  0x00000000U,              0xFFU,    0xFFU
 
-#define CRC_64_ISO         {                                                                 \
-/* polynomial degree */      64U,                                                            \
-/* coefficients */           { { 0x1BU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U } }, \
-/* initial */                { { 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U } }, \
-/* final xor */              { { 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U } }, \
-/* reflect input */          0x00U,                                                          \
-/* reflect remainder */      0x00U                                                           \
-                           }
+#define CRC_32_MPEG_2_SPEC       32U, 0x04C11DB7U,          0xFFFFFFFFU,          \
+                                  0x00000000U,              0x00U,    0x00U
 
+/* some CRC 64 values */
+
+#define CRC_64_ISO_SPEC          64U, 0x000000000000001BUL, 0x0000000000000000UL, \
+                                  0x0000000000000000UL,     0x00U,    0x00U
+
+#define CRC_64_ECMA_182_SPEC     64U, 0x42F0E1EBA9EA3693UL, 0x0000000000000000UL, \
+                                  0x0000000000000000UL,     0x00U,    0x00U
+
+#define CRC_64_GO_ISO_SPEC       64U, 0x000000000000001BUL, 0xFFFFFFFFFFFFFFFFUL, \
+                                  0xFFFFFFFFFFFFFFFFUL,     0xFFU,    0xFFU
+
+#define CRC_64_WE_SPEC           64U, 0x42F0E1EBA9EA3693UL, 0xFFFFFFFFFFFFFFFFUL, \
+                                  0xFFFFFFFFFFFFFFFFUL,     0x00U,    0x00U
+
+#define CRC_64_XZ_SPEC           64U, 0x42F0E1EBA9EA3693UL, 0xFFFFFFFFFFFFFFFFUL, \
+                                  0xFFFFFFFFFFFFFFFFUL,     0xFFU,    0xFFU
+
+
+#define CRC_3_WIKIPEDIA    CRC_PARAM_INIT( CRC_3_WIKIPEDIA_SPEC )
+#define CRC_8_CCITT        CRC_PARAM_INIT( CRC_8_CCITT_SPEC )
+#define CRC_16_CCITT_FALSE CRC_PARAM_INIT( CRC_16_CCITT_FALSE_SPEC )
+#define CRC_16_KERMIT      CRC_PARAM_INIT( CRC_16_KERMIT_SPEC )
+#define CRC_16_SHITTY      CRC_PARAM_INIT( CRC_16_SHITTY_SPEC )
+#define CRC_32             CRC_PARAM_INIT( CRC_32_SPEC )
+#define CRC_32_C           CRC_PARAM_INIT( CRC_32_C_SPEC )
+#define CRC_64_ISO         CRC_PARAM_INIT( CRC_64_ISO_SPEC )
+
+
+/* X-macro over all models of the catalogue. X( ident, name, spec,
+ * check ) gets called with the function name prefix, the catalogue
+ * name (as in the CRC RevEng catalogue where the model is listed
+ * there), the spec and the checksum of the ASCII string "123456789". */
+#define CRC_MODEL_LIST( X )                                                              \
+  X( crc3_gsm,          "CRC-3/GSM",       CRC_3_GSM_SPEC,          0x4UL                ) \
+  X( crc3_rohc,         "CRC-3/ROHC",      CRC_3_ROHC_SPEC,         0x6UL                ) \
+  X( crc3_wikipedia,    "CRC-3/WIKIPEDIA", CRC_3_WIKIPEDIA_SPEC,    0x3UL                ) \
+  X( crc5_usb,          "CRC-5/USB",       CRC_5_USB_SPEC,          0x19UL               ) \
+  X( crc7_mmc,          "CRC-7/MMC",       CRC_7_MMC_SPEC,          0x75UL               ) \
+  X( crc8_autosar,      "CRC-8/AUTOSAR",   CRC_8_AUTOSAR_SPEC,      0xDFUL               ) \
+  X( crc8_maxim_dow,    "CRC-8/MAXIM-DOW", CRC_8_MAXIM_DOW_SPEC,    0xA1UL               ) \
+  X( crc8_sae_j1850,    "CRC-8/SAE-J1850", CRC_8_SAE_J1850_SPEC,    0x4BUL               ) \
+  X( crc8_ccitt,        "CRC-8/SMBUS",     CRC_8_CCITT_SPEC,        0xF4UL               ) \
+  X( crc10_atm,         "CRC-10/ATM",      CRC_10_ATM_SPEC,         0x199UL              ) \
+  X( crc15_can,         "CRC-15/CAN",      CRC_15_CAN_SPEC,         0x59EUL              ) \
+  X( crc16_arc,         "CRC-16/ARC",      CRC_16_ARC_SPEC,         0xBB3DUL             ) \
+  X( crc16_ccitt_false, "CRC-16/IBM-3740", CRC_16_CCITT_FALSE_SPEC, 0x29B1UL             ) \
+  X( crc16_ibm_sdlc,    "CRC-16/IBM-SDLC", CRC_16_IBM_SDLC_SPEC,    0x906EUL             ) \
+  X( crc16_kermit,      "CRC-16/KERMIT",   CRC_16_KERMIT_SPEC,      0x2189UL             ) \
+  X( crc16_modbus,      "CRC-16/MODBUS",   CRC_16_MODBUS_SPEC,      0x4B37UL             ) \
+  X( crc16_usb,         "CRC-16/USB",      CRC_16_USB_SPEC,         0xB4C8UL             ) \
+  X( crc16_xmodem,      "CRC-16/XMODEM",   CRC_16_XMODEM_SPEC,      0x31C3UL             ) \
+  X( crc24_openpgp,     "CRC-24/OPENPGP",  CRC_24_OPENPGP_SPEC,     0x21CF02UL           ) \
+  X( crc32_autosar,     "CRC-32/AUTOSAR",  CRC_32_AUTOSAR_SPEC,     0x1697D06AUL         ) \
+  X( crc32_bzip2,       "CRC-32/BZIP2",    CRC_32_BZIP2_SPEC,       0xFC891918UL         ) \
+  X( crc32_cksum,       "CRC-32/CKSUM",    CRC_32_CKSUM_SPEC,       0x765E7680UL         ) \
+  X( crc32_iscsi,       "CRC-32/ISCSI",    CRC_32_C_SPEC,           0xE3069283UL         ) \
+  X( crc32_iso_hdlc,    "CRC-32/ISO-HDLC", CRC_32_SPEC,             0xCBF43926UL         ) \
+  X( crc32_jamcrc,      "CRC-32/JAMCRC",   CRC_32_JAMCRC_SPEC,      0x340BC6D9UL         ) \
+  X( crc32_mpeg_2,      "CRC-32/MPEG-2",   CRC_32_MPEG_2_SPEC,      0x0376E6E7UL         ) \
+  X( crc64_ecma_182,    "CRC-64/ECMA-182", CRC_64_ECMA_182_SPEC,    0x6C40DF5F0B497347UL ) \
+  X( crc64_go_iso,      "CRC-64/GO-ISO",   CRC_64_GO_ISO_SPEC,      0xB90956C775A41001UL ) \
+  X( crc64_iso,         "CRC-64/ISO",      CRC_64_ISO_SPEC,         0xE4FFBEA588933790UL ) \
+  X( crc64_we,          "CRC-64/WE",       CRC_64_WE_SPEC,          0x62EC59E3F1A4F00AUL ) \
+  X( crc64_xz,          "CRC-64/XZ",       CRC_64_XZ_SPEC,          0x995DC9BBDF1939FAUL )
 
 
 /* Map the polynomial parameters here, 
@@ -118,7 +235,12 @@
 #define CRC_8_POLY_PARAM  CRC_8_CCITT
 #define CRC_16_POLY_PARAM CRC_16_CCITT_FALSE
 #define CRC_32_POLY_PARAM CRC_32
+/* used by the SSE4.2 crc32 instruction path */
+#define CRC_32C_POLY_PARAM CRC_32_C
 #define CRC_64_POLY_PARAM CRC_64_ISO
 
-#endif /* __CRCPARAM_EVEN_H_ */
+/* CRC16 of the bitwise engine (crcbit.c), for 
+ * modes which have to reproduce its checksums */
+#define CRC_16_BITWISE_POLY_PARAM CRC_16_KERMIT
 
+#endif /* __CRCPARAM_EVEN_H_ */
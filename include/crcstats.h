@@ -0,0 +1,58 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcstats.h
+ *
+ *
+ * Purpose:   Instrumentation of the hot path (--stats).
+ *            The stages of every chunk are timed with the
+ *            monotonic clock, the hardware counters and
+ *            the resource usage are read for the run.
+ *
+ *
+ * Remarks:   - Disabled, begin and end return right away.
+ *
+ *            - Not thread safe, only the main thread
+ *              times its stages. The counters include
+ *              the threads which are started later.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#ifndef __CRC_STATS_H_
+#define __CRC_STATS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+
+#define CRC_STAGE_OPEN  0U /* open, fstat, buffers, mmap, io_uring setup */
+#define CRC_STAGE_READ  1U /* read, pread, waiting for a reader */
+#define CRC_STAGE_CRC   2U /* the crc kernel */
+#define CRC_STAGE_COUNT 3U
+
+
+/* starts the clock and the counters of the run */
+void crc_stats_enable( void );
+
+uint8_t crc_stats_enabled( void );
+
+/* start time of a stage, 0.0 if disabled */
+double crc_stats_begin( void );
+
+/* adds the time since start (crc_stats_begin) and the
+ * bytes of the chunk to the stage */
+void crc_stats_end( uint8_t stage, double start, uint64_t bytes );
+
+/* stage table, counters, peak RSS, page faults and cycles
+ * per byte of the bytes passed to CRC_STAGE_CRC */
+void crc_stats_report( FILE* out );
+
+#endif /* __CRC_STATS_H_ */
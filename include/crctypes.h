@@ -33,6 +33,17 @@
 
 #define PARAM_SPACE 16
 
+/* crc kernels known to the dispatcher */
+#define CRC_KERNEL_AUTO     0U
+#define CRC_KERNEL_BITWISE  1U
+#define CRC_KERNEL_LUT      2U
+#define CRC_KERNEL_SLICE_4  3U
+#define CRC_KERNEL_SLICE_8  4U
+#define CRC_KERNEL_SLICE_16 5U
+#define CRC_KERNEL_CLMUL    6U
+#define CRC_KERNEL_SSE42    7U
+#define CRC_KERNEL_COUNT    8U
+
 
 typedef union data
 {
@@ -0,0 +1,81 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      spsc.h
+ * 
+ *
+ * Purpose:   Lock free single producer / single
+ *            consumer ring of fixed size buffers.
+ *
+ * 
+ * Remarks:   - One thread fills buffers, another one 
+ *              drains them in the same order. Neither
+ *              side copies, both work in the ring.
+ *
+ *            - A side which finds the ring full (producer)
+ *              or empty (consumer) spins shortly and then
+ *              yields. These stalls are counted and timed,
+ *              the side which stalls more is the faster one.
+ *
+ *
+ * Date:      10/2026 
+ * 
+ */
+
+#ifndef __SPSC_H_
+#define __SPSC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SPSC_CACHE_LINE 64U
+
+
+typedef struct spsc_stats
+{
+  uint64_t producer_stalls;
+  uint64_t consumer_stalls;
+  double   producer_wait;
+  double   consumer_wait;
+
+} spsc_stats_t;
+
+
+typedef struct spsc_ring
+{
+  /* free running counters, slot = counter % depth */
+  uint32_t head __attribute__( ( aligned( SPSC_CACHE_LINE ) ) );
+  uint32_t tail __attribute__( ( aligned( SPSC_CACHE_LINE ) ) );
+
+  uint8_t* arena __attribute__( ( aligned( SPSC_CACHE_LINE ) ) );
+  int64_t* len;
+  uint8_t* last;
+  size_t   slot_size;
+  uint32_t depth;
+
+  spsc_stats_t stats;
+
+} spsc_ring_t;
+
+
+/* 0x00 if the buffers can not be allocated */
+uint8_t spsc_init( spsc_ring_t* ring, uint32_t depth, size_t slot_size );
+void spsc_free( spsc_ring_t* ring );
+
+/* producer side: waits for an empty slot, fills it and publishes
+ * it with len bytes (or a negative errno), last marks the end */
+uint8_t* spsc_produce_begin( spsc_ring_t* ring );
+void spsc_produce_commit( spsc_ring_t* ring, int64_t len, uint8_t last );
+
+/* consumer side: waits for the next filled slot, which stays 
+ * valid until it is released */
+const uint8_t* spsc_consume_begin( spsc_ring_t* ring, int64_t* len, 
+                                   uint8_t* last );
+void spsc_consume_release( spsc_ring_t* ring );
+
+#endif /* __SPSC_H_ */
@@ -0,0 +1,85 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      uring.h
+ * 
+ *
+ * Purpose:   Minimal io_uring helper on top of the
+ *            raw system calls, so there is no
+ *            dependency on liburing.
+ *
+ * 
+ * Remarks:   - uring_init returns 0x00 if the kernel
+ *              does not support io_uring (or it is
+ *              forbidden by seccomp), callers fall
+ *              back to plain reads then.
+ *
+ *
+ * Date:      10/2026 
+ * 
+ */
+
+#ifndef __URING_H_
+#define __URING_H_
+
+#include <linux/io_uring.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+
+typedef struct uring
+{
+  int ring_fd;
+
+  /* submission queue, shared with the kernel */
+  uint32_t* sq_head;
+  uint32_t* sq_tail;
+  uint32_t* sq_mask;
+  uint32_t* sq_array;
+  struct io_uring_sqe* sqes;
+
+  /* completion queue, shared with the kernel */
+  uint32_t* cq_head;
+  uint32_t* cq_tail;
+  uint32_t* cq_mask;
+  struct io_uring_cqe* cqes;
+
+  void*  sq_ring;
+  size_t sq_ring_len;
+  void*  cq_ring;
+  size_t cq_ring_len;
+  size_t sqes_len;
+
+  /* queued but not yet submitted entries */
+  uint32_t pending;
+
+} uring_t;
+
+
+uint8_t uring_init( uring_t* ring, uint32_t entries );
+void uring_exit( uring_t* ring );
+
+/* 0x00 if the buffers could not be registered */
+uint8_t uring_register_buffers( uring_t* ring, const struct iovec* iov, 
+                                uint32_t n );
+
+/* returns a zeroed entry or NULL if the queue is full */
+struct io_uring_sqe* uring_get_sqe( uring_t* ring );
+
+/* submits the queued entries and waits for at least wait_nr
+ * completions, returns a negative errno on failure */
+int uring_submit( uring_t* ring, uint32_t wait_nr );
+
+/* next completion or NULL, uring_cqe_seen releases it */
+struct io_uring_cqe* uring_peek_cqe( uring_t* ring );
+void uring_cqe_seen( uring_t* ring );
+
+#endif /* __URING_H_ */
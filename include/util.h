@@ -23,19 +23,92 @@
 #ifndef __UTIL_H_
 #define __UTIL_H_
 
+#include <crctypes.h>
+#include <spsc.h>
+
 #include <stdint.h>
 #include <sys/types.h>
 
+#define URING_MAX_QUEUE_DEPTH 256U
+#define PIPE_MAX_DEPTH        256U
+
+/* stdin as input file (-f - or a pipe without -f) */
+#define STDIN_PATH "/dev/stdin"
+
 inline void reflect_bits_8 ( uint8_t*  field, uint32_t n );
 inline void reflect_bits_16( uint16_t* field, uint32_t n );
 inline void reflect_bits_32( uint32_t* field, uint32_t n );
 inline void reflect_bits_64( uint64_t* field, uint32_t n );
 
+/* name of the vector path used by reflect_bits_* */
+const char* get_reflect_simd_name( void );
+
 void check_reflect( uint8_t* buf, uint32_t n, uint8_t reflect );
 
+/* returns the parameter field of a polynomial 
+ * with the given degree as integer value */
+uint64_t get_param_value( const data_u* field, uint8_t degree );
+
 long try_strtol( char* str );
+double get_monotonic_seconds( void );
+
+/* Reads the file in chunks of at most buf_len bytes into *buf.
+ * The buffer is sized from the file (SMALL_FILE_SIZE and
+ * POOL_BUF_SIZE of crc.h) and owned by walk_file. */
 int32_t walk_file( uint8_t** buf, ssize_t buf_len, 
                    const char* file, uint8_t* more_fragments );
 
+/* Same interface as walk_file, but the file is mapped
+ * and *buf points into the page cache (no copy). Every
+ * call hands out the next chunk of at most chunk_len
+ * bytes. The mapping is released with the call after
+ * the last chunk, which returns 0. */
+int32_t walk_file_mmap( const uint8_t** buf, ssize_t chunk_len, 
+                        const char* file, uint8_t* more_fragments );
+
+/* Same interface as walk_file_mmap. Up to queue_depth reads of 
+ * chunk_len bytes are kept in flight with io_uring into registered
+ * buffers and handed out in file order. *buf stays valid until
+ * the next call, which reuses the buffer for a read ahead. Without
+ * io_uring the chunks are read with pread. */
+int32_t walk_file_uring( const uint8_t** buf, ssize_t chunk_len, 
+                         uint32_t queue_depth, const char* file, 
+                         uint8_t* more_fragments );
+
+/* Same interface as walk_file_mmap. A reader thread fills a ring
+ * of depth buffers of chunk_len bytes ahead, while the caller 
+ * crunches the current one. *buf stays valid until the next call. */
+int32_t walk_file_pipe( const uint8_t** buf, ssize_t chunk_len, 
+                        uint32_t depth, const char* file, 
+                        uint8_t* more_fragments );
+
+/* stall counters of the last walk_file_pipe run, the reader
+ * is the producer and the caller the consumer of the ring */
+void get_walk_file_pipe_stats( spsc_stats_t* stats );
+
+/* Same interface as walk_file_mmap, but the file does not stay 
+ * in the page cache. With direct it is read with O_DIRECT into
+ * an aligned buffer, otherwise (or if the file system does not 
+ * support O_DIRECT) the pages of a chunk are dropped with 
+ * POSIX_FADV_DONTNEED once the caller is done with it. */
+int32_t walk_file_direct( const uint8_t** buf, ssize_t chunk_len, 
+                          uint8_t direct, const char* file, 
+                          uint8_t* more_fragments );
+
+/* percentage of the pages of file in the page cache, 
+ * negative if it can not be determined */
+double get_file_cache_residency( const char* file );
+
+/* 0xFF if file is not a regular file (pipe, socket, device),
+ * so its length is unknown until the end */
+uint8_t is_stream_input( const char* file );
+
+/* Same interface as walk_file_mmap for inputs of unknown length.
+ * Reads until the end of the stream, one chunk ahead, so that 
+ * more_fragments is cleared with the last chunk. STDIN_PATH 
+ * reads the stdin descriptor, which also works for sockets. */
+int32_t walk_stream( const uint8_t** buf, ssize_t chunk_len, 
+                     const char* file, uint8_t* more_fragments );
+
 #endif /* __UTIL_H_ */
 
@@ -39,9 +39,6 @@ static inline int8_t gcc_builtin_bitcount( uint64_t n );
 static inline int8_t parallel_bitcount( uint64_t n );
 
 
-static int8_t ( *bitcount_func )( uint64_t ) = &gcc_builtin_bitcount;
-
-
 uint32_t get_hamming_distance( const uint8_t* field_a, 
                                const uint8_t* field_b, uint16_t len )
 {
@@ -112,6 +109,6 @@ uint8_t get_hamming_distance_opt( uint64_t field_a, uint64_t field_b )
 {
   uint64_t cur_xor;
   cur_xor = field_a ^ field_b;
-  return ( uint8_t )bitcount_func( cur_xor );
+  return ( uint8_t )gcc_builtin_bitcount( cur_xor );
 }
 
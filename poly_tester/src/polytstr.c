@@ -35,12 +35,10 @@
  */
 
 #include <crctypes.h>
-#include <crcparam_even.h>
-#include <crcapi.h>
+#include <crcmodel.h>
+#include <crcinline.h>
 #include <hamming.h>
 
-#include <sys/sysinfo.h>
-
 #include <pthread.h>
 #include <assert.h>
 #include <mtimer.h>
@@ -80,6 +78,16 @@ typedef union
 }
 crc_input_t;
 
+/* first_inputs is only kept for the partial results,
+ * it joins the ranges of the threads when conflating. */
+typedef struct
+{
+  uint64_t checksum_counts[ POSSIBLE_CRC_16_SUMS ];
+  crc_input_t first_inputs[ POSSIBLE_CRC_16_SUMS ];
+  crc_input_t last_inputs[ POSSIBLE_CRC_16_SUMS ];
+}
+crc_16_results_t;
+
 typedef struct
 {
   uint64_t         start;
@@ -89,13 +97,6 @@ typedef struct
 }
 thread_params_t;
 
-typedef struct
-{
-  uint64_t checksum_counts[ POSSIBLE_CRC_16_SUMS ];
-  crc_input_t last_inputs[ POSSIBLE_CRC_16_SUMS ];
-}
-crc_16_results_t;
-
 typedef struct
 {
   crc_input_t input;
@@ -106,15 +107,27 @@ crc_16_pair_t;
 
 /* module local variables of this module. */
 
-static void ( *crc_16_algorithm_func )( uint8_t*, const uint32_t, 
-                                        const crc_param_t*, 
-                                        uint16_t*, uint8_t, uint8_t ) = NULL;
+/* Kernel of crcmodel.h which is specialized for the
+ * polynomial under test, called directly by the workers. */
+#define CRC_16_KERNEL crc16_ccitt_false
+/* #define CRC_16_KERNEL crc16_kermit */
+/* #define CRC_16_KERNEL crc16_shitty */
+
+/* CRC-16/SHITTY is only a test polynomial and not in the
+ * catalogue, so its kernel is stamped out here. The extra
+ * level expands the spec into its six arguments. */
+#define CRC_16_TEST_MODEL( spec ) \
+  CRC_INLINE_MODEL( CRC_INLINE, crc16_shitty, crc16_shitty_lut, spec )
+
+static const crc_param_t crc16_shitty_params = CRC_16_SHITTY;
+
+/* slice 0 as crctabgen writes it, built by init */
+static uint64_t crc16_shitty_lut[ 0x100U ] = { 0x0000000000000000UL };
 
-static crc_param_t crc_params = CRC_16_CCITT_FALSE;
-/* static crc_param_t crc_params = CRC_16_KERMIT; */
-/* static crc_param_t crc_params = CRC_16_SHITTY; */
+CRC_16_TEST_MODEL( CRC_16_SHITTY_SPEC )
 
 static crc_16_results_t results_16 = { { 0x0000000000000000UL }, 
+                                       { { 0x0000000000000000UL } },
                                        { { 0x0000000000000000UL } } };
 
 static pthread_t threads[ NUM_THREADS ];
@@ -143,6 +156,7 @@ static FILE* open_file( const char* path );
 static void close_file( FILE* file );
 
 static void init( void );
+static void init_crc16_shitty_lut( void );
 static void deinit( void );
 static void create_thread_params( uint8_t num_threads, 
                                   uint64_t num_inputs );
@@ -154,15 +168,20 @@ static void join_threads( void );
 static void synchronize_results( uint32_t tid, uint32_t num_results );
 static void conflate_partial_results( void );
 
-static uint64_t get_machine_total_ram( void );
 
 /* *~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~*~ */
 
 
+/* The threads crunch adjacent input ranges in the order of
+ * their ids, so the partial results are conflated in that
+ * order. A checksum which was already seen in a lower range
+ * adds the hamming distance between its last input there and
+ * its first input in the current range. */
 static void conflate_partial_results( void )
 {
   uint8_t i;
   uint32_t j;
+  uint32_t k;
   crc_16_results_t* partial_results = NULL;
   uint64_t* partial_hamming_dists = NULL;
   uint32_t hamming_dist;
@@ -172,25 +191,29 @@ static void conflate_partial_results( void )
     partial_results       = &thread_params[ i ].partial_results;
     partial_hamming_dists = &thread_params[ i ].partial_hamming_dists[ 0U ];
 
-    if( !i )
+    for( k = 0U; k < HAMMING_DIST_SPACE; k++ )
     {
-      for( j )
-      results_16.checksum_counts
+      hamming_dists[ k ] += partial_hamming_dists[ k ];
     }
 
-
-
-    if( results_16.checksum_counts[ cur_pair->crc16 ] )
-
-
-
     for( j = 0U; j < POSSIBLE_CRC_16_SUMS; j++ )
     {
+      if( !partial_results->checksum_counts[ j ] )
+      {
+        continue;
+      }
+
       if( results_16.checksum_counts[ j ] )
       {
+        hamming_dist = ( uint32_t )get_hamming_distance_opt( 
+                                     results_16.last_inputs[ j ].u_64,
+                                     partial_results->first_inputs[ j ].u_64 );
+        hamming_dists[ hamming_dist ]++;
       }
-    }
 
+      results_16.checksum_counts[ j ] += partial_results->checksum_counts[ j ];
+      results_16.last_inputs[ j ] = partial_results->last_inputs[ j ];
+    }
   }
 }
 
@@ -223,6 +246,10 @@ static void synchronize_results( uint32_t tid, uint32_t num_results )
       add_hamming_dist = 0xFFU;
       temp_last = partial_results->last_inputs[ cur_pair->crc16 ];
     }
+    else
+    {
+      partial_results->first_inputs[ cur_pair->crc16 ].u_64 = cur_pair->input.u_64;
+    }
     partial_results->checksum_counts[ cur_pair->crc16 ]++;
     partial_results->last_inputs[ cur_pair->crc16 ].u_64 = cur_pair->input.u_64;
 
@@ -257,11 +284,8 @@ static void* crc_16_worker( void* arg )
        crc_input.u_64++ )
   {
     crc_input_loop = crc_input;
-    crc_16_algorithm_func( &crc_input_loop.u_8_arr[ 0U ], 
-                           ( const uint32_t )NUM_INPUT_BYTES,
-                           ( const crc_param_t* )&crc_params, &crc16,
-                           0xFFU,   /* First call, yes */
-                           0x00U ); /* More fragments, no */
+    crc16 = ( uint16_t )CRC_16_KERNEL( &crc_input_loop.u_8_arr[ 0U ], 
+                                       ( size_t )NUM_INPUT_BYTES );
 
     cur_pair = ( buf + t_buf_idx );
 
@@ -274,8 +298,6 @@ static void* crc_16_worker( void* arg )
       synchronize_results( tid, t_buf_idx );
       t_buf_idx = 0U;
     }
-
-    crc16 = 0x0000U;
   }
 
   /* synchronize remaining results if there are any */
@@ -288,18 +310,43 @@ static void* crc_16_worker( void* arg )
 }
 
 
+/* reflected and right aligned for refin, otherwise left aligned */
+static void init_crc16_shitty_lut( void )
+{
+  const crc_param_t* p = &crc16_shitty_params;
+  uint64_t reg, poly;
+  uint16_t i;
+  uint8_t j;
+
+  poly = p->reflect_input ? crc_inline_reflect( p->coeff.u_64, p->degree ) :
+                            p->coeff.u_64 << ( 64U - p->degree );
+
+  for( i = 0U; i < 0x100U; i++ )
+  {
+    reg = p->reflect_input ? ( uint64_t )i : ( uint64_t )i << 56U;
+    for( j = 0U; j < 8U; j++ )
+    {
+      if( p->reflect_input )
+      {
+        reg = ( reg & 1UL ) ? ( reg >> 1U ) ^ poly : ( reg >> 1U );
+      }
+      else
+      {
+        reg = ( reg & 0x8000000000000000UL ) ? ( reg << 1U ) ^ poly : ( reg << 1U );
+      }
+    }
+    crc16_shitty_lut[ i ] = reg;
+  }
+}
+
+
 static void init( void )
 {
   uint8_t i;
 
-  create_thread_params( NUM_THREADS, NUM_INPUTS );
+  init_crc16_shitty_lut();
 
-  /* Function from the crc library gets assigned here.
-   * We use the lookup based crc calculation due to
-   * performance reasons. */
-  crc_16_algorithm_func = &crc16_algorithm_lut;
-  /* Lookup table has to be initialized. */
-  init_lut_crc_16( ( const crc_param_t* )&crc_params );
+  create_thread_params( NUM_THREADS, NUM_INPUTS );
 
   /* initialize thread buffers */
   for( i = 0U; i < NUM_THREADS; i++ )
@@ -498,22 +545,6 @@ static void close_file( FILE* file )
 }
 
 
-static uint64_t get_machine_total_ram( void )
-{
-  /*
-   * This function returns the total usable
-   * main memory size given in bytes.
-   * */
-  uint64_t total_ram;
-  struct sysinfo info;
-  
-  ( void )sysinfo( &info );
-  total_ram = ( uint64_t )info.totalram;
-
-  return total_ram;
-}
-
-
 static void write_number_as_line( uint64_t number, FILE* file )
 {
   char text[ STRING_BUF ] = { 0x00 };
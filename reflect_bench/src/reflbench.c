@@ -0,0 +1,171 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      reflbench.c
+ *
+ *
+ * Purpose:   This program compares the bulk bit reflection
+ *            of the crc library (reflect_bits_8) against
+ *            the former mask and shift implementation.
+ *            The throughput is reported in bytes per
+ *            cycle for buffers from 64 B up to 64 MiB.
+ *
+ *
+ * Remarks:   - This program requires the crc library,
+ *              which does not reside in the gcc stdlibs.
+ *
+ *            - The cycles are taken from the time stamp
+ *              counter, which ticks with the nominal clock
+ *              on most recent cpus. Turbo and power saving
+ *              states shift the numbers a bit.
+ *
+ *            - Every size crunches about REPEAT_BYTES
+ *              in total, so small buffers stay in cache.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <util.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined( __x86_64__ )
+#include <x86intrin.h>
+#endif
+
+#define MIN_SIZE     64UL
+#define MAX_SIZE     ( 64UL * 1024UL * 1024UL )
+#define REPEAT_BYTES ( 256UL * 1024UL * 1024UL )
+
+
+static uint64_t get_cycles( void );
+static void reflect_bits_8_former( uint8_t* field, uint32_t n );
+static double measure( void ( *func )( uint8_t*, uint32_t ),
+                       uint8_t* buf, uint32_t len );
+
+
+static uint64_t get_cycles( void )
+{
+#if defined( __x86_64__ )
+  return ( uint64_t )__rdtsc();
+#else
+  /* no time stamp counter, nanoseconds instead */
+  return ( uint64_t )( get_monotonic_seconds() * 1e9 );
+#endif
+}
+
+
+/* the mask and shift chain the library used before */
+static void reflect_bits_8_former( uint8_t* field, uint32_t n )
+{
+  uint32_t i;
+  uint8_t b;
+
+  for( i = 0; i < n; i++ )
+  {
+    b = *( field + i );
+    b = ( ( b & 0x80U ) >> 7U ) | ( ( b & 0x01U ) << 7U ) |
+        ( ( b & 0x40U ) >> 5U ) | ( ( b & 0x02U ) << 5U ) |
+        ( ( b & 0x20U ) >> 3U ) | ( ( b & 0x04U ) << 3U ) |
+        ( ( b & 0x10U ) >> 1U ) | ( ( b & 0x08U ) << 1U ) ;
+    *( field + i ) = b;
+  }
+}
+
+
+/* returns bytes per cycle */
+static double measure( void ( *func )( uint8_t*, uint32_t ),
+                       uint8_t* buf, uint32_t len )
+{
+  uint64_t rounds, r;
+  uint64_t start, cycles;
+
+  rounds = REPEAT_BYTES / len;
+  if( !rounds )
+  {
+    rounds = 1UL;
+  }
+
+  /* warm up caches and page tables */
+  func( buf, len );
+
+  start = get_cycles();
+  for( r = 0UL; r < rounds; r++ )
+  {
+    func( buf, len );
+  }
+  cycles = get_cycles() - start;
+
+  if( !cycles )
+  {
+    cycles = 1UL;
+  }
+
+  return ( double )( rounds * len ) / ( double )cycles;
+}
+
+
+int main( void )
+{
+  uint8_t* buf;
+  uint8_t* ref;
+  uint64_t size, i;
+  double former, current;
+
+  buf = ( uint8_t* )malloc( MAX_SIZE * sizeof( uint8_t ) );
+  ref = ( uint8_t* )malloc( MAX_SIZE * sizeof( uint8_t ) );
+  if( !buf || !ref )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    free( buf );
+    free( ref );
+    exit( EXIT_FAILURE );
+  }
+
+  srand( 42U );
+  for( i = 0UL; i < MAX_SIZE; i++ )
+  {
+    *( buf + i ) = ( uint8_t )rand();
+  }
+  ( void )memcpy( ( void* )ref, ( const void* )buf, MAX_SIZE );
+
+  /* both implementations have to agree, odd length for the tail */
+  reflect_bits_8( buf, ( uint32_t )( MAX_SIZE - 3UL ) );
+  reflect_bits_8_former( ref, ( uint32_t )( MAX_SIZE - 3UL ) );
+  if( memcmp( ( const void* )buf, ( const void* )ref, MAX_SIZE ) )
+  {
+    ( void )fprintf( stderr, "The reflected buffers differ.\n" );
+    free( buf );
+    free( ref );
+    exit( EXIT_FAILURE );
+  }
+
+  ( void )fprintf( stdout, "Vector path: %s\n", get_reflect_simd_name() );
+  ( void )fprintf( stdout, "%10s %14s %14s %9s\n",
+                           "bytes", "former B/cyc", "current B/cyc", "speedup" );
+
+  for( size = MIN_SIZE; size <= MAX_SIZE; size <<= 2U )
+  {
+    former  = measure( &reflect_bits_8_former, buf, ( uint32_t )size );
+    current = measure( &reflect_bits_8, buf, ( uint32_t )size );
+
+    ( void )fprintf( stdout, "%10lu %14.3f %14.3f %8.2fx\n",
+                             size, former, current, current / former );
+  }
+
+  free( buf );
+  free( ref );
+
+  return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,576 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcbatch.c
+ *
+ *
+ * Purpose:   This module holds the multi-buffer api,
+ *            the checksums of many independent short
+ *            messages with one parameter set.
+ *
+ *
+ * Remarks:   - A single slicing by 8 stream waits for its
+ *              table lookups, the next step needs the
+ *              register of the step before. CRC_BATCH_LANES
+ *              messages are crunched interleaved, so the
+ *              lookups of the lanes overlap.
+ *
+ *            - A lane whose message is done is refilled with
+ *              the next one right away, messages of different
+ *              lengths keep all the lanes busy. The last
+ *              messages are finished one by one.
+ *
+ *            - CRC-32C goes through the crc32 instruction of
+ *              SSE4.2 if the cpu has it, its latency of three
+ *              cycles is hidden by the lanes as well.
+ *
+ *            - The other models are folded with carry-less
+ *              multiplication if the cpu has it, 16 bytes
+ *              per step and lane (crc_clmul_lanes). Only the
+ *              last bytes of a message go through the tables.
+ *
+ *            - Everything which depends on the parameter set
+ *              (tables, orientation of the register, xor
+ *              values) is done in crc_batch_init, not per
+ *              message.
+ *
+ *            - The registers are kept in the orientation of
+ *              the tables: reflected and right aligned for
+ *              reflected input, left aligned otherwise.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crctypes.h>
+#include <crcapi.h>
+#include <crckernel.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#if defined( __x86_64__ )
+#define SSE42_AVAILABLE
+#include <immintrin.h>
+#define SSE42_TARGET __attribute__( ( target( "sse4.2" ) ) )
+#endif
+
+
+#define REGISTER_BITS 64U
+
+/* bytes per step of a lane */
+#define WORD_BYTES  8U
+#define BLOCK_BYTES 16U
+
+/* shorter messages of a single lane go through the tables */
+#define CLMUL_MIN_BYTES 64U
+
+#define BATCH_REFLECTED 0U
+#define BATCH_NORMAL    1U
+#define BATCH_SSE42     2U
+#define BATCH_CLMUL     3U
+
+
+struct crc_batch
+{
+  crc_param_t params;
+
+  uint8_t  kernel;
+  uint8_t  shift;
+
+  /* bytes per step of the lanes */
+  uint8_t  step;
+
+  /* the register is reflected (reflected input) */
+  uint8_t  reflected;
+
+  /* the checksum is the register reflected */
+  uint8_t  reflect;
+
+  /* start register in the orientation of the tables */
+  uint64_t initial;
+  uint64_t final;
+
+  /* generated tables or the ones below */
+  const crc_lut_tables_t* lut;
+
+  crc_lut_tables_t tables;
+
+  crc_clmul_consts_t consts;
+};
+
+
+/* the lanes of crc_batch */
+typedef struct batch_lanes
+{
+  uint64_t       reg[ CRC_BATCH_LANES ];
+  uint64_t       acc[ CRC_BATCH_LANES ][ 2 ];
+  const uint8_t* p[ CRC_BATCH_LANES ];
+  size_t         left[ CRC_BATCH_LANES ];
+  size_t         slot[ CRC_BATCH_LANES ];
+
+  /* the register is in acc */
+  uint8_t        folding[ CRC_BATCH_LANES ];
+
+} batch_lanes_t;
+
+
+static inline uint64_t step_reflected( const uint64_t ( *lut )[ 0x100U ],
+                                       uint64_t crc, const uint8_t* data );
+static inline uint64_t step_normal( const uint64_t ( *lut )[ 0x100U ],
+                                    uint64_t crc, const uint8_t* data );
+static void lanes_reflected( const uint64_t ( *lut )[ 0x100U ], uint64_t* reg,
+                             const uint8_t** data, size_t words );
+static void lanes_normal( const uint64_t ( *lut )[ 0x100U ], uint64_t* reg,
+                          const uint8_t** data, size_t words );
+static uint64_t crunch_one( const crc_batch_t* batch, uint64_t crc,
+                            const uint8_t* data, size_t len );
+static uint64_t finish_crc( const crc_batch_t* batch, uint64_t crc );
+static void start_lane( const crc_batch_t* batch, batch_lanes_t* lanes, uint8_t l,
+                        const uint8_t* data, size_t len, size_t slot );
+static uint64_t finish_lane( const crc_batch_t* batch, const batch_lanes_t* lanes,
+                             uint8_t l );
+
+#ifdef SSE42_AVAILABLE
+SSE42_TARGET static void lanes_sse42( uint64_t* reg, const uint8_t** data, size_t words );
+SSE42_TARGET static uint64_t crunch_one_sse42( uint64_t crc, const uint8_t* data, size_t len );
+#endif
+
+crc_batch_t* crc_batch_init( const crc_param_t* crc_params );
+void crc_batch( const crc_batch_t* batch, const uint8_t* const* data,
+                const size_t* len, size_t count, uint64_t* crcs );
+void crc_batch_free( crc_batch_t* batch );
+
+
+/* Eight bytes, the first one meets the low byte of the register.
+ * The word is loaded in one go, the lookups are the only other
+ * loads (little endian host, as the crc_param_t fields). */
+static inline uint64_t step_reflected( const uint64_t ( *lut )[ 0x100U ],
+                                       uint64_t crc, const uint8_t* data )
+{
+  uint64_t word;
+
+  ( void )memcpy( ( void* )&word, ( const void* )data, sizeof( word ) );
+  word ^= crc;
+
+  return lut[ 7U ][ word & 0xFFU ] ^
+         lut[ 6U ][ ( word >> 8U ) & 0xFFU ] ^
+         lut[ 5U ][ ( word >> 16U ) & 0xFFU ] ^
+         lut[ 4U ][ ( word >> 24U ) & 0xFFU ] ^
+         lut[ 3U ][ ( word >> 32U ) & 0xFFU ] ^
+         lut[ 2U ][ ( word >> 40U ) & 0xFFU ] ^
+         lut[ 1U ][ ( word >> 48U ) & 0xFFU ] ^
+         lut[ 0U ][ word >> 56U ];
+}
+
+
+/* eight bytes, the first one meets the top byte of the register */
+static inline uint64_t step_normal( const uint64_t ( *lut )[ 0x100U ],
+                                    uint64_t crc, const uint8_t* data )
+{
+  uint64_t word;
+
+  ( void )memcpy( ( void* )&word, ( const void* )data, sizeof( word ) );
+  word = __builtin_bswap64( word ) ^ crc;
+
+  return lut[ 7U ][ word >> 56U ] ^
+         lut[ 6U ][ ( word >> 48U ) & 0xFFU ] ^
+         lut[ 5U ][ ( word >> 40U ) & 0xFFU ] ^
+         lut[ 4U ][ ( word >> 32U ) & 0xFFU ] ^
+         lut[ 3U ][ ( word >> 24U ) & 0xFFU ] ^
+         lut[ 2U ][ ( word >> 16U ) & 0xFFU ] ^
+         lut[ 1U ][ ( word >> 8U ) & 0xFFU ] ^
+         lut[ 0U ][ word & 0xFFU ];
+}
+
+
+/* The lanes are copied into locals, the compiler keeps them
+ * in registers and interleaves the steps of the unrolled loop. */
+static void lanes_reflected( const uint64_t ( *lut )[ 0x100U ], uint64_t* reg,
+                             const uint8_t** data, size_t words )
+{
+  uint64_t r[ CRC_BATCH_LANES ];
+  const uint8_t* p[ CRC_BATCH_LANES ];
+  uint8_t l;
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    r[ l ] = reg[ l ];
+    p[ l ] = data[ l ];
+  }
+
+  while( words-- )
+  {
+    for( l = 0U; l < CRC_BATCH_LANES; l++ )
+    {
+      r[ l ] = step_reflected( lut, r[ l ], p[ l ] );
+      p[ l ] += WORD_BYTES;
+    }
+  }
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    reg[ l ]  = r[ l ];
+    data[ l ] = p[ l ];
+  }
+}
+
+
+static void lanes_normal( const uint64_t ( *lut )[ 0x100U ], uint64_t* reg,
+                          const uint8_t** data, size_t words )
+{
+  uint64_t r[ CRC_BATCH_LANES ];
+  const uint8_t* p[ CRC_BATCH_LANES ];
+  uint8_t l;
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    r[ l ] = reg[ l ];
+    p[ l ] = data[ l ];
+  }
+
+  while( words-- )
+  {
+    for( l = 0U; l < CRC_BATCH_LANES; l++ )
+    {
+      r[ l ] = step_normal( lut, r[ l ], p[ l ] );
+      p[ l ] += WORD_BYTES;
+    }
+  }
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    reg[ l ]  = r[ l ];
+    data[ l ] = p[ l ];
+  }
+}
+
+
+#ifdef SSE42_AVAILABLE
+SSE42_TARGET static void lanes_sse42( uint64_t* reg, const uint8_t** data, size_t words )
+{
+  uint64_t r[ CRC_BATCH_LANES ];
+  const uint8_t* p[ CRC_BATCH_LANES ];
+  uint64_t word;
+  uint8_t l;
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    r[ l ] = reg[ l ];
+    p[ l ] = data[ l ];
+  }
+
+  while( words-- )
+  {
+    for( l = 0U; l < CRC_BATCH_LANES; l++ )
+    {
+      ( void )memcpy( ( void* )&word, ( const void* )p[ l ], sizeof( word ) );
+      r[ l ] = ( uint64_t )_mm_crc32_u64( r[ l ], word );
+      p[ l ] += WORD_BYTES;
+    }
+  }
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    reg[ l ]  = r[ l ];
+    data[ l ] = p[ l ];
+  }
+}
+
+
+SSE42_TARGET static uint64_t crunch_one_sse42( uint64_t crc, const uint8_t* data, size_t len )
+{
+  uint64_t word;
+
+  while( len >= WORD_BYTES )
+  {
+    ( void )memcpy( ( void* )&word, ( const void* )data, sizeof( word ) );
+    crc   = ( uint64_t )_mm_crc32_u64( crc, word );
+    data += WORD_BYTES;
+    len  -= WORD_BYTES;
+  }
+
+  while( len-- )
+  {
+    crc = ( uint64_t )_mm_crc32_u8( ( uint32_t )crc, *data++ );
+  }
+  return crc;
+}
+#endif
+
+
+/* a single lane, for the rest of a message and the last messages */
+static uint64_t crunch_one( const crc_batch_t* batch, uint64_t crc,
+                            const uint8_t* data, size_t len )
+{
+  const uint64_t ( *lut )[ 0x100U ] = batch->lut->slice;
+
+#ifdef SSE42_AVAILABLE
+  if( batch->kernel == BATCH_SSE42 )
+  {
+    return crunch_one_sse42( crc, data, len );
+  }
+#endif
+
+  if( ( batch->kernel == BATCH_CLMUL ) && ( len >= CLMUL_MIN_BYTES ) )
+  {
+    /* the fold takes and returns the plain register */
+    if( batch->reflected )
+    {
+      reflect_bits_64( &crc, 1U );
+    }
+    crc >>= batch->shift;
+    crc = crc_clmul_update( &batch->consts, &batch->params, crc, data, len );
+    crc <<= batch->shift;
+    if( batch->reflected )
+    {
+      reflect_bits_64( &crc, 1U );
+    }
+    return crc;
+  }
+
+  if( batch->reflected )
+  {
+    for( ; len >= WORD_BYTES; len -= WORD_BYTES, data += WORD_BYTES )
+    {
+      crc = step_reflected( lut, crc, data );
+    }
+    while( len-- )
+    {
+      crc = ( crc >> 8U ) ^ lut[ 0U ][ ( ( uint8_t )crc ) ^ *data++ ];
+    }
+    return crc;
+  }
+
+  for( ; len >= WORD_BYTES; len -= WORD_BYTES, data += WORD_BYTES )
+  {
+    crc = step_normal( lut, crc, data );
+  }
+  while( len-- )
+  {
+    crc = ( crc << 8U ) ^ lut[ 0U ][ ( ( uint8_t )( crc >> 56U ) ) ^ *data++ ];
+  }
+  return crc;
+}
+
+
+/* register in the orientation of the tables to the checksum,
+ * the final xor comes after the reflection (Rocksoft model) */
+static uint64_t finish_crc( const crc_batch_t* batch, uint64_t crc )
+{
+  if( !batch->reflected )
+  {
+    crc >>= batch->shift;
+  }
+  if( batch->reflect )
+  {
+    reflect_bits_64( &crc, 1U );
+    crc >>= batch->shift;
+  }
+  return crc ^ batch->final;
+}
+
+
+static void start_lane( const crc_batch_t* batch, batch_lanes_t* lanes, uint8_t l,
+                        const uint8_t* data, size_t len, size_t slot )
+{
+  lanes->reg[ l ]     = batch->initial;
+  lanes->p[ l ]       = data;
+  lanes->left[ l ]    = len;
+  lanes->slot[ l ]    = slot;
+  lanes->folding[ l ] = 0x00U;
+
+  if( ( batch->kernel == BATCH_CLMUL ) && ( len >= BLOCK_BYTES ) )
+  {
+    crc_clmul_lane_start( lanes->acc[ l ], batch->reflected, batch->initial, data );
+    lanes->p[ l ]       += BLOCK_BYTES;
+    lanes->left[ l ]    -= BLOCK_BYTES;
+    lanes->folding[ l ]  = 0xFFU;
+  }
+}
+
+
+/* checksum of the message in lane l, the rest goes through the tables */
+static uint64_t finish_lane( const crc_batch_t* batch, const batch_lanes_t* lanes,
+                             uint8_t l )
+{
+  uint64_t crc = lanes->reg[ l ];
+
+  if( lanes->folding[ l ] )
+  {
+    crc = crc_clmul_lane_finish( &batch->consts, batch->reflected, lanes->acc[ l ] );
+  }
+  return finish_crc( batch, crunch_one( batch, crc, lanes->p[ l ], lanes->left[ l ] ) );
+}
+
+
+crc_batch_t* crc_batch_init( const crc_param_t* crc_params )
+{
+  crc_batch_t* batch = NULL;
+  uint64_t initial;
+
+  if( !crc_params->degree || ( crc_params->degree > REGISTER_BITS ) )
+  {
+    ( void )fprintf( stderr, "Unsupported polynomial degree: %d\n",
+                             crc_params->degree );
+    return NULL;
+  }
+
+  if( !( batch = ( crc_batch_t* )malloc( sizeof( crc_batch_t ) ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate a crc batch.\n" );
+    return NULL;
+  }
+
+  batch->params    = *crc_params;
+  batch->shift     = ( uint8_t )( REGISTER_BITS - crc_params->degree );
+  batch->final     = get_param_value( &crc_params->final_xor, crc_params->degree );
+  batch->kernel    = crc_params->reflect_input ? BATCH_REFLECTED : BATCH_NORMAL;
+  batch->step      = WORD_BYTES;
+  batch->reflected = crc_params->reflect_input ? 0xFFU : 0x00U;
+  batch->reflect   = ( !crc_params->reflect_input != !crc_params->reflect_remainder ) ?
+                     0xFFU : 0x00U;
+
+  if( crc_kernel_supported( CRC_KERNEL_CLMUL, crc_params ) )
+  {
+    batch->kernel = BATCH_CLMUL;
+    batch->step   = BLOCK_BYTES;
+    crc_clmul_build( &batch->consts, crc_params );
+  }
+
+#ifdef SSE42_AVAILABLE
+  if( crc_kernel_supported( CRC_KERNEL_SSE42, crc_params ) )
+  {
+    batch->kernel = BATCH_SSE42;
+    batch->step   = WORD_BYTES;
+  }
+#endif
+
+  initial = get_param_value( &crc_params->initial_xor, crc_params->degree );
+  if( crc_params->reflect_input )
+  {
+    reflect_bits_64( &initial, 1U );
+    batch->initial = initial >> batch->shift;
+  }
+  else
+  {
+    batch->initial = initial << batch->shift;
+  }
+
+  if( !( batch->lut = crc_lut_find( crc_params ) ) )
+  {
+    crc_lut_build( &batch->tables, crc_params, WORD_BYTES );
+    batch->lut = ( const crc_lut_tables_t* )&batch->tables;
+  }
+
+  return batch;
+}
+
+
+void crc_batch( const crc_batch_t* batch, const uint8_t* const* data,
+                const size_t* len, size_t count, uint64_t* crcs )
+{
+  batch_lanes_t lanes;
+  uint8_t busy[ CRC_BATCH_LANES ];
+  uint8_t full;
+  size_t next = 0U;
+  size_t steps;
+  uint8_t l;
+
+  full = ( count >= CRC_BATCH_LANES ) ? 0xFFU : 0x00U;
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    busy[ l ] = full;
+    if( full )
+    {
+      start_lane( batch, &lanes, l, data[ next ], len[ next ], next );
+      next++;
+    }
+  }
+
+  while( full )
+  {
+    steps = lanes.left[ 0U ];
+    for( l = 1U; l < CRC_BATCH_LANES; l++ )
+    {
+      if( lanes.left[ l ] < steps )
+      {
+        steps = lanes.left[ l ];
+      }
+    }
+    steps /= batch->step;
+
+    if( steps )
+    {
+      switch( batch->kernel )
+      {
+#ifdef SSE42_AVAILABLE
+        case BATCH_SSE42:
+          lanes_sse42( lanes.reg, lanes.p, steps );
+          break;
+#endif
+        case BATCH_CLMUL:
+          crc_clmul_lanes( &batch->consts, batch->reflected, lanes.acc, lanes.p, steps );
+          break;
+        case BATCH_REFLECTED:
+          lanes_reflected( batch->lut->slice, lanes.reg, lanes.p, steps );
+          break;
+        default:
+          lanes_normal( batch->lut->slice, lanes.reg, lanes.p, steps );
+          break;
+      }
+      for( l = 0U; l < CRC_BATCH_LANES; l++ )
+      {
+        lanes.left[ l ] -= steps * batch->step;
+      }
+    }
+
+    /* lanes with less than a step left are done and refilled */
+    for( l = 0U; full && ( l < CRC_BATCH_LANES ); l++ )
+    {
+      while( lanes.left[ l ] < batch->step )
+      {
+        crcs[ lanes.slot[ l ] ] = finish_lane( batch, &lanes, l );
+        if( next == count )
+        {
+          busy[ l ] = 0x00U;
+          full      = 0x00U;
+          break;
+        }
+        start_lane( batch, &lanes, l, data[ next ], len[ next ], next );
+        next++;
+      }
+    }
+  }
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    if( busy[ l ] )
+    {
+      crcs[ lanes.slot[ l ] ] = finish_lane( batch, &lanes, l );
+    }
+  }
+
+  for( ; next < count; next++ )
+  {
+    crcs[ next ] = finish_crc( batch, crunch_one( batch, batch->initial,
+                                                  data[ next ], len[ next ] ) );
+  }
+}
+
+
+void crc_batch_free( crc_batch_t* batch )
+{
+  free( batch );
+}
@@ -14,17 +14,32 @@
  *            CRC checksums bitwise.
  *
  * 
- * Remarks:   - By now CRC32 polynomials are
- *              tested and fully functional.
+ * Remarks:   - The program crunches the input
+ *              streams bit by bit. It is the
+ *              reference for the table driven
+ *              and vectorized kernels.
  *
- *            - The program crunches the input
- *              streams bit by bit. This
- *              can be optimized for example
- *              with a lookup table.
- *              A feature that should be
- *              implemented as soon as
- *              all the planned polynomials
- *              are tested and functional.
+ *            - The register is a 64 bit word, which
+ *              is left aligned for every polynomial
+ *              degree from 1 up to 64. Reflected input
+ *              is shifted in LSB first with a mirrored
+ *              and right aligned register instead. So
+ *              the memory does not depend on the degree
+ *              and the input is never written.
+ *
+ *            - The parameter sets are the models of
+ *              crcparam_even.h (the spec tuples of
+ *              CRC_MODEL_LIST), unless a model was set
+ *              with set_bitwise_params.
+ *
+ *            - The input is read in chunks of
+ *              BIT_BUF_SIZE, streams of unknown
+ *              length (pipes, sockets) too.
+ *
+ *            - calculate_crc_bitwise crunches a buffer
+ *              with the same register, the differential
+ *              fuzzer (crc_fuzz) checks every kernel
+ *              against it.
  *
  *
  * Date:      09/2017 
@@ -33,341 +48,292 @@
 
 #include <crctypes.h>
 #include <crc.h>
-#include <crcparam_odd.h>
+#include <crcparam_even.h>
 #include <crcbit.h>
+#include <crcstats.h>
 #include <util.h>
 
 #include <stdint.h>
 #include <stdlib.h>
-#include <unistd.h>
-#include <string.h>
-#include <errno.h>
 #include <stdio.h>
 
 #include <sys/types.h>
-#include <sys/stat.h>
-#include <fcntl.h>
 
-#define BYTES_TO_BIT   8UL
-#define RIGHT_MOST_BIT 0x01U
-#define LEFT_MOST_BIT  0x80U
-#define MODULO_8_MASK  0x0000000000000007UL
+#define BYTES_TO_BIT       8U
+#define TOP_BIT            0x8000000000000000UL
+#define BYTES_TO_MEGABYTES ( 1.0 / ( 1024.0 * 1024.0 ) )
 
 
 static crc_param_t polynomial_3  = CRC_3_POLY_PARAM;
 static crc_param_t polynomial_8  = CRC_8_POLY_PARAM;
-static crc_param_t polynomial_16 = CRC_16_POLY_PARAM;
+static crc_param_t polynomial_16 = CRC_16_BITWISE_POLY_PARAM;
 static crc_param_t polynomial_32 = CRC_32_POLY_PARAM;
 static crc_param_t polynomial_64 = CRC_64_POLY_PARAM;
 
-static crc_param_t polynomial;
+/* model set with set_bitwise_params, replaces the defaults */
+static crc_param_t custom_polynomial;
+static uint8_t     custom_set = 0x00U;
 
+/* 0 picks BIT_BUF_SIZE */
+static size_t chunk_size = 0U;
 
-static void init_polynomial_odd( uint8_t degree );
-static void free_resources( int fd, void* file_buf, void* poly_buf );
 
-static void 
-crunch( uint8_t* file_buf, uint8_t* poly_buf, 
-        uint32_t bytes_to_process, uint8_t poly_bytes, 
-        uint8_t** remainder );
+static const crc_param_t* get_polynomial( uint8_t degree );
 
-static inline void shift_one_right( uint8_t* field, uint8_t overflows );
+static uint64_t crunch( uint64_t reg, uint64_t poly, 
+                        const uint8_t* data, uint32_t len );
+static uint64_t crunch_reflected( uint64_t reg, uint64_t poly, 
+                                  const uint8_t* data, uint32_t len );
 
+static void load_model( const crc_param_t* crc_params, uint8_t shift,
+                        uint64_t* poly, uint64_t* reg, uint64_t* final );
+static uint64_t unload_register( uint64_t reg, uint8_t shift, uint8_t refin,
+                                 uint8_t refout, uint64_t final );
+
+static int32_t read_chunk( uint8_t** buf, const uint8_t** data, 
+                           uint8_t stream_input, const char* file, 
+                           uint8_t* more_fragments );
 static void print_crc_checksum( FILE* out, uint8_t checksum_bytes, 
-                                uint8_t* remainder_location );
-static void xor_bits_bytewise( uint8_t* field, uint8_t* xor_values, uint32_t n );
+                                uint64_t crc );
 
 
-static void init_polynomial_odd( uint8_t degree )
+static const crc_param_t* get_polynomial( uint8_t degree )
 {
+  if( custom_set )
+  {
+    return ( const crc_param_t* )&custom_polynomial;
+  }
+
   switch( degree )
   {
     case  3:
-      polynomial = polynomial_3;
-      break;
+      return ( const crc_param_t* )&polynomial_3;
     case  8:
-      polynomial = polynomial_8;
-      break;
+      return ( const crc_param_t* )&polynomial_8;
     case 16:
-      polynomial = polynomial_16;
-      break;
+      return ( const crc_param_t* )&polynomial_16;
     case 32:
-      polynomial = polynomial_32;
-      break;
+      return ( const crc_param_t* )&polynomial_32;
     case 64:
-      polynomial = polynomial_64;
-      break;
+      return ( const crc_param_t* )&polynomial_64;
   }
+  return NULL;
 }
 
 
-static void free_resources( int fd, void* file_buf, void* poly_buf )
-{
-  free( file_buf );
-  free( poly_buf );
-  ( void )close( fd );
-}
-
-
-static inline void shift_one_right( uint8_t* field, uint8_t overflows )
+/* MSB first. The top bit of the register meets the next 
+ * message bit, if they differ the polynomial is subtracted. */
+static uint64_t crunch( uint64_t reg, uint64_t poly, 
+                        const uint8_t* data, uint32_t len )
 {
-  uint8_t i, c = 0x00;
+  uint32_t i;
+  uint8_t bit;
 
-  for( i = overflows; i > 0; i-- )
+  for( i = 0U; i < len; i++ )
   {
-    *( field + i ) >>= 1U;
-    c = ( *( field + ( i - 1 ) ) & RIGHT_MOST_BIT ) << 7U;
-    *( field + i ) |= c;
+    reg ^= ( uint64_t )*( data + i ) << 56U;
+    for( bit = 0U; bit < BYTES_TO_BIT; bit++ )
+    {
+      reg = ( reg << 1U ) ^ ( poly & ( 0UL - ( reg >> 63U ) ) );
+    }
   }
-
-  *field >>= 1U;
+  return reg;
 }
 
 
-static void 
-crunch( uint8_t* file_buf, uint8_t* poly_buf, 
-        uint32_t bytes_to_process, uint8_t poly_bytes,
-        uint8_t** remainder )
+/* LSB first, the register and the polynomial are mirrored */
+static uint64_t crunch_reflected( uint64_t reg, uint64_t poly, 
+                                  const uint8_t* data, uint32_t len )
 {
-  uint32_t byte_offset, i;
-  uint8_t  bit_offset;
-  uint8_t  first_bit = 0x80U;
-  
-  for( byte_offset = 0; byte_offset < bytes_to_process; byte_offset++ )
+  uint32_t i;
+  uint8_t bit;
+
+  for( i = 0U; i < len; i++ )
   {
-    for( bit_offset = 0; bit_offset < 8; bit_offset++ )
+    reg ^= ( uint64_t )*( data + i );
+    for( bit = 0U; bit < BYTES_TO_BIT; bit++ )
     {
-      if( *( file_buf + byte_offset ) & ( first_bit >> bit_offset ) )
-      {
-        for( i = byte_offset; i < ( byte_offset + poly_bytes ); i++ )
-        {
-          *( file_buf + i ) ^= *( poly_buf + i );
-        }
-      }
-      shift_one_right( ( poly_buf + byte_offset ), poly_bytes );
+      reg = ( reg >> 1U ) ^ ( poly & ( 0UL - ( reg & 1UL ) ) );
     }
   }
-
-  *remainder = ( file_buf + bytes_to_process );
+  return reg;
 }
 
 
-static void print_crc_checksum( FILE* out, uint8_t checksum_bytes, 
-                                uint8_t* remainder_location )
+/* Register, polynomial and final xor of a model (right aligned
+ * values), left aligned or mirrored and right aligned for
+ * reflected input. */
+static void load_model( const crc_param_t* crc_params, uint8_t shift,
+                        uint64_t* poly, uint64_t* reg, uint64_t* final )
 {
-  int8_t i;
+  *poly  = get_param_value( &crc_params->coeff, crc_params->degree ) << shift;
+  *reg   = get_param_value( &crc_params->initial_xor, crc_params->degree ) << shift;
+  *final = get_param_value( &crc_params->final_xor, crc_params->degree );
 
-  ( void )fprintf( out, "\n\nCRC checksum: 0x" );
-  if( polynomial.reflect_remainder )
-  {
-    for( i = ( int8_t )( checksum_bytes - 1 ); i >= 0; i-- )
-    {
-      ( void )fprintf( out, "%02x", *( remainder_location + i ) );
-    }
-  }
-  else
+  if( crc_params->reflect_input )
   {
-    for( i = 0; i < ( int8_t )checksum_bytes; i++ )
-    {
-      ( void )fprintf( out, "%02x", *( remainder_location + i ) );
-    }
+    reflect_bits_64( poly, 1U );
+    reflect_bits_64( reg, 1U );
   }
-  ( void )fprintf( out, "\n" );
 }
 
 
-static void xor_bits_bytewise( uint8_t* field, uint8_t* xor_values, uint32_t n )
+/* checksum of the register which crunch or crunch_reflected left */
+static uint64_t unload_register( uint64_t reg, uint8_t shift, uint8_t refin,
+                                 uint8_t refout, uint64_t final )
 {
-  uint32_t i;
+  /* plain register, right aligned and not reflected */
+  if( refin )
+  {
+    reflect_bits_64( &reg, 1U );
+  }
+  reg >>= shift;
 
-  for( i = 0; i < n; i++ )
+  if( refout )
   {
-    *( field + i ) ^= *( xor_values + i );
+    reflect_bits_64( &reg, 1U );
+    reg >>= shift;
   }
+
+  return reg ^ final;
 }
 
 
-void calculate_crc_from_file_bitwise( const char* file, 
-                                      uint8_t polynomial_degree )
+static int32_t read_chunk( uint8_t** buf, const uint8_t** data, 
+                           uint8_t stream_input, const char* file, 
+                           uint8_t* more_fragments )
 {
-  uint8_t* file_buf     = NULL;
-  uint8_t* poly_buf     = NULL;
-
-  uint8_t* realloc_file = NULL;
-  uint8_t* realloc_poly = NULL;
-  ssize_t realloc_size = 0;
-
-  int fd = ( -1 );
-  struct stat file_stat;
-  uint64_t file_size_byte = 0;
-  uint64_t file_size_bit  = 0;
-  ssize_t bytes_read = 0;
-  
-  /* uint is bytes */
-  uint8_t checksum_size = 0x00;
-
-  /* uint is bytes */
-  uint8_t poly_bytes = 0x00;
+  int32_t bytes_read;
 
-  uint32_t bytes_to_process = 0x00;
-  
-  uint32_t file_buf_size = FILE_BUF_SIZE;
+  if( stream_input )
+  {
+    return walk_stream( data, ( ssize_t )( chunk_size ? chunk_size : BIT_BUF_SIZE ), 
+                        file, more_fragments );
+  }
 
-  uint8_t first      = 0xFF;
-  uint8_t first_last = 0x00;
+  bytes_read = walk_file( buf, ( ssize_t )( chunk_size ? chunk_size : BIT_BUF_SIZE ), 
+                          file, more_fragments );
+  *data = *buf;
 
-  uint8_t file_walker = 0xFF;
+  return bytes_read;
+}
 
-  off_t cur_file_pos = 0;
 
-  uint32_t file_piece_no = 0;
+static void print_crc_checksum( FILE* out, uint8_t checksum_bytes, 
+                                uint64_t crc )
+{
+  ( void )fprintf( out, "\n\nCRC checksum: 0x%0*lx\n", 
+                        ( int )( 2U * checksum_bytes ), crc );
+}
 
-  uint8_t* remainder_location = NULL;
-  
-  init_polynomial_odd( polynomial_degree );
 
-  checksum_size = 
-    ( polynomial_degree / BYTES_TO_BIT == 0 ) ? 1 : ( polynomial_degree / BYTES_TO_BIT );
-  poly_bytes = 
-    ( polynomial_degree / BYTES_TO_BIT == 0 ) ? 1 : ( checksum_size + 1 );
-  
-  if( !( file_buf = ( uint8_t* )malloc( file_buf_size * sizeof( uint8_t ) ) ) ||
-      !( poly_buf = ( uint8_t* )calloc( 1, file_buf_size ) ) )
+void set_bitwise_chunk_size( size_t size )
+{
+  if( size > ( size_t )INT32_MAX )
   {
-    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
-    exit( EXIT_FAILURE );
+    ( void )fprintf( stderr, "Unsupported chunk size: %lu\n", size );
+    return;
   }
+  chunk_size = size;
+}
 
-  if( ( fd = open( file, O_RDONLY ) ) == ( -1 ) )
-  {
-    ( void )fprintf( stderr, "%s\n", strerror( errno ) );
-    goto exit_fail;
-  }
 
-  if( stat( file, &file_stat ) )
+void set_bitwise_params( const crc_param_t* crc_params )
+{
+  if( !crc_params )
   {
-    ( void )fprintf( stderr, "%s\n", strerror( errno ) );
-    goto exit_fail;
+    custom_set = 0x00U;
+    return;
   }
-  file_size_byte = file_stat.st_size;
-  file_size_bit  = file_size_byte * BYTES_TO_BIT;
-  ( void )fprintf( stdout, "\nThe input file has a size of %ld bytes (%ld bit).\n", 
-                           file_size_byte,
-                           file_size_bit );
+  custom_polynomial = *crc_params;
+  custom_set = 0xFFU;
+}
 
-  if( !file_size_byte )
-  {
-    ( void )fprintf( stdout, "File size is zero bytes. Checksum is 0.\n" );
-    goto exit_success;
-  }
 
-  if( file_buf_size <= ( uint32_t )poly_bytes )
-  {
-    printf( "%d\n", poly_bytes );
-    ( void )fprintf( stderr, "File buffer must be greater than polynomial size.\n" );
-    goto exit_fail;
-  }
+const crc_param_t* get_bitwise_params( uint8_t degree )
+{
+  return get_polynomial( degree );
+}
+
+
+void calculate_crc_from_file_bitwise( const char* file, 
+                                      uint8_t polynomial_degree )
+{
+  uint8_t* buf            = NULL;
+  const uint8_t* data     = NULL;
+  int32_t  bytes_read     = 0;
+  uint8_t  more_fragments = 0xFFU;
+  uint8_t  stream_input   = 0x00U;
+  uint64_t total_bytes    = 0UL;
+  double   seconds        = 0.0;
+  double   start;
+
+  /* uint is bytes */
+  uint8_t checksum_size = 0x00;
 
-  if( file_size_byte <= file_buf_size )
+  const crc_param_t* crc_params = NULL;
+  uint64_t poly, reg, final;
+  uint8_t shift;
+
+  if( !( crc_params = get_polynomial( polynomial_degree ) ) )
   {
-    first_last = 0xFF;
+    ( void )fprintf( stderr, "Unsupported polynomial degree: %d\n", polynomial_degree );
+    return;
   }
+  polynomial_degree = crc_params->degree;
+
+  checksum_size = ( uint8_t )( ( polynomial_degree + BYTES_TO_BIT - 1U ) / BYTES_TO_BIT );
+  shift         = ( uint8_t )( 64U - polynomial_degree );
 
-  /* write according polynomial coefficients into buffer. */
-  ( void )memcpy( ( void* )poly_buf, 
-                  ( const void* )polynomial.coeff.u_8_field, 
-                  poly_bytes );
+  load_model( crc_params, shift, &poly, &reg, &final );
 
-  do
+  stream_input = is_stream_input( file );
+
+  while( ( bytes_read = read_chunk( &buf, &data, stream_input, 
+                                    file, &more_fragments ) ) )
   {
-    if( first )
-    {
-      bytes_read = read( fd, ( void* )file_buf, file_buf_size );
-      check_reflect( file_buf, bytes_read, polynomial.reflect_input );
-      xor_bits_bytewise( file_buf, polynomial.initial_xor.u_8_field, 
-                         ( uint32_t )checksum_size );
-      first = 0x00;
-    }
-    else
-    {
-      ( void )memmove( ( void* )file_buf, 
-                       ( void* )( file_buf + ( file_buf_size - poly_bytes ) ), 
-                       poly_bytes );
-      ( void )memmove( ( void* )poly_buf, 
-                       ( void* )( poly_buf + ( file_buf_size - poly_bytes ) ), 
-                       poly_bytes );
-
-      /* after moving the polynomial buffer to the start of the poly_buf,
-       * the bytes at the end have to be zeroed. */
-      ( void )memset( ( void* )( poly_buf + poly_bytes ), 0x00000000,
-                      ( file_buf_size - poly_bytes ) );
-
-      bytes_read = read( fd, 
-                         ( void* )( file_buf + poly_bytes ), 
-                         ( file_buf_size - poly_bytes ) );
-      check_reflect( ( file_buf + poly_bytes ), bytes_read, polynomial.reflect_input );
-    }
+    start = get_monotonic_seconds();
+    reg = crc_params->reflect_input ?
+          crunch_reflected( reg, poly, data, ( uint32_t )bytes_read ) :
+          crunch( reg, poly, data, ( uint32_t )bytes_read );
+    seconds += get_monotonic_seconds() - start;
+    crc_stats_end( CRC_STAGE_CRC, start, ( uint64_t )bytes_read );
+    total_bytes += ( uint64_t )bytes_read;
+  }
 
-    /* we are at the end and can add the checksum bytes */
-    cur_file_pos = lseek( fd, 0, SEEK_CUR );
-    if( cur_file_pos == lseek( fd, 0, SEEK_END ) )
-    {
-      /* 
-       * The + 1 in the realloc size is here so that we have enough
-       * space available and the right shift during the last byte
-       * will not segfault.
-       */
-      if( first_last )
-      {
-        realloc_size = ( ssize_t )( bytes_read + checksum_size + 1 );
-        bytes_to_process = bytes_read;
-      }
-      else
-      {
-        realloc_size = ( ssize_t )( poly_bytes + bytes_read + checksum_size + 1 );
-        bytes_to_process = poly_bytes + bytes_read;
-      }
-      if( !( realloc_file = ( uint8_t* )realloc( ( void* )file_buf, realloc_size ) ) ||
-          !( realloc_poly = ( uint8_t* )realloc( ( void* )poly_buf, realloc_size ) ) )
-      {
-        ( void )fprintf( stderr, "Failed to reallocate memory.\n" );
-        goto exit_fail;
-      }
-      file_buf = realloc_file;
-      poly_buf = realloc_poly;
-      file_walker = 0x00;
-    }
-    else
-    {
-      ( void )lseek( fd, cur_file_pos, SEEK_SET );
-      bytes_to_process = file_buf_size - poly_bytes;
-    }
-    ( void )fprintf( stdout, "%5d: keep walking ..., bytes to process: %d\n", 
-                             ++file_piece_no,
-                             bytes_to_process );
+  reg = unload_register( reg, shift, crc_params->reflect_input, 
+                         crc_params->reflect_remainder, final );
 
-    crunch( file_buf, poly_buf,
-            bytes_to_process, poly_bytes, 
-            &remainder_location );
+  print_crc_checksum( stdout, checksum_size, reg );
 
-  } while( file_walker );
-  
-  xor_bits_bytewise( remainder_location, polynomial.final_xor.u_8_field, 
-                     ( uint32_t )checksum_size );
+  if( seconds > 0.0 )
+  {
+    ( void )fprintf( stdout, "Throughput: %.1f MB/s\n", 
+                             ( double )total_bytes * BYTES_TO_MEGABYTES / seconds );
+  }
+}
 
-  check_reflect( remainder_location, checksum_size, polynomial.reflect_remainder );
 
-  print_crc_checksum( stdout, checksum_size, remainder_location );
+uint64_t calculate_crc_bitwise( const crc_param_t* crc_params, 
+                                const uint8_t* data, size_t len )
+{
+  uint64_t poly, reg, final;
+  uint32_t piece;
+  uint8_t shift;
 
-  /* just to be correct and consistent */
-  goto exit_success;
+  shift = ( uint8_t )( 64U - crc_params->degree );
+  load_model( crc_params, shift, &poly, &reg, &final );
 
-  exit_success:
-    free_resources( fd, ( void* )file_buf, ( void* )poly_buf );
-    return;
+  while( len )
+  {
+    piece = ( len > ( size_t )BIT_BUF_SIZE ) ? ( uint32_t )BIT_BUF_SIZE : ( uint32_t )len;
+    reg = crc_params->reflect_input ?
+          crunch_reflected( reg, poly, data, piece ) :
+          crunch( reg, poly, data, piece );
+    data += piece;
+    len  -= piece;
+  }
 
-  exit_fail:
-    free_resources( fd, ( void* )file_buf, ( void* )poly_buf );
-    exit( EXIT_FAILURE );
+  return unload_register( reg, shift, crc_params->reflect_input, 
+                          crc_params->reflect_remainder, final );
 }
-
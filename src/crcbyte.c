@@ -20,6 +20,15 @@
  *            - The program crunches the input
  *              streams byte by byte.
  *
+ *            - CRC16 has dedicated kernels, all the
+ *              other polynomial degrees are processed
+ *              with a left aligned 64 bit register.
+ *
+ *            - Reflected input is processed LSB first
+ *              with reflected tables, the input data
+ *              is never written. The checksum passed
+ *              between fragments is kept unreflected.
+ *
  *
  * Date:      11/2017 
  * 
@@ -29,15 +38,43 @@
 #include <crc.h>
 #include <crcparam_even.h>
 #include <crcbyte.h>
+#include <crcapi.h>
+#include <crckernel.h>
+#include <crcstats.h>
 #include <util.h>
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
 #include <unistd.h>
+#include <string.h>
+#include <errno.h>
 #include <stdio.h>
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+
+#define OPT_LEVEL_NONE     0U
+#define OPT_LEVEL_LUT      1U
+#define OPT_LEVEL_SLICE_4  4U
+#define OPT_LEVEL_SLICE_8  8U
+#define OPT_LEVEL_SLICE_16 16U
+#define OPT_LEVEL_CLMUL    32U
+#define OPT_LEVEL_SSE42    64U
+#define OPT_LEVEL_DISPATCH 128U
 
-#define OPT_LEVEL_NONE 0U
-#define OPT_LEVEL_LUT  1U
+#define MAX_SLICES 16U
+
+#define BYTES_TO_MEGABYTES ( 1.0 / ( 1024.0 * 1024.0 ) )
+
+/* bytes the single table path crunches once
+ * for the throughput comparison */
+#define LUT_SAMPLE_BYTES 0x100000U
+
+#define REGISTER_BITS 64U
+#define TOP_BIT       0x8000000000000000UL
 
 #define CRC_3_LEN  1U /* unit is bytes */
 #define CRC_8_LEN  1U /* unit is bytes */
@@ -52,50 +89,222 @@ static crc_param_t polynomial_16 = CRC_16_POLY_PARAM;
 static crc_param_t polynomial_32 = CRC_32_POLY_PARAM;
 static crc_param_t polynomial_64 = CRC_64_POLY_PARAM;
 
+static crc_param_t polynomial_32c = CRC_32C_POLY_PARAM;
+
 static crc_param_t polynomial;
 
+/* model set with set_bytewise_params, replaces the defaults */
+static crc_param_t custom_polynomial;
+static uint8_t     custom_set = 0x00U;
+
 static void ( *crc_calc_func )( const char*, uint8_t ) = NULL;
 
-static uint16_t lut_crc_16[ 0x100U ] = { 0x0000U };
+static uint8_t input_mode = CRC_INPUT_READ;
+
+/* pipes and the like are read with walk_stream in any mode */
+static uint8_t stream_input = 0x00U;
+
+/* buffer of calculate_crc_of_files, kept from file to file */
+static uint8_t* file_pool     = NULL;
+static size_t   file_pool_len = 0U;
+
+/* 0 picks the default of the input mode */
+static uint32_t queue_depth = 0U;
+static size_t   chunk_size  = 0U;
+
+/* indexed by the CRC_INPUT_* ids */
+static const char* input_mode_names[] = 
+{ 
+  "read", "mmap", "uring", "pipe", "direct", "nocache" 
+};
+
+/* Tables built at runtime, only for parameter sets
+ * without generated tables (crctables.h). */
+static uint16_t built_crc_16[ MAX_SLICES ][ 0x100U ];
+static crc_lut_tables_t built_tables;
+
+/* lut_crc_16_slice[ k ][ i ] holds the crc of the byte i
+ * followed by k zero bytes. Slice 0 equals lut_crc_16. */
+static const uint16_t* lut_crc_16 = built_crc_16[ 0U ];
+static const uint16_t ( *lut_crc_16_slice )[ 0x100U ] = 
+  ( const uint16_t ( * )[ 0x100U ] )built_crc_16;
+
+/* Width generic tables. The crc register is aligned to the
+ * left of a 64 bit word, so that the same table algorithm 
+ * works for every polynomial degree from 1 up to 64. */
+static const crc_lut_tables_t* lut_tables = &built_tables;
+
+/* keeps the compiler from dropping the single table sample run */
+static uint64_t lut_sink = 0x0000000000000000UL;
 
 
 static void init_polynomial_even( uint8_t degree );
-static void calculate_crc16( const char* file, uint8_t opt_level );
+static uint8_t use_polynomial_32c( uint8_t degree );
+static void calculate_crc( const char* file, uint8_t opt_level );
+static int32_t read_chunk( uint8_t** buf, const uint8_t** data, 
+                           const char* file, uint8_t* more_fragments );
+static void run_crc_algorithm( const uint8_t* data, const uint32_t len, 
+                               uint8_t opt_level, uint64_t* p_crc,
+                               uint8_t first_call,
+                               uint8_t more_fragments );
+
+static inline uint64_t crc_slice( const uint64_t ( *lut )[ 0x100U ],
+                                  const uint8_t* data, size_t len,
+                                  uint64_t crc, const uint8_t slices );
+static inline uint64_t crc_slice_reflected( const uint64_t ( *lut )[ 0x100U ],
+                                            const uint8_t* data, size_t len,
+                                            uint64_t crc, const uint8_t slices );
+static inline uint64_t reflect_register( uint64_t crc, uint8_t degree );
+static void crc_algorithm_slicing( const uint8_t* data, const uint32_t len,
+                                   const crc_param_t* crc_params, uint64_t* p_crc,
+                                   uint8_t first_call,
+                                   uint8_t more_fragments,
+                                   const uint8_t slices );
 
-void crc16_algorithm( uint8_t* data, const uint32_t len,
+static inline uint16_t crc16_slice( const uint8_t* data, uint32_t len,
+                                    uint16_t crc, const uint8_t slices );
+static inline uint16_t crc16_slice_reflected( const uint8_t* data, uint32_t len,
+                                              uint16_t crc, const uint8_t slices );
+static void crc16_algorithm_slicing( const uint8_t* data, const uint32_t len,
+                                     const crc_param_t* crc_params, uint16_t* p_crc,
+                                     uint8_t first_call,
+                                     uint8_t more_fragments,
+                                     const uint8_t slices );
+static void print_pipe_stats( void );
+static double measure_lut_rate( void );
+static void print_throughput( uint64_t bytes, double seconds,
+                              double lut_rate, double wall_seconds );
+static void print_crc( uint64_t crc, uint8_t degree );
+static int compare_seconds( const void* a, const void* b );
+static uint8_t crc_of_file( crc_ctx_t* ctx, const char* file, uint64_t* p_crc );
+
+void crc16_algorithm( const uint8_t* data, const uint32_t len,
                       const crc_param_t* crc_params, uint16_t* p_crc,
                       uint8_t first_call,
                       uint8_t more_fragments );
 
-void crc16_algorithm_lut( uint8_t* data, const uint32_t len,
+void crc16_algorithm_lut( const uint8_t* data, const uint32_t len,
                           const crc_param_t* crc_params, uint16_t* p_crc,
                           uint8_t first_call,
                           uint8_t more_fragments );
 
 void init_lut_crc_16( const crc_param_t* crc_params );
 
+void init_lut_crc_16_slicing( const crc_param_t* crc_params );
+
+void crc16_algorithm_slicing_4( const uint8_t* data, const uint32_t len,
+                                const crc_param_t* crc_params, uint16_t* p_crc,
+                                uint8_t first_call,
+                                uint8_t more_fragments );
+
+void crc16_algorithm_slicing_8( const uint8_t* data, const uint32_t len,
+                                const crc_param_t* crc_params, uint16_t* p_crc,
+                                uint8_t first_call,
+                                uint8_t more_fragments );
+
+void crc16_algorithm_slicing_16( const uint8_t* data, const uint32_t len,
+                                 const crc_param_t* crc_params, uint16_t* p_crc,
+                                 uint8_t first_call,
+                                 uint8_t more_fragments );
+
+void crc_algorithm( const uint8_t* data, const uint32_t len,
+                    const crc_param_t* crc_params, uint64_t* p_crc,
+                    uint8_t first_call,
+                    uint8_t more_fragments );
+
+void init_lut_crc( const crc_param_t* crc_params );
+
+void init_lut_crc_slicing( const crc_param_t* crc_params );
+
+void crc_algorithm_lut( const uint8_t* data, const uint32_t len,
+                        const crc_param_t* crc_params, uint64_t* p_crc,
+                        uint8_t first_call,
+                        uint8_t more_fragments );
+
+void crc_algorithm_slicing_4( const uint8_t* data, const uint32_t len,
+                              const crc_param_t* crc_params, uint64_t* p_crc,
+                              uint8_t first_call,
+                              uint8_t more_fragments );
+
+void crc_algorithm_slicing_8( const uint8_t* data, const uint32_t len,
+                              const crc_param_t* crc_params, uint64_t* p_crc,
+                              uint8_t first_call,
+                              uint8_t more_fragments );
+
+void crc_algorithm_slicing_16( const uint8_t* data, const uint32_t len,
+                               const crc_param_t* crc_params, uint64_t* p_crc,
+                               uint8_t first_call,
+                               uint8_t more_fragments );
+
 
 static void init_polynomial_even( uint8_t degree )
 {
+  /* the tables of the kernels are looked up or built for any degree */
+  if( custom_set )
+  {
+    polynomial = custom_polynomial;
+    crc_calc_func = &calculate_crc;
+    return;
+  }
+
   switch( degree )
   {
     case  3:
       polynomial = polynomial_3;
+      crc_calc_func = &calculate_crc;
       break;
     case  8:
       polynomial = polynomial_8;
+      crc_calc_func = &calculate_crc;
       break;
     case 16:
       polynomial = polynomial_16;
-      crc_calc_func = &calculate_crc16;
+      crc_calc_func = &calculate_crc;
       break;
     case 32:
       polynomial = polynomial_32;
+      crc_calc_func = &calculate_crc;
       break;
     case 64:
       polynomial = polynomial_64;
+      crc_calc_func = &calculate_crc;
       break;
+    default:
+      ( void )fprintf( stderr, "Unsupported polynomial degree: %d\n", degree );
+      crc_calc_func = NULL;
+      break;
+  }
+}
+
+
+/* The crc32 instruction is bound to the Castagnoli polynomial, the
+ * default parameters are replaced by CRC-32C. A model which was set
+ * has to be a reflected one with that polynomial. */
+static uint8_t use_polynomial_32c( uint8_t degree )
+{
+  if( custom_set )
+  {
+    if( ( polynomial.degree != 32U ) ||
+        ( polynomial.coeff.u_32 != polynomial_32c.coeff.u_32 ) ||
+        !polynomial.reflect_input )
+    {
+      ( void )fprintf( stderr, "The crc32 instruction only supports "
+                               "the reflected Castagnoli polynomial.\n" );
+      return 0x00U;
+    }
+    return 0xFFU;
+  }
+
+  if( degree != 32U )
+  {
+    ( void )fprintf( stderr, "The crc32 instruction only supports "
+                             "a polynomial degree of 32.\n" );
+    return 0x00U;
   }
+
+  polynomial = polynomial_32c;
+  ( void )fprintf( stdout, "Using the CRC-32C (Castagnoli) parameters.\n" );
+  return 0xFFU;
 }
 
 
@@ -105,9 +314,47 @@ void init_lut_crc_16( const crc_param_t* crc_params )
   uint16_t cur_byte;
   uint16_t poly;
   uint8_t j;
+  const uint16_t ( *generated )[ 0x100U ];
+
+  /* the generated tables have all the slices */
+  if( ( generated = crc_lut_16_find( crc_params ) ) )
+  {
+    lut_crc_16_slice = generated;
+    lut_crc_16       = generated[ 0U ];
+    return;
+  }
+
+  lut_crc_16_slice = ( const uint16_t ( * )[ 0x100U ] )built_crc_16;
+  lut_crc_16       = built_crc_16[ 0U ];
 
   poly = crc_params->coeff.u_16;
 
+  if( crc_params->reflect_input )
+  {
+    /* LSB first, the input bytes are processed as they are */
+    reflect_bits_16( &poly, 1U );
+
+    for( i = 0U; i < 0x100U; i++ )
+    {
+      cur_byte = i;
+
+      for( j = 0U; j < 8U; j++ )
+      {
+        if( cur_byte & 0x0001U )
+        {
+          cur_byte >>= 1U;
+          cur_byte  ^= poly;
+        }
+        else
+        {
+          cur_byte >>= 1U;
+        }
+      }
+      built_crc_16[ 0U ][ i ] = cur_byte;
+    }
+    return;
+  }
+
   for( i = 0U; i < 0x100U; i++ )
   {
     cur_byte = ( i << 8U );
@@ -124,12 +371,12 @@ void init_lut_crc_16( const crc_param_t* crc_params )
         cur_byte <<= 1U;
       }
     }
-    lut_crc_16[ i ] = cur_byte;
+    built_crc_16[ 0U ][ i ] = cur_byte;
   }
 }
 
 
-void crc16_algorithm_lut( uint8_t* data, const uint32_t len,
+void crc16_algorithm_lut( const uint8_t* data, const uint32_t len,
                           const crc_param_t* crc_params, uint16_t* p_crc,
                           uint8_t first_call,
                           uint8_t more_fragments )
@@ -147,38 +394,228 @@ void crc16_algorithm_lut( uint8_t* data, const uint32_t len,
   
   crc = *p_crc;
   
+  if( first_call )
+  {
+    crc ^= crc_params->initial_xor.u_16;
+  }
+
   if( crc_params->reflect_input )
   {
-    reflect_bits_8( data, len );
+    reflect_bits_16( &crc, 1U );
+
+    for( i = 0U; i < len; i++ )
+    {
+      cur_byte = *( data + i );
+      position = ( ( uint8_t )crc ) ^ cur_byte;
+      crc = ( crc >> 8U ) ^ lut_crc_16[ position ];
+    }
+
+    reflect_bits_16( &crc, 1U );
+  }
+  else
+  {
+    for( i = 0U; i < len; i++ )
+    {
+      cur_byte = *( data + i );
+      position = ( ( uint8_t )( crc >> 8U ) ) ^ cur_byte;
+      crc = ( crc << 8U ) ^ lut_crc_16[ position ];
+    }
+  }
+  
+  if( !more_fragments )
+  {
+    if( crc_params->reflect_remainder )
+    {
+      reflect_bits_16( &crc, 1U );
+    }
+
+    crc ^= crc_params->final_xor.u_16;
   }
   
+  *p_crc = crc;
+}
+
+
+void init_lut_crc_16_slicing( const crc_param_t* crc_params )
+{
+  uint16_t i;
+  uint8_t k;
+  uint16_t prev;
+
+  init_lut_crc_16( crc_params );
+
+  if( lut_crc_16 != built_crc_16[ 0U ] )
+  {
+    return;
+  }
+
+  /* Appending a zero byte to a message means shifting 
+   * its crc by 8 bit and reducing the byte which falls out. */
+  for( k = 1U; k < MAX_SLICES; k++ )
+  {
+    for( i = 0U; i < 0x100U; i++ )
+    {
+      prev = built_crc_16[ k - 1U ][ i ];
+      if( crc_params->reflect_input )
+      {
+        built_crc_16[ k ][ i ] = ( prev >> 8U ) ^ 
+                                 built_crc_16[ 0U ][ ( uint8_t )prev ];
+      }
+      else
+      {
+        built_crc_16[ k ][ i ] = ( prev << 8U ) ^ 
+                                 built_crc_16[ 0U ][ ( uint8_t )( prev >> 8U ) ];
+      }
+    }
+  }
+}
+
+
+static inline uint16_t crc16_slice( const uint8_t* data, uint32_t len,
+                                    uint16_t crc, const uint8_t slices )
+{
+  uint16_t next;
+  uint8_t k;
+
+  /* The two crc bytes are merged into the first two
+   * message bytes of the slice. Every byte of the slice
+   * is looked up independently of the others, so the
+   * serial dependency on crc is only once per slice. */
+  while( len >= ( uint32_t )slices )
+  {
+    next = lut_crc_16_slice[ slices - 1U ][ *data ^ ( uint8_t )( crc >> 8U ) ] ^
+           lut_crc_16_slice[ slices - 2U ][ *( data + 1 ) ^ ( uint8_t )crc ];
+
+    for( k = 2U; k < slices; k++ )
+    {
+      next ^= lut_crc_16_slice[ slices - 1U - k ][ *( data + k ) ];
+    }
+
+    crc   = next;
+    data += slices;
+    len  -= ( uint32_t )slices;
+  }
+
+  while( len-- )
+  {
+    crc = ( crc << 8U ) ^ 
+          lut_crc_16_slice[ 0U ][ ( ( uint8_t )( crc >> 8U ) ) ^ *data++ ];
+  }
+
+  return crc;
+}
+
+
+static inline uint16_t crc16_slice_reflected( const uint8_t* data, uint32_t len,
+                                              uint16_t crc, const uint8_t slices )
+{
+  uint16_t next;
+  uint8_t k;
+
+  /* same as crc16_slice, but the register is reflected
+   * and its low byte meets the first message byte */
+  while( len >= ( uint32_t )slices )
+  {
+    next = lut_crc_16_slice[ slices - 1U ][ *data ^ ( uint8_t )crc ] ^
+           lut_crc_16_slice[ slices - 2U ][ *( data + 1 ) ^ ( uint8_t )( crc >> 8U ) ];
+
+    for( k = 2U; k < slices; k++ )
+    {
+      next ^= lut_crc_16_slice[ slices - 1U - k ][ *( data + k ) ];
+    }
+
+    crc   = next;
+    data += slices;
+    len  -= ( uint32_t )slices;
+  }
+
+  while( len-- )
+  {
+    crc = ( crc >> 8U ) ^ 
+          lut_crc_16_slice[ 0U ][ ( ( uint8_t )crc ) ^ *data++ ];
+  }
+
+  return crc;
+}
+
+
+static void crc16_algorithm_slicing( const uint8_t* data, const uint32_t len,
+                                     const crc_param_t* crc_params, uint16_t* p_crc,
+                                     uint8_t first_call,
+                                     uint8_t more_fragments,
+                                     const uint8_t slices )
+{
+  uint16_t crc = 0x0000U;
+
+  if( len >= UINT32_MAX )
+  {
+    ( void )fprintf( stderr, "Invalid number of bytes passed to crc algorithm.\n" );
+    return;
+  }
+
+  crc = *p_crc;
+
   if( first_call )
   {
     crc ^= crc_params->initial_xor.u_16;
   }
 
-  for( i = 0U; i < len; i++ )
+  if( crc_params->reflect_input )
   {
-    cur_byte = *( data + i );
-    position = ( ( uint8_t )( crc >> 8U ) ) ^ cur_byte;
-    crc = ( crc << 8U ) ^ lut_crc_16[ position ];
+    reflect_bits_16( &crc, 1U );
+    crc = crc16_slice_reflected( data, len, crc, slices );
+    reflect_bits_16( &crc, 1U );
   }
-  
-  if( !more_fragments )
+  else
   {
-    crc ^= crc_params->final_xor.u_16;
+    crc = crc16_slice( data, len, crc, slices );
+  }
 
+  if( !more_fragments )
+  {
     if( crc_params->reflect_remainder )
     {
       reflect_bits_16( &crc, 1U );
     }
+
+    crc ^= crc_params->final_xor.u_16;
   }
-  
+
   *p_crc = crc;
 }
 
 
-void crc16_algorithm( uint8_t* data, const uint32_t len,
+void crc16_algorithm_slicing_4( const uint8_t* data, const uint32_t len,
+                                const crc_param_t* crc_params, uint16_t* p_crc,
+                                uint8_t first_call,
+                                uint8_t more_fragments )
+{
+  crc16_algorithm_slicing( data, len, crc_params, p_crc, 
+                           first_call, more_fragments, 4U );
+}
+
+
+void crc16_algorithm_slicing_8( const uint8_t* data, const uint32_t len,
+                                const crc_param_t* crc_params, uint16_t* p_crc,
+                                uint8_t first_call,
+                                uint8_t more_fragments )
+{
+  crc16_algorithm_slicing( data, len, crc_params, p_crc, 
+                           first_call, more_fragments, 8U );
+}
+
+
+void crc16_algorithm_slicing_16( const uint8_t* data, const uint32_t len,
+                                 const crc_param_t* crc_params, uint16_t* p_crc,
+                                 uint8_t first_call,
+                                 uint8_t more_fragments )
+{
+  crc16_algorithm_slicing( data, len, crc_params, p_crc, 
+                           first_call, more_fragments, 16U );
+}
+
+
+void crc16_algorithm( const uint8_t* data, const uint32_t len,
                       const crc_param_t* crc_params, uint16_t* p_crc,
                       uint8_t first_call,
                       uint8_t more_fragments )
@@ -197,101 +634,1084 @@ void crc16_algorithm( uint8_t* data, const uint32_t len,
   poly = crc_params->coeff.u_16;
   crc  = *p_crc;
     
-  if( crc_params->reflect_input )
-  {
-    reflect_bits_8( data, len );
-  }
-
   if( first_call )
   {
     crc ^= crc_params->initial_xor.u_16;
   }
 
-  for( i = 0; i < len; i++ )
+  if( crc_params->reflect_input )
   {
-    cur_byte = *( data + i );
-    crc ^= ( ( uint16_t )cur_byte ) << 8;
+    /* shift register the other way round, LSB first */
+    reflect_bits_16( &poly, 1U );
+    reflect_bits_16( &crc, 1U );
 
-    for( j = 0; j < 8; j++ )
+    for( i = 0; i < len; i++ )
     {
-      if( crc & 0x8000 )
+      cur_byte = *( data + i );
+      crc ^= ( uint16_t )cur_byte;
+
+      for( j = 0; j < 8; j++ )
       {
-        crc = ( crc << 1 ) ^ poly;
+        if( crc & 0x0001 )
+        {
+          crc = ( crc >> 1 ) ^ poly;
+        }
+        else
+        {
+          crc >>= 1;
+        }
       }
-      else
+    }
+
+    reflect_bits_16( &crc, 1U );
+  }
+  else
+  {
+    for( i = 0; i < len; i++ )
+    {
+      cur_byte = *( data + i );
+      crc ^= ( ( uint16_t )cur_byte ) << 8;
+
+      for( j = 0; j < 8; j++ )
       {
-        crc <<= 1;
+        if( crc & 0x8000 )
+        {
+          crc = ( crc << 1 ) ^ poly;
+        }
+        else
+        {
+          crc <<= 1;
+        }
       }
     }
   }
   
   if( !more_fragments )
   {
-    crc ^= crc_params->final_xor.u_16;
-
     if( crc_params->reflect_remainder )
     {
       reflect_bits_16( &crc, 1U );
     }
+
+    crc ^= crc_params->final_xor.u_16;
   }
 
   *p_crc = crc;
 }
 
 
-static void calculate_crc16( const char* file, uint8_t opt_level )
+static inline uint64_t reflect_register( uint64_t crc, uint8_t degree )
 {
-  int32_t  bytes_read     = 0;
-  uint8_t* buf            = NULL;
-  ssize_t  buf_len        = ( ssize_t )FILE_BUF_SIZE;
-  uint16_t crc16          = 0x0000U;
-  uint8_t  first_call     = 0xFFU;
-  uint8_t  more_fragments = 0xFFU;
+  reflect_bits_64( &crc, 1U );
+  return crc >> ( REGISTER_BITS - degree );
+}
 
-  if( opt_level == OPT_LEVEL_LUT )
+
+void crc_lut_build( crc_lut_tables_t* tables, const crc_param_t* crc_params,
+                    uint8_t slices )
+{
+  uint16_t i;
+  uint64_t cur_byte;
+  uint64_t poly;
+  uint64_t prev;
+  uint8_t j, k;
+
+  poly = get_param_value( &crc_params->coeff, crc_params->degree );
+
+  if( crc_params->reflect_input )
   {
-    init_lut_crc_16( ( const crc_param_t* )&polynomial );
+    /* LSB first and right aligned, the input 
+     * bytes are processed as they are */
+    poly = reflect_register( poly, crc_params->degree );
   }
-  
-  while( ( bytes_read = walk_file( &buf, buf_len, file, &more_fragments ) ) )
+  else
   {
-    ( void )fprintf( stdout, "Bytes read: %d\n", bytes_read );
-    switch( opt_level )
+    poly <<= ( REGISTER_BITS - crc_params->degree );
+  }
+
+  for( i = 0U; i < 0x100U; i++ )
+  {
+    if( crc_params->reflect_input )
     {
-      case OPT_LEVEL_NONE:
-        crc16_algorithm( buf, ( const uint32_t )bytes_read, 
-                         ( const crc_param_t* )&polynomial, &crc16,
-                         first_call,
-                         more_fragments );
-        break;
-      case OPT_LEVEL_LUT:
-        crc16_algorithm_lut( buf, ( const uint32_t )bytes_read, 
-                             ( const crc_param_t* )&polynomial, &crc16,
-                             first_call,
-                             more_fragments );
-        break;
+      cur_byte = ( uint64_t )i;
+
+      for( j = 0U; j < 8U; j++ )
+      {
+        cur_byte = ( cur_byte & 0x0000000000000001UL ) ? 
+                   ( cur_byte >> 1U ) ^ poly : ( cur_byte >> 1U );
+      }
     }
-    if( first_call )
+    else
     {
-      first_call = 0x00U;
+      cur_byte = ( ( uint64_t )i << 56U );
+
+      for( j = 0U; j < 8U; j++ )
+      {
+        cur_byte = ( cur_byte & TOP_BIT ) ? 
+                   ( cur_byte << 1U ) ^ poly : ( cur_byte << 1U );
+      }
+    }
+    tables->slice[ 0U ][ i ] = cur_byte;
+  }
+
+  /* Appending a zero byte to a message means shifting 
+   * its crc by 8 bit and reducing the byte which falls out. */
+  for( k = 1U; k < slices; k++ )
+  {
+    for( i = 0U; i < 0x100U; i++ )
+    {
+      prev = tables->slice[ k - 1U ][ i ];
+      if( crc_params->reflect_input )
+      {
+        tables->slice[ k ][ i ] = ( prev >> 8U ) ^ 
+                                  tables->slice[ 0U ][ ( uint8_t )prev ];
+      }
+      else
+      {
+        tables->slice[ k ][ i ] = ( prev << 8U ) ^ 
+                                  tables->slice[ 0U ][ ( uint8_t )( prev >> 56U ) ];
+      }
     }
   }
-  ( void )fprintf( stdout, "CRC16: %#06x\n", crc16 );
 }
 
 
-void calculate_crc_from_file_bytewise( const char* file, 
-                                       uint8_t polynomial_degree )
+void init_lut_crc( const crc_param_t* crc_params )
 {
-  init_polynomial_even( polynomial_degree );
-  crc_calc_func( file, OPT_LEVEL_NONE );
+  if( !( lut_tables = crc_lut_find( crc_params ) ) )
+  {
+    crc_lut_build( &built_tables, crc_params, 1U );
+    lut_tables = ( const crc_lut_tables_t* )&built_tables;
+  }
 }
 
 
-void calculate_crc_from_file_bytewise_lut( const char* file, 
-                                           uint8_t polynomial_degree )
+void init_lut_crc_slicing( const crc_param_t* crc_params )
 {
-  init_polynomial_even( polynomial_degree );
-  crc_calc_func( file, OPT_LEVEL_NONE );
+  if( !( lut_tables = crc_lut_find( crc_params ) ) )
+  {
+    crc_lut_build( &built_tables, crc_params, CRC_MAX_SLICES );
+    lut_tables = ( const crc_lut_tables_t* )&built_tables;
+  }
 }
 
+
+static inline uint64_t crc_slice( const uint64_t ( *lut )[ 0x100U ],
+                                  const uint8_t* data, size_t len,
+                                  uint64_t crc, const uint8_t slices )
+{
+  uint64_t next;
+  uint8_t k;
+  uint8_t cur_byte;
+
+  /* Up to eight register bytes are merged into the first 
+   * message bytes of a slice. With less than eight slices the
+   * remaining register bytes are shifted to the top. */
+  while( len >= ( size_t )slices )
+  {
+    next = ( slices < 8U ) ? ( crc << ( 8U * slices ) ) : 0UL;
+
+    for( k = 0U; k < slices; k++ )
+    {
+      cur_byte = *( data + k );
+      if( k < 8U )
+      {
+        cur_byte ^= ( uint8_t )( crc >> ( 56U - 8U * k ) );
+      }
+      next ^= lut[ slices - 1U - k ][ cur_byte ];
+    }
+
+    crc   = next;
+    data += slices;
+    len  -= ( size_t )slices;
+  }
+
+  while( len-- )
+  {
+    crc = ( crc << 8U ) ^ 
+          lut[ 0U ][ ( ( uint8_t )( crc >> 56U ) ) ^ *data++ ];
+  }
+
+  return crc;
+}
+
+
+static inline uint64_t crc_slice_reflected( const uint64_t ( *lut )[ 0x100U ],
+                                            const uint8_t* data, size_t len,
+                                            uint64_t crc, const uint8_t slices )
+{
+  uint64_t next;
+  uint8_t k;
+  uint8_t cur_byte;
+
+  /* same as crc_slice, but the reflected register is right
+   * aligned and its low bytes meet the first message bytes */
+  while( len >= ( size_t )slices )
+  {
+    next = ( slices < 8U ) ? ( crc >> ( 8U * slices ) ) : 0UL;
+
+    for( k = 0U; k < slices; k++ )
+    {
+      cur_byte = *( data + k );
+      if( k < 8U )
+      {
+        cur_byte ^= ( uint8_t )( crc >> ( 8U * k ) );
+      }
+      next ^= lut[ slices - 1U - k ][ cur_byte ];
+    }
+
+    crc   = next;
+    data += slices;
+    len  -= ( size_t )slices;
+  }
+
+  while( len-- )
+  {
+    crc = ( crc >> 8U ) ^ 
+          lut[ 0U ][ ( ( uint8_t )crc ) ^ *data++ ];
+  }
+
+  return crc;
+}
+
+
+uint64_t crc_lut_update( const crc_lut_tables_t* tables,
+                         const crc_param_t* crc_params, uint64_t crc,
+                         const uint8_t* data, size_t len, uint8_t slices )
+{
+  uint8_t shift;
+
+  if( crc_params->reflect_input )
+  {
+    crc = reflect_register( crc, crc_params->degree );
+    crc = crc_slice_reflected( tables->slice, data, len, crc, slices );
+    return reflect_register( crc, crc_params->degree );
+  }
+
+  shift = REGISTER_BITS - crc_params->degree;
+  return crc_slice( tables->slice, data, len, crc << shift, slices ) >> shift;
+}
+
+
+static void crc_algorithm_slicing( const uint8_t* data, const uint32_t len,
+                                   const crc_param_t* crc_params, uint64_t* p_crc,
+                                   uint8_t first_call,
+                                   uint8_t more_fragments,
+                                   const uint8_t slices )
+{
+  uint64_t crc = 0x0000000000000000UL;
+
+  if( len >= UINT32_MAX )
+  {
+    ( void )fprintf( stderr, "Invalid number of bytes passed to crc algorithm.\n" );
+    return;
+  }
+
+  crc = *p_crc;
+
+  if( first_call )
+  {
+    crc ^= get_param_value( &crc_params->initial_xor, crc_params->degree );
+  }
+
+  crc = crc_lut_update( lut_tables, crc_params, crc,
+                        data, ( size_t )len, slices );
+
+  if( !more_fragments )
+  {
+    if( crc_params->reflect_remainder )
+    {
+      crc = reflect_register( crc, crc_params->degree );
+    }
+
+    crc ^= get_param_value( &crc_params->final_xor, crc_params->degree );
+  }
+
+  *p_crc = crc;
+}
+
+
+void crc_algorithm_lut( const uint8_t* data, const uint32_t len,
+                        const crc_param_t* crc_params, uint64_t* p_crc,
+                        uint8_t first_call,
+                        uint8_t more_fragments )
+{
+  crc_algorithm_slicing( data, len, crc_params, p_crc, 
+                         first_call, more_fragments, 1U );
+}
+
+
+void crc_algorithm_slicing_4( const uint8_t* data, const uint32_t len,
+                              const crc_param_t* crc_params, uint64_t* p_crc,
+                              uint8_t first_call,
+                              uint8_t more_fragments )
+{
+  crc_algorithm_slicing( data, len, crc_params, p_crc, 
+                         first_call, more_fragments, 4U );
+}
+
+
+void crc_algorithm_slicing_8( const uint8_t* data, const uint32_t len,
+                              const crc_param_t* crc_params, uint64_t* p_crc,
+                              uint8_t first_call,
+                              uint8_t more_fragments )
+{
+  crc_algorithm_slicing( data, len, crc_params, p_crc, 
+                         first_call, more_fragments, 8U );
+}
+
+
+void crc_algorithm_slicing_16( const uint8_t* data, const uint32_t len,
+                               const crc_param_t* crc_params, uint64_t* p_crc,
+                               uint8_t first_call,
+                               uint8_t more_fragments )
+{
+  crc_algorithm_slicing( data, len, crc_params, p_crc, 
+                         first_call, more_fragments, 16U );
+}
+
+
+uint64_t crc_bitwise_update( const crc_param_t* crc_params, uint64_t crc,
+                             const uint8_t* data, size_t len )
+{
+  uint64_t poly = 0x0000000000000000UL;
+  size_t i;
+  uint8_t j, shift;
+
+  shift = REGISTER_BITS - crc_params->degree;
+  poly  = get_param_value( &crc_params->coeff, crc_params->degree );
+
+  if( crc_params->reflect_input )
+  {
+    /* shift register the other way round, LSB first */
+    poly = reflect_register( poly, crc_params->degree );
+    crc  = reflect_register( crc, crc_params->degree );
+
+    for( i = 0; i < len; i++ )
+    {
+      crc ^= ( uint64_t )*( data + i );
+
+      for( j = 0; j < 8; j++ )
+      {
+        if( crc & 0x0000000000000001UL )
+        {
+          crc = ( crc >> 1 ) ^ poly;
+        }
+        else
+        {
+          crc >>= 1;
+        }
+      }
+    }
+
+    return reflect_register( crc, crc_params->degree );
+  }
+
+  poly <<= shift;
+  crc  <<= shift;
+
+  for( i = 0; i < len; i++ )
+  {
+    crc ^= ( ( uint64_t )*( data + i ) ) << 56U;
+
+    for( j = 0; j < 8; j++ )
+    {
+      if( crc & TOP_BIT )
+      {
+        crc = ( crc << 1 ) ^ poly;
+      }
+      else
+      {
+        crc <<= 1;
+      }
+    }
+  }
+
+  return crc >> shift;
+}
+
+
+void crc_algorithm( const uint8_t* data, const uint32_t len,
+                    const crc_param_t* crc_params, uint64_t* p_crc,
+                    uint8_t first_call,
+                    uint8_t more_fragments )
+{
+  uint64_t crc = 0x0000000000000000UL;
+
+  if( len >= UINT32_MAX )
+  {
+    ( void )fprintf( stderr, "Invalid number of bytes passed to crc algorithm.\n" );
+    return;
+  }
+
+  crc = *p_crc;
+
+  if( first_call )
+  {
+    crc ^= get_param_value( &crc_params->initial_xor, crc_params->degree );
+  }
+
+  crc = crc_bitwise_update( crc_params, crc, data, ( size_t )len );
+
+  if( !more_fragments )
+  {
+    if( crc_params->reflect_remainder )
+    {
+      crc = reflect_register( crc, crc_params->degree );
+    }
+
+    crc ^= get_param_value( &crc_params->final_xor, crc_params->degree );
+  }
+
+  *p_crc = crc;
+}
+
+
+/* The side which waits more is the faster one: a stalled 
+ * reader means the kernel is the bottleneck, a stalled hasher
+ * (the caller of walk_file_pipe) waits for the disk. */
+static void print_pipe_stats( void )
+{
+  spsc_stats_t stats;
+
+  get_walk_file_pipe_stats( &stats );
+
+  ( void )fprintf( stdout, "Reader stalls: %lu (%.3f s), "
+                           "hasher stalls: %lu (%.3f s)\n",
+                           stats.producer_stalls, stats.producer_wait,
+                           stats.consumer_stalls, stats.consumer_wait );
+  ( void )fprintf( stdout, "Bottleneck: %s\n", 
+                           ( stats.producer_wait > stats.consumer_wait ) ? 
+                           "crc kernel" : "I/O" );
+}
+
+
+/* MB/s of the single table path on a sample buffer, 0.0 if 
+ * it can not be measured. The lookups do not depend on the data. */
+static double measure_lut_rate( void )
+{
+  uint8_t* sample = NULL;
+  uint64_t crc    = 0x0000000000000000UL;
+  double   seconds;
+
+  if( !( sample = ( uint8_t* )malloc( LUT_SAMPLE_BYTES ) ) )
+  {
+    return 0.0;
+  }
+  ( void )memset( ( void* )sample, 0x5A, LUT_SAMPLE_BYTES );
+
+  seconds = get_monotonic_seconds();
+  run_crc_algorithm( sample, LUT_SAMPLE_BYTES, OPT_LEVEL_LUT, &crc, 0xFFU, 0x00U );
+  seconds = get_monotonic_seconds() - seconds;
+  lut_sink ^= crc;
+
+  free( sample );
+
+  return ( seconds > 0.0 ) ? 
+         ( double )LUT_SAMPLE_BYTES * BYTES_TO_MEGABYTES / seconds : 0.0;
+}
+
+
+static void print_throughput( uint64_t bytes, double seconds,
+                              double lut_rate, double wall_seconds )
+{
+  double mb = ( double )bytes * BYTES_TO_MEGABYTES;
+
+  if( seconds <= 0.0 )
+  {
+    ( void )fprintf( stdout, "Too few bytes to measure the throughput.\n" );
+    return;
+  }
+
+  ( void )fprintf( stdout, "Throughput: %.1f MB/s\n", mb / seconds );
+  ( void )fprintf( stdout, "Including I/O (%s): %.1f MB/s\n", 
+                           stream_input ? "stream" : input_mode_names[ input_mode ],
+                           mb / wall_seconds );
+
+  if( ( input_mode == CRC_INPUT_PIPE ) && !stream_input )
+  {
+    print_pipe_stats();
+  }
+
+  if( lut_rate > 0.0 )
+  {
+    ( void )fprintf( stdout, "Single table: %.1f MB/s (speedup %.2fx)\n", 
+                             lut_rate, mb / seconds / lut_rate );
+  }
+}
+
+
+static void print_crc( uint64_t crc, uint8_t degree )
+{
+  ( void )fprintf( stdout, "CRC%d: 0x%0*lx\n", degree, 
+                           ( int )( ( degree + 3U ) / 4U ), crc );
+}
+
+
+static int compare_seconds( const void* a, const void* b )
+{
+  double d = *( const double* )a - *( const double* )b;
+
+  return ( d > 0.0 ) - ( d < 0.0 );
+}
+
+
+/* Small files are read with one read() into a buffer on the 
+ * stack, medium ones into the pool buffer. Only files larger than
+ * POOL_BUF_SIZE are read in chunks into a buffer of their own. */
+static uint8_t crc_of_file( crc_ctx_t* ctx, const char* file, uint64_t* p_crc )
+{
+  uint8_t  small_buf[ SMALL_FILE_SIZE ];
+  uint8_t* buf = NULL;
+  uint64_t left;
+  size_t   len;
+  ssize_t  bytes_read = 0;
+  struct stat file_stat;
+  int fd;
+  double stage_start;
+
+  stage_start = crc_stats_begin();
+
+  if( ( fd = open( file, O_RDONLY ) ) == ( -1 ) )
+  {
+    ( void )fprintf( stderr, "%s: %s\n", file, strerror( errno ) );
+    return 0x00U;
+  }
+
+  if( fstat( fd, &file_stat ) )
+  {
+    ( void )fprintf( stderr, "%s: %s\n", file, strerror( errno ) );
+    ( void )close( fd );
+    return 0x00U;
+  }
+
+  len = chunk_size ? chunk_size : FILE_BUF_SIZE;
+  if( S_ISREG( file_stat.st_mode ) && ( ( uint64_t )file_stat.st_size < ( uint64_t )len ) )
+  {
+    len = file_stat.st_size ? ( size_t )file_stat.st_size : 1U;
+  }
+  /* the length of the others is unknown, read to the end */
+  left = S_ISREG( file_stat.st_mode ) ? ( uint64_t )file_stat.st_size : UINT64_MAX;
+
+  if( len <= SMALL_FILE_SIZE )
+  {
+    buf = small_buf;
+  }
+  else if( len <= POOL_BUF_SIZE )
+  {
+    if( file_pool_len < len )
+    {
+      free( file_pool );
+      file_pool_len = 0U;
+      if( !( file_pool = ( uint8_t* )malloc( len ) ) )
+      {
+        ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+        ( void )close( fd );
+        exit( EXIT_FAILURE );
+      }
+      file_pool_len = len;
+    }
+    buf = file_pool;
+  }
+  else if( !( buf = ( uint8_t* )malloc( len ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    ( void )close( fd );
+    exit( EXIT_FAILURE );
+  }
+
+  crc_ctx_reset( ctx );
+  crc_stats_end( CRC_STAGE_OPEN, stage_start, 0UL );
+
+  /* the size is known from fstat, no read() for the end of file */
+  while( left )
+  {
+    stage_start = crc_stats_begin();
+    bytes_read = read( fd, ( void* )buf, len );
+    crc_stats_end( CRC_STAGE_READ, stage_start, ( bytes_read > 0 ) ? ( uint64_t )bytes_read : 0UL );
+    if( bytes_read <= 0 )
+    {
+      break;
+    }
+
+    stage_start = crc_stats_begin();
+    crc_ctx_update( ctx, ( const uint8_t* )buf, ( size_t )bytes_read );
+    crc_stats_end( CRC_STAGE_CRC, stage_start, ( uint64_t )bytes_read );
+    left -= ( ( uint64_t )bytes_read < left ) ? ( uint64_t )bytes_read : left;
+  }
+
+  if( left && ( bytes_read < 0 ) )
+  {
+    ( void )fprintf( stderr, "%s: %s\n", file, strerror( errno ) );
+  }
+
+  if( ( buf != small_buf ) && ( buf != file_pool ) )
+  {
+    free( buf );
+  }
+  ( void )close( fd );
+
+  *p_crc = crc_ctx_final( ctx );
+
+  return ( left && ( bytes_read < 0 ) ) ? 0x00U : 0xFFU;
+}
+
+
+static void run_crc_algorithm( const uint8_t* data, const uint32_t len, 
+                               uint8_t opt_level, uint64_t* p_crc,
+                               uint8_t first_call,
+                               uint8_t more_fragments )
+{
+  uint16_t crc16;
+
+  /* CRC16 has its own table kernels, which are 
+   * also part of the library api. */
+  if( ( polynomial.degree == 16U ) && 
+      ( opt_level != OPT_LEVEL_CLMUL ) && 
+      ( opt_level != OPT_LEVEL_SSE42 ) &&
+      ( opt_level != OPT_LEVEL_DISPATCH ) )
+  {
+    crc16 = ( uint16_t )*p_crc;
+    switch( opt_level )
+    {
+      case OPT_LEVEL_NONE:
+        crc16_algorithm( data, len, ( const crc_param_t* )&polynomial, &crc16,
+                         first_call, more_fragments );
+        break;
+      case OPT_LEVEL_LUT:
+        crc16_algorithm_lut( data, len, ( const crc_param_t* )&polynomial, &crc16,
+                             first_call, more_fragments );
+        break;
+      case OPT_LEVEL_SLICE_4:
+      case OPT_LEVEL_SLICE_8:
+      case OPT_LEVEL_SLICE_16:
+        crc16_algorithm_slicing( data, len, ( const crc_param_t* )&polynomial, &crc16,
+                                 first_call, more_fragments, opt_level );
+        break;
+    }
+    *p_crc = ( uint64_t )crc16;
+    return;
+  }
+
+  switch( opt_level )
+  {
+    case OPT_LEVEL_NONE:
+      crc_algorithm( data, len, ( const crc_param_t* )&polynomial, p_crc,
+                     first_call, more_fragments );
+      break;
+    case OPT_LEVEL_LUT:
+      crc_algorithm_lut( data, len, ( const crc_param_t* )&polynomial, p_crc,
+                         first_call, more_fragments );
+      break;
+    case OPT_LEVEL_SLICE_4:
+    case OPT_LEVEL_SLICE_8:
+    case OPT_LEVEL_SLICE_16:
+      crc_algorithm_slicing( data, len, ( const crc_param_t* )&polynomial, p_crc,
+                             first_call, more_fragments, opt_level );
+      break;
+    case OPT_LEVEL_CLMUL:
+      crc_algorithm_clmul( data, len, 
+                           ( const crc_param_t* )&polynomial, p_crc,
+                           first_call, more_fragments );
+      break;
+    case OPT_LEVEL_SSE42:
+      crc_algorithm_sse42( data, len, 
+                           ( const crc_param_t* )&polynomial, p_crc,
+                           first_call, more_fragments );
+      break;
+    case OPT_LEVEL_DISPATCH:
+      crc_algorithm_dispatch( data, len, ( const crc_param_t* )&polynomial, p_crc,
+                              first_call, more_fragments );
+      break;
+  }
+}
+
+
+static int32_t read_chunk( uint8_t** buf, const uint8_t** data, 
+                           const char* file, uint8_t* more_fragments )
+{
+  int32_t bytes_read;
+
+  if( stream_input )
+  {
+    return walk_stream( data, ( ssize_t )( chunk_size ? chunk_size : STREAM_BUF_SIZE ),
+                        file, more_fragments );
+  }
+
+  if( input_mode == CRC_INPUT_MMAP )
+  {
+    return walk_file_mmap( data, ( ssize_t )FILE_BUF_SIZE, file, more_fragments );
+  }
+
+  if( input_mode == CRC_INPUT_URING )
+  {
+    return walk_file_uring( data, 
+                            ( ssize_t )( chunk_size ? chunk_size : URING_BUF_SIZE ),
+                            queue_depth ? queue_depth : URING_QUEUE_DEPTH, 
+                            file, more_fragments );
+  }
+
+  if( ( input_mode == CRC_INPUT_DIRECT ) || ( input_mode == CRC_INPUT_NOCACHE ) )
+  {
+    return walk_file_direct( data, 
+                             ( ssize_t )( chunk_size ? chunk_size : DIRECT_BUF_SIZE ),
+                             ( input_mode == CRC_INPUT_DIRECT ) ? 0xFFU : 0x00U,
+                             file, more_fragments );
+  }
+
+  if( input_mode == CRC_INPUT_PIPE )
+  {
+    return walk_file_pipe( data, 
+                           ( ssize_t )( chunk_size ? chunk_size : PIPE_BUF_SIZE ),
+                           queue_depth ? queue_depth : PIPE_DEPTH, 
+                           file, more_fragments );
+  }
+
+  bytes_read = walk_file( buf, ( ssize_t )( chunk_size ? chunk_size : FILE_BUF_SIZE ), 
+                          file, more_fragments );
+  *data = *buf;
+
+  return bytes_read;
+}
+
+
+static void calculate_crc( const char* file, uint8_t opt_level )
+{
+  int32_t  bytes_read     = 0;
+  uint8_t* buf            = NULL;
+  const uint8_t* data     = NULL;
+  uint64_t crc            = 0x0000000000000000UL;
+  uint8_t  first_call     = 0xFFU;
+  uint8_t  more_fragments = 0xFFU;
+  uint64_t total_bytes    = 0UL;
+  double   seconds        = 0.0;
+  double   lut_rate       = 0.0;
+  double   wall_seconds   = 0.0;
+  double   resident       = 0.0;
+  double   start;
+
+  switch( opt_level )
+  {
+    case OPT_LEVEL_LUT:
+      init_lut_crc_16( ( const crc_param_t* )&polynomial );
+      init_lut_crc( ( const crc_param_t* )&polynomial );
+      break;
+    case OPT_LEVEL_SLICE_4:
+    case OPT_LEVEL_SLICE_8:
+    case OPT_LEVEL_SLICE_16:
+      init_lut_crc_16_slicing( ( const crc_param_t* )&polynomial );
+      init_lut_crc_slicing( ( const crc_param_t* )&polynomial );
+      break;
+    case OPT_LEVEL_CLMUL:
+      init_lut_crc_16( ( const crc_param_t* )&polynomial );
+      init_lut_crc( ( const crc_param_t* )&polynomial );
+      init_clmul_crc( ( const crc_param_t* )&polynomial );
+      break;
+    case OPT_LEVEL_SSE42:
+      init_lut_crc( ( const crc_param_t* )&polynomial );
+      init_crc32c_sse42();
+      break;
+    case OPT_LEVEL_DISPATCH:
+      init_lut_crc( ( const crc_param_t* )&polynomial );
+      ( void )fprintf( stdout, "Kernel: %s\n", 
+                       crc_kernel_name( init_crc_dispatch( 
+                                          ( const crc_param_t* )&polynomial ) ) );
+      break;
+  }
+  
+  stream_input = is_stream_input( file );
+  if( stream_input && ( input_mode != CRC_INPUT_READ ) )
+  {
+    ( void )fprintf( stdout, "The input is not a regular file, ignoring -i %s.\n",
+                             input_mode_names[ input_mode ] );
+  }
+
+  wall_seconds = get_monotonic_seconds();
+
+  while( ( bytes_read = read_chunk( &buf, &data, file, &more_fragments ) ) )
+  {
+    start = get_monotonic_seconds();
+    run_crc_algorithm( data, ( const uint32_t )bytes_read, opt_level, &crc,
+                       first_call, more_fragments );
+    seconds += get_monotonic_seconds() - start;
+    crc_stats_end( CRC_STAGE_CRC, start, ( uint64_t )bytes_read );
+    total_bytes += ( uint64_t )bytes_read;
+
+    if( first_call )
+    {
+      first_call = 0x00U;
+    }
+  }
+
+  /* An empty input never enters the loop, its checksum
+   * is the initial value through the final step. */
+  if( !total_bytes )
+  {
+    run_crc_algorithm( data, 0U, opt_level, &crc, first_call, 0x00U );
+  }
+  wall_seconds = get_monotonic_seconds() - wall_seconds;
+
+  /* Only the slicing levels are compared with the single table 
+   * path, and only for inputs of at least the sample size. The 
+   * rate of a shorter run is dominated by its start up. */
+  if( ( opt_level >= OPT_LEVEL_SLICE_4 ) && ( opt_level <= OPT_LEVEL_SLICE_16 ) &&
+      ( total_bytes >= ( uint64_t )LUT_SAMPLE_BYTES ) )
+  {
+    lut_rate = measure_lut_rate();
+  }
+
+  print_crc( crc, polynomial.degree );
+  print_throughput( total_bytes, seconds, lut_rate, wall_seconds );
+
+  if( ( ( input_mode == CRC_INPUT_DIRECT ) || ( input_mode == CRC_INPUT_NOCACHE ) ) &&
+      !stream_input )
+  {
+    resident = get_file_cache_residency( file );
+    if( resident >= 0.0 )
+    {
+      ( void )fprintf( stdout, "Page cache: %.1f%% of the file resident\n", resident );
+    }
+  }
+}
+
+
+void set_bytewise_input_mode( uint8_t mode )
+{
+  switch( mode )
+  {
+    case CRC_INPUT_READ:
+    case CRC_INPUT_MMAP:
+    case CRC_INPUT_URING:
+    case CRC_INPUT_PIPE:
+    case CRC_INPUT_DIRECT:
+    case CRC_INPUT_NOCACHE:
+      input_mode = mode;
+      break;
+    default:
+      ( void )fprintf( stderr, "Unsupported input mode: %d\n", mode );
+      break;
+  }
+}
+
+
+void set_bytewise_queue_depth( uint32_t depth )
+{
+  if( ( depth < 1U ) || ( depth > URING_MAX_QUEUE_DEPTH ) || 
+      ( depth > PIPE_MAX_DEPTH ) )
+  {
+    ( void )fprintf( stderr, "Unsupported queue depth: %u\n", depth );
+    return;
+  }
+  queue_depth = depth;
+}
+
+
+void set_bytewise_chunk_size( size_t size )
+{
+  if( size > ( size_t )INT32_MAX )
+  {
+    ( void )fprintf( stderr, "Unsupported chunk size: %lu\n", size );
+    return;
+  }
+  chunk_size = size;
+}
+
+
+void set_bytewise_params( const crc_param_t* crc_params )
+{
+  if( !crc_params )
+  {
+    custom_set = 0x00U;
+    return;
+  }
+  custom_polynomial = *crc_params;
+  custom_set = 0xFFU;
+}
+
+
+void calculate_crc_of_files( const char* const* files, uint32_t n, 
+                             uint8_t polynomial_degree, uint8_t kernel )
+{
+  crc_ctx_t* ctx     = NULL;
+  double* latencies  = NULL;
+  uint64_t crc       = 0x0000000000000000UL;
+  uint32_t i;
+  uint32_t done      = 0U;
+  double   start;
+  double   total     = 0.0;
+
+  init_polynomial_even( polynomial_degree );
+  if( !crc_calc_func || !n )
+  {
+    return;
+  }
+
+  if( input_mode != CRC_INPUT_READ )
+  {
+    ( void )fprintf( stdout, "Several files are read with -i read, ignoring -i %s.\n",
+                             input_mode_names[ input_mode ] );
+  }
+
+  if( ( kernel == CRC_KERNEL_SSE42 ) && !use_polynomial_32c( polynomial_degree ) )
+  {
+    return;
+  }
+
+  /* honours a kernel forced with crc_force_kernel */
+  if( kernel == CRC_KERNEL_AUTO )
+  {
+    kernel = crc_select_kernel( ( const crc_param_t* )&polynomial );
+  }
+
+  if( !( ctx = crc_ctx_init( ( const crc_param_t* )&polynomial, kernel ) ) ||
+      !( latencies = ( double* )malloc( n * sizeof( double ) ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    crc_ctx_free( ctx );
+    exit( EXIT_FAILURE );
+  }
+
+  ( void )fprintf( stdout, "Kernel: %s\n", crc_kernel_name( crc_ctx_kernel( ctx ) ) );
+
+  for( i = 0U; i < n; i++ )
+  {
+    start = get_monotonic_seconds();
+    if( crc_of_file( ctx, *( files + i ), &crc ) )
+    {
+      latencies[ done ] = get_monotonic_seconds() - start;
+      total += latencies[ done ];
+      done++;
+      ( void )fprintf( stdout, "%0*lx  %s\n", 
+                               ( int )( ( polynomial.degree + 3U ) / 4U ), crc, 
+                               *( files + i ) );
+    }
+  }
+
+  if( done )
+  {
+    qsort( ( void* )latencies, done, sizeof( double ), &compare_seconds );
+    ( void )fprintf( stdout, "Files: %u of %u in %.3f s\n", done, n, total );
+    ( void )fprintf( stdout, "Latency per file: p50 %.1f us, p99 %.1f us\n",
+                             latencies[ ( done - 1U ) / 2U ] * 1e6,
+                             latencies[ ( uint32_t )( ( uint64_t )( done - 1U ) * 99U / 100U ) ] * 1e6 );
+  }
+
+  free( file_pool );
+  file_pool     = NULL;
+  file_pool_len = 0U;
+  free( latencies );
+  crc_ctx_free( ctx );
+}
+
+
+void calculate_crc_from_file_bytewise( const char* file, 
+                                       uint8_t polynomial_degree )
+{
+  init_polynomial_even( polynomial_degree );
+  if( crc_calc_func )
+  {
+    crc_calc_func( file, OPT_LEVEL_NONE );
+  }
+}
+
+
+void calculate_crc_from_file_bytewise_lut( const char* file, 
+                                           uint8_t polynomial_degree )
+{
+  init_polynomial_even( polynomial_degree );
+  if( crc_calc_func )
+  {
+    crc_calc_func( file, OPT_LEVEL_LUT );
+  }
+}
+
+
+void calculate_crc_from_file_bytewise_slicing( const char* file, 
+                                               uint8_t polynomial_degree,
+                                               uint8_t slices )
+{
+  init_polynomial_even( polynomial_degree );
+  if( !crc_calc_func )
+  {
+    return;
+  }
+
+  switch( slices )
+  {
+    case OPT_LEVEL_SLICE_4:
+    case OPT_LEVEL_SLICE_8:
+    case OPT_LEVEL_SLICE_16:
+      crc_calc_func( file, slices );
+      break;
+    default:
+      ( void )fprintf( stderr, "Unsupported number of slices: %d\n", slices );
+      break;
+  }
+}
+
+
+void calculate_crc_from_file_bytewise_clmul( const char* file, 
+                                             uint8_t polynomial_degree )
+{
+  init_polynomial_even( polynomial_degree );
+  if( !crc_calc_func )
+  {
+    return;
+  }
+
+  if( !crc_clmul_supported() )
+  {
+    ( void )fprintf( stdout, "The cpu does not support PCLMULQDQ, "
+                             "falling back to a lookup table.\n" );
+  }
+  crc_calc_func( file, OPT_LEVEL_CLMUL );
+}
+
+
+void calculate_crc_from_file_bytewise_sse42( const char* file, 
+                                             uint8_t polynomial_degree )
+{
+  init_polynomial_even( polynomial_degree );
+  if( !crc_calc_func || !use_polynomial_32c( polynomial_degree ) )
+  {
+    return;
+  }
+
+  if( !crc_sse42_supported() )
+  {
+    ( void )fprintf( stdout, "The cpu does not support SSE4.2, "
+                             "falling back to a lookup table.\n" );
+  }
+  crc_calc_func( file, OPT_LEVEL_SSE42 );
+}
+
+
+void calculate_crc_from_file_bytewise_dispatch( const char* file, 
+                                                uint8_t polynomial_degree )
+{
+  init_polynomial_even( polynomial_degree );
+  if( crc_calc_func )
+  {
+    crc_calc_func( file, OPT_LEVEL_DISPATCH );
+  }
+}
+
+
+void print_dispatch_report( FILE* out )
+{
+  const crc_param_t* params[] = { &polynomial_3,  &polynomial_8,
+                                  &polynomial_16, &polynomial_32,
+                                  &polynomial_32c, &polynomial_64 };
+  const char* names[] = { "CRC3", "CRC8", "CRC16", "CRC32", "CRC32C", "CRC64" };
+  uint8_t i;
+
+  ( void )fprintf( out, "cpu features: pclmul %s, sse4.2 %s\n",
+                        crc_clmul_supported() ? "yes" : "no",
+                        crc_sse42_supported() ? "yes" : "no" );
+
+  for( i = 0U; i < ( uint8_t )( sizeof( params ) / sizeof( params[ 0 ] ) ); i++ )
+  {
+    ( void )fprintf( out, "%-7s -> %s\n", names[ i ],
+                          crc_kernel_name( crc_select_kernel( params[ i ] ) ) );
+  }
+}
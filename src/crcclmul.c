@@ -0,0 +1,576 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcclmul.c
+ *
+ *
+ * Purpose:   This module holds a CRC kernel
+ *            which folds the input stream with
+ *            carry-less multiplications
+ *            (PCLMULQDQ) and finishes with
+ *            a Barrett reduction.
+ *
+ *
+ * Remarks:   - Works for every polynomial degree
+ *              up to 64. The crc register is left
+ *              aligned in a 64 bit word, i. e. the
+ *              folding is done modulo P(x) * x^(64 - degree).
+ *
+ *            - Reflected input is folded in the reflected
+ *              domain with bit reversed constants and is
+ *              only converted once before the reduction.
+ *              The data passed in is never written.
+ *
+ *            - Inputs shorter than one 64 byte block
+ *              and the trailing bytes are processed
+ *              with a lookup table.
+ *
+ *            - crc_clmul_lanes folds several messages
+ *              at once for crc_batch (crcbatch.c), one
+ *              128 bit remainder per message.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crctypes.h>
+#include <crcapi.h>
+#include <crckernel.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#define CLMUL_AVAILABLE
+#include <immintrin.h>
+#define CLMUL_TARGET __attribute__( ( target( "pclmul,ssse3" ) ) )
+#endif
+
+
+#define REGISTER_BITS 64U
+#define TOP_BIT       0x8000000000000000UL
+
+#define FOLD_BLOCK    64U /* unit is bytes */
+#define XMM_BYTES     16U /* unit is bytes */
+
+
+static crc_clmul_consts_t consts;
+
+
+static uint64_t xpow_mod( uint32_t n, uint64_t poly );
+static uint64_t barrett_mu( uint64_t poly );
+static uint64_t reversed( uint64_t value );
+static inline uint64_t crc_table( const crc_clmul_consts_t* c,
+                                  const uint8_t* data, size_t len,
+                                  uint64_t crc, uint8_t reflect );
+
+void init_clmul_crc( const crc_param_t* crc_params );
+uint8_t crc_clmul_supported( void );
+void crc_algorithm_clmul( const uint8_t* data, const uint32_t len,
+                          const crc_param_t* crc_params, uint64_t* p_crc,
+                          uint8_t first_call,
+                          uint8_t more_fragments );
+
+
+static uint64_t xpow_mod( uint32_t n, uint64_t poly )
+{
+  uint64_t r = 0x0000000000000001UL;
+  uint32_t i;
+
+  for( i = 0U; i < n; i++ )
+  {
+    if( r & TOP_BIT )
+    {
+      r = ( r << 1U ) ^ poly;
+    }
+    else
+    {
+      r <<= 1U;
+    }
+  }
+  return r;
+}
+
+
+static uint64_t barrett_mu( uint64_t poly )
+{
+  uint64_t r = 0x0000000000000000UL;
+  uint64_t q = 0x0000000000000000UL;
+  int16_t i;
+
+  /* Long division of x^128, one dividend bit after
+   * the other. Every time the x^64 coefficient
+   * overflows, P' is subtracted and the according
+   * quotient bit is set. */
+  for( i = 128; i >= 0; i-- )
+  {
+    uint64_t top = r & TOP_BIT;
+
+    r = ( r << 1U ) | ( ( i == 128 ) ? 1UL : 0UL );
+    if( top )
+    {
+      r ^= poly;
+      if( i < 64 )
+      {
+        q |= ( 1UL << i );
+      }
+    }
+  }
+  return q;
+}
+
+
+static uint64_t reversed( uint64_t value )
+{
+  reflect_bits_64( &value, 1U );
+  return value;
+}
+
+
+void crc_clmul_build( crc_clmul_consts_t* c, const crc_param_t* crc_params )
+{
+  uint16_t i;
+  uint8_t j, b, shift;
+  uint64_t cur_byte;
+
+  shift = REGISTER_BITS - crc_params->degree;
+
+  c->degree = crc_params->degree;
+  c->poly   = get_param_value( &crc_params->coeff, crc_params->degree ) << shift;
+
+  c->fold_512[ 1 ] = xpow_mod( 512U + 64U, c->poly );
+  c->fold_512[ 0 ] = xpow_mod( 512U, c->poly );
+  c->fold_128[ 1 ] = xpow_mod( 128U + 64U, c->poly );
+  c->fold_128[ 0 ] = xpow_mod( 128U, c->poly );
+  c->mu            = barrett_mu( c->poly );
+
+  c->fold_512_r[ 1 ] = reversed( xpow_mod( 512U - 1U, c->poly ) );
+  c->fold_512_r[ 0 ] = reversed( xpow_mod( 512U + 63U, c->poly ) );
+  c->fold_128_r[ 1 ] = reversed( xpow_mod( 128U - 1U, c->poly ) );
+  c->fold_128_r[ 0 ] = reversed( xpow_mod( 128U + 63U, c->poly ) );
+
+  for( i = 0U; i < 0x100U; i++ )
+  {
+    cur_byte = ( ( uint64_t )i << 56U );
+
+    for( j = 0U; j < 8U; j++ )
+    {
+      if( cur_byte & TOP_BIT )
+      {
+        cur_byte = ( cur_byte << 1U ) ^ c->poly;
+      }
+      else
+      {
+        cur_byte <<= 1U;
+      }
+    }
+    c->lut[ i ] = cur_byte;
+
+    b = ( uint8_t )i;
+    reflect_bits_8( &b, 1U );
+    c->reflect_lut[ i ] = b;
+  }
+}
+
+
+void init_clmul_crc( const crc_param_t* crc_params )
+{
+  crc_clmul_build( &consts, crc_params );
+}
+
+
+static inline uint64_t crc_table( const crc_clmul_consts_t* c,
+                                  const uint8_t* data, size_t len,
+                                  uint64_t crc, uint8_t reflect )
+{
+  uint8_t cur_byte;
+
+  while( len-- )
+  {
+    cur_byte = reflect ? c->reflect_lut[ *data ] : *data;
+    crc = ( crc << 8U ) ^ c->lut[ ( ( uint8_t )( crc >> 56U ) ) ^ cur_byte ];
+    data++;
+  }
+  return crc;
+}
+
+
+#ifdef CLMUL_AVAILABLE
+
+CLMUL_TARGET
+static inline __m128i load_block( const uint8_t* data, const uint8_t reflect )
+{
+  const __m128i bswap = _mm_set_epi8(  0,  1,  2,  3,  4,  5,  6,  7,
+                                       8,  9, 10, 11, 12, 13, 14, 15 );
+  __m128i x;
+
+  x = _mm_loadu_si128( ( const __m128i* )data );
+
+  /* Reflected input is already in the reflected domain. Otherwise
+   * the first message bit ends up as coefficient of x^127. */
+  return reflect ? x : _mm_shuffle_epi8( x, bswap );
+}
+
+
+CLMUL_TARGET
+static inline uint64_t high_quad( __m128i x )
+{
+  return ( uint64_t )_mm_cvtsi128_si64( _mm_unpackhi_epi64( x, x ) );
+}
+
+
+CLMUL_TARGET
+static inline __m128i fold( __m128i x, __m128i k )
+{
+  return _mm_xor_si128( _mm_clmulepi64_si128( x, k, 0x11 ),
+                        _mm_clmulepi64_si128( x, k, 0x00 ) );
+}
+
+
+/* the 128 bit remainder of the folded blocks to the
+ * left aligned register in the normal domain */
+CLMUL_TARGET
+static inline uint64_t reduce( const crc_clmul_consts_t* c, __m128i x,
+                               const uint8_t reflect )
+{
+  __m128i k, t;
+  uint64_t hi, q;
+
+  if( reflect )
+  {
+    /* back to the normal domain */
+    x = _mm_set_epi64x( ( int64_t )reversed( ( uint64_t )_mm_cvtsi128_si64( x ) ),
+                        ( int64_t )reversed( high_quad( x ) ) );
+  }
+  k = _mm_set_epi64x( ( int64_t )c->fold_128[ 1 ],
+                      ( int64_t )c->fold_128[ 0 ] );
+
+  /* The register is R(x) * x^64 mod P'. The upper half
+   * of R(x) is shifted by another 64 bit and reduced
+   * with x^128 mod P', which leaves a 128 bit value T(x). */
+  t = _mm_xor_si128( _mm_clmulepi64_si128( x, k, 0x01 ),
+                     _mm_slli_si128( x, 8 ) );
+
+  /* Barrett reduction of T(x):
+   * q = floor( T / P' ), crc = T - q * P' */
+  hi = high_quad( t );
+  q  = hi ^ high_quad( _mm_clmulepi64_si128( _mm_set_epi64x( 0, ( int64_t )hi ),
+                                             _mm_set_epi64x( 0, ( int64_t )c->mu ),
+                                             0x00 ) );
+  return ( uint64_t )_mm_cvtsi128_si64( t ) ^
+         ( uint64_t )_mm_cvtsi128_si64(
+                       _mm_clmulepi64_si128( _mm_set_epi64x( 0, ( int64_t )q ),
+                                             _mm_set_epi64x( 0, ( int64_t )c->poly ),
+                                             0x00 ) );
+}
+
+
+CLMUL_TARGET
+static inline uint64_t clmul_fold( const crc_clmul_consts_t* c,
+                                   const uint8_t* data, size_t len,
+                                   uint64_t crc, const uint8_t reflect )
+{
+  __m128i x0, x1, x2, x3, k;
+
+  x0 = load_block( data,      reflect );
+  x1 = load_block( data + 16, reflect );
+  x2 = load_block( data + 32, reflect );
+  x3 = load_block( data + 48, reflect );
+
+  /* the initial register is added to the first 64 message bits */
+  if( reflect )
+  {
+    x0 = _mm_xor_si128( x0, _mm_set_epi64x( 0, ( int64_t )reversed( crc ) ) );
+    k  = _mm_set_epi64x( ( int64_t )c->fold_512_r[ 1 ],
+                         ( int64_t )c->fold_512_r[ 0 ] );
+  }
+  else
+  {
+    x0 = _mm_xor_si128( x0, _mm_set_epi64x( ( int64_t )crc, 0 ) );
+    k  = _mm_set_epi64x( ( int64_t )c->fold_512[ 1 ],
+                         ( int64_t )c->fold_512[ 0 ] );
+  }
+
+  data += FOLD_BLOCK;
+  len  -= FOLD_BLOCK;
+
+  while( len >= FOLD_BLOCK )
+  {
+    x0 = _mm_xor_si128( fold( x0, k ), load_block( data,      reflect ) );
+    x1 = _mm_xor_si128( fold( x1, k ), load_block( data + 16, reflect ) );
+    x2 = _mm_xor_si128( fold( x2, k ), load_block( data + 32, reflect ) );
+    x3 = _mm_xor_si128( fold( x3, k ), load_block( data + 48, reflect ) );
+
+    data += FOLD_BLOCK;
+    len  -= FOLD_BLOCK;
+  }
+
+  if( reflect )
+  {
+    k = _mm_set_epi64x( ( int64_t )c->fold_128_r[ 1 ],
+                        ( int64_t )c->fold_128_r[ 0 ] );
+  }
+  else
+  {
+    k = _mm_set_epi64x( ( int64_t )c->fold_128[ 1 ],
+                        ( int64_t )c->fold_128[ 0 ] );
+  }
+
+  x1 = _mm_xor_si128( fold( x0, k ), x1 );
+  x2 = _mm_xor_si128( fold( x1, k ), x2 );
+  x3 = _mm_xor_si128( fold( x2, k ), x3 );
+
+  while( len >= XMM_BYTES )
+  {
+    x3 = _mm_xor_si128( fold( x3, k ), load_block( data, reflect ) );
+    data += XMM_BYTES;
+    len  -= XMM_BYTES;
+  }
+
+  return crc_table( c, data, len, reduce( c, x3, reflect ), reflect );
+}
+
+
+CLMUL_TARGET
+static uint64_t clmul_fold_normal( const crc_clmul_consts_t* c,
+                                   const uint8_t* data, size_t len, uint64_t crc )
+{
+  return clmul_fold( c, data, len, crc, 0x00U );
+}
+
+
+CLMUL_TARGET
+static uint64_t clmul_fold_reflected( const crc_clmul_consts_t* c,
+                                      const uint8_t* data, size_t len, uint64_t crc )
+{
+  return clmul_fold( c, data, len, crc, 0xFFU );
+}
+
+
+/* The lanes are copied into locals, so the remainders stay in
+ * registers and the folds of the lanes overlap. */
+CLMUL_TARGET
+static void clmul_lanes( const crc_clmul_consts_t* c, uint64_t ( *acc )[ 2 ],
+                         const uint8_t** data, size_t blocks, const uint8_t reflect )
+{
+  __m128i x[ CRC_BATCH_LANES ];
+  const uint8_t* p[ CRC_BATCH_LANES ];
+  __m128i k;
+  uint8_t l;
+
+  k = reflect ? _mm_set_epi64x( ( int64_t )c->fold_128_r[ 1 ],
+                                ( int64_t )c->fold_128_r[ 0 ] ) :
+                _mm_set_epi64x( ( int64_t )c->fold_128[ 1 ],
+                                ( int64_t )c->fold_128[ 0 ] );
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    x[ l ] = _mm_loadu_si128( ( const __m128i* )acc[ l ] );
+    p[ l ] = data[ l ];
+  }
+
+  while( blocks-- )
+  {
+    for( l = 0U; l < CRC_BATCH_LANES; l++ )
+    {
+      x[ l ] = _mm_xor_si128( fold( x[ l ], k ), load_block( p[ l ], reflect ) );
+      p[ l ] += XMM_BYTES;
+    }
+  }
+
+  for( l = 0U; l < CRC_BATCH_LANES; l++ )
+  {
+    _mm_storeu_si128( ( __m128i* )acc[ l ], x[ l ] );
+    data[ l ] = p[ l ];
+  }
+}
+
+
+CLMUL_TARGET
+static void clmul_lanes_normal( const crc_clmul_consts_t* c, uint64_t ( *acc )[ 2 ],
+                                const uint8_t** data, size_t blocks )
+{
+  clmul_lanes( c, acc, data, blocks, 0x00U );
+}
+
+
+CLMUL_TARGET
+static void clmul_lanes_reflected( const crc_clmul_consts_t* c, uint64_t ( *acc )[ 2 ],
+                                   const uint8_t** data, size_t blocks )
+{
+  clmul_lanes( c, acc, data, blocks, 0xFFU );
+}
+
+
+CLMUL_TARGET
+static void clmul_lane_start( uint64_t* acc, uint64_t crc, const uint8_t* data,
+                              const uint8_t reflect )
+{
+  __m128i x;
+
+  /* the register is added to the first 64 message bits */
+  x = _mm_xor_si128( load_block( data, reflect ),
+                     reflect ? _mm_set_epi64x( 0, ( int64_t )crc ) :
+                               _mm_set_epi64x( ( int64_t )crc, 0 ) );
+  _mm_storeu_si128( ( __m128i* )acc, x );
+}
+
+
+CLMUL_TARGET
+static uint64_t clmul_lane_finish( const crc_clmul_consts_t* c, const uint64_t* acc,
+                                   const uint8_t reflect )
+{
+  uint64_t crc;
+
+  crc = reduce( c, _mm_loadu_si128( ( const __m128i* )acc ), reflect );
+  return reflect ? reversed( crc ) : crc;
+}
+
+#endif /* CLMUL_AVAILABLE */
+
+
+void crc_clmul_lanes( const crc_clmul_consts_t* c, uint8_t reflect,
+                      uint64_t ( *acc )[ 2 ], const uint8_t** data, size_t blocks )
+{
+#ifdef CLMUL_AVAILABLE
+  if( reflect )
+  {
+    clmul_lanes_reflected( c, acc, data, blocks );
+  }
+  else
+  {
+    clmul_lanes_normal( c, acc, data, blocks );
+  }
+#else
+  ( void )c;
+  ( void )reflect;
+  ( void )acc;
+  ( void )data;
+  ( void )blocks;
+#endif
+}
+
+
+void crc_clmul_lane_start( uint64_t* acc, uint8_t reflect, uint64_t crc,
+                           const uint8_t* data )
+{
+#ifdef CLMUL_AVAILABLE
+  if( reflect )
+  {
+    clmul_lane_start( acc, crc, data, 0xFFU );
+  }
+  else
+  {
+    clmul_lane_start( acc, crc, data, 0x00U );
+  }
+#else
+  ( void )acc;
+  ( void )reflect;
+  ( void )crc;
+  ( void )data;
+#endif
+}
+
+
+uint64_t crc_clmul_lane_finish( const crc_clmul_consts_t* c, uint8_t reflect,
+                                const uint64_t* acc )
+{
+#ifdef CLMUL_AVAILABLE
+  return reflect ? clmul_lane_finish( c, acc, 0xFFU ) :
+                   clmul_lane_finish( c, acc, 0x00U );
+#else
+  ( void )c;
+  ( void )reflect;
+  ( void )acc;
+  return 0UL;
+#endif
+}
+
+
+uint64_t crc_clmul_update( const crc_clmul_consts_t* c,
+                           const crc_param_t* crc_params, uint64_t crc,
+                           const uint8_t* data, size_t len )
+{
+  uint8_t shift;
+
+  shift = REGISTER_BITS - crc_params->degree;
+  crc <<= shift;
+
+#ifdef CLMUL_AVAILABLE
+  if( len >= FOLD_BLOCK && crc_clmul_supported() )
+  {
+    crc = crc_params->reflect_input ? clmul_fold_reflected( c, data, len, crc ) :
+                                      clmul_fold_normal( c, data, len, crc );
+  }
+  else
+#endif
+  {
+    crc = crc_table( c, data, len, crc, crc_params->reflect_input );
+  }
+
+  return crc >> shift;
+}
+
+
+uint8_t crc_clmul_supported( void )
+{
+#ifdef CLMUL_AVAILABLE
+  __builtin_cpu_init();
+  return ( __builtin_cpu_supports( "pclmul" ) &&
+           __builtin_cpu_supports( "ssse3" ) ) ? 0xFFU : 0x00U;
+#else
+  return 0x00U;
+#endif
+}
+
+
+void crc_algorithm_clmul( const uint8_t* data, const uint32_t len,
+                          const crc_param_t* crc_params, uint64_t* p_crc,
+                          uint8_t first_call,
+                          uint8_t more_fragments )
+{
+  uint64_t crc = 0x0000000000000000UL;
+
+  if( len >= UINT32_MAX )
+  {
+    ( void )fprintf( stderr, "Invalid number of bytes passed to crc algorithm.\n" );
+    return;
+  }
+
+  if( consts.degree != crc_params->degree )
+  {
+    ( void )fprintf( stderr, "Constants were not initialized for this polynomial.\n" );
+    return;
+  }
+
+  crc = *p_crc;
+
+  if( first_call )
+  {
+    crc ^= get_param_value( &crc_params->initial_xor, crc_params->degree );
+  }
+
+  crc = crc_clmul_update( ( const crc_clmul_consts_t* )&consts, crc_params, crc,
+                          data, ( size_t )len );
+
+  if( !more_fragments )
+  {
+    if( crc_params->reflect_remainder )
+    {
+      reflect_bits_64( &crc, 1U );
+      crc >>= ( REGISTER_BITS - crc_params->degree );
+    }
+
+    crc ^= get_param_value( &crc_params->final_xor, crc_params->degree );
+  }
+
+  *p_crc = crc;
+}
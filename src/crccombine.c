@@ -0,0 +1,148 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crccombine.c
+ *
+ *
+ * Purpose:   This module combines the checksums of two
+ *            adjacent blocks A and B into the checksum of
+ *            A || B, without touching the data again
+ *            (like zlib's crc32_combine).
+ *
+ *
+ * Remarks:   - Appending n zero bytes to a message
+ *              multiplies its crc register by x^(8 * n)
+ *              modulo P. The powers x^(8 * 2^k) mod P are
+ *              precomputed, so a combination costs one
+ *              multiplication per set bit of len( B ).
+ *
+ *            - Works for every parameter set up to degree
+ *              64, the register is left aligned in a 64 bit
+ *              word as in the table kernels.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crctypes.h>
+#include <crcapi.h>
+#include <util.h>
+
+#include <stdint.h>
+
+
+#define REGISTER_BITS 64U
+#define TOP_BIT       0x8000000000000000UL
+
+
+static inline uint64_t multiply_mod( uint64_t a, uint64_t b, 
+                                     uint64_t poly, uint8_t degree );
+static uint64_t unfinalize( const crc_param_t* crc_params, uint64_t crc );
+
+void init_crc_combine( crc_combine_t* comb, const crc_param_t* crc_params );
+uint64_t crc_combine( const crc_combine_t* comb, uint64_t crc_a, 
+                      uint64_t crc_b, uint64_t len_b );
+
+
+/* a * b mod P, all of them left aligned. Horner's scheme 
+ * over the degree coefficients of a, highest power first. */
+static inline uint64_t multiply_mod( uint64_t a, uint64_t b, 
+                                     uint64_t poly, uint8_t degree )
+{
+  uint64_t p = 0x0000000000000000UL;
+  uint8_t i;
+
+  for( i = 0U; i < degree; i++ )
+  {
+    p = ( p & TOP_BIT ) ? ( p << 1U ) ^ poly : ( p << 1U );
+
+    if( a & ( TOP_BIT >> i ) )
+    {
+      p ^= b;
+    }
+  }
+  return p;
+}
+
+
+/* back from the checksum to the plain register */
+static uint64_t unfinalize( const crc_param_t* crc_params, uint64_t crc )
+{
+  crc ^= get_param_value( &crc_params->final_xor, crc_params->degree );
+
+  if( crc_params->reflect_remainder )
+  {
+    reflect_bits_64( &crc, 1U );
+    crc >>= ( REGISTER_BITS - crc_params->degree );
+  }
+
+  return crc;
+}
+
+
+void init_crc_combine( crc_combine_t* comb, const crc_param_t* crc_params )
+{
+  uint64_t xpow;
+  uint8_t shift, i;
+
+  shift = REGISTER_BITS - crc_params->degree;
+
+  comb->params = *crc_params;
+  comb->poly   = get_param_value( &crc_params->coeff, crc_params->degree ) << shift;
+
+  /* x^0, then multiplied by x eight times */
+  xpow = 0x0000000000000001UL << shift;
+  for( i = 0U; i < 8U; i++ )
+  {
+    xpow = ( xpow & TOP_BIT ) ? ( xpow << 1U ) ^ comb->poly : ( xpow << 1U );
+  }
+
+  /* x^(8 * 2^k) = ( x^(8 * 2^(k - 1)) )^2 */
+  for( i = 0U; i < CRC_COMBINE_POWERS; i++ )
+  {
+    comb->xpow[ i ] = xpow;
+    xpow = multiply_mod( xpow, xpow, comb->poly, crc_params->degree );
+  }
+}
+
+
+uint64_t crc_combine( const crc_combine_t* comb, uint64_t crc_a, 
+                      uint64_t crc_b, uint64_t len_b )
+{
+  const crc_param_t* crc_params = &comb->params;
+  uint64_t init, reg;
+  uint8_t shift, k;
+
+  shift = REGISTER_BITS - crc_params->degree;
+  init  = get_param_value( &crc_params->initial_xor, crc_params->degree );
+
+  /* The register after B started with init. The part of it 
+   * which init contributed is replaced by the register after A,
+   * both are shifted over len( B ) zero bytes. */
+  reg = ( unfinalize( crc_params, crc_a ) ^ init ) << shift;
+
+  for( k = 0U; len_b; k++, len_b >>= 1U )
+  {
+    if( len_b & 1U )
+    {
+      reg = multiply_mod( reg, comb->xpow[ k ], comb->poly, crc_params->degree );
+    }
+  }
+
+  reg = ( reg >> shift ) ^ unfinalize( crc_params, crc_b );
+
+  if( crc_params->reflect_remainder )
+  {
+    reflect_bits_64( &reg, 1U );
+    reg >>= shift;
+  }
+
+  return reg ^ get_param_value( &crc_params->final_xor, crc_params->degree );
+}
+
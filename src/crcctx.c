@@ -0,0 +1,220 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcctx.c
+ *
+ *
+ * Purpose:   This module holds the re-entrant streaming
+ *            api. A context carries the parameter set,
+ *            the kernel, its precomputed tables and the
+ *            running crc register, so any number of
+ *            streams can be hashed concurrently.
+ *
+ *
+ * Remarks:   - Only crc_ctx_init allocates. Updates do
+ *              neither allocate nor lock, contexts must
+ *              not be shared between threads without
+ *              synchronisation though.
+ *
+ *            - Lengths are size_t, there is no need to
+ *              split the input into 32 bit fragments.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crctypes.h>
+#include <crcapi.h>
+#include <crckernel.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+
+#define REGISTER_BITS 64U
+
+
+struct crc_ctx
+{
+  crc_param_t params;
+
+  /* plain register, not reflected and without final xor */
+  uint64_t crc;
+
+  uint8_t kernel;
+  uint8_t slices;
+
+  /* generated tables or the ones of the union */
+  const crc_lut_tables_t* lut;
+
+  union
+  {
+    crc_lut_tables_t   lut;
+    crc_clmul_consts_t clmul;
+    crc32c_tables_t    crc32c;
+  } tables;
+};
+
+
+static uint8_t pick_kernel( const crc_param_t* crc_params, uint8_t kernel );
+
+crc_ctx_t* crc_ctx_init( const crc_param_t* crc_params, uint8_t kernel );
+void crc_ctx_update( crc_ctx_t* ctx, const uint8_t* data, size_t len );
+uint64_t crc_ctx_final( const crc_ctx_t* ctx );
+void crc_ctx_reset( crc_ctx_t* ctx );
+void crc_ctx_free( crc_ctx_t* ctx );
+uint8_t crc_ctx_kernel( const crc_ctx_t* ctx );
+
+
+/* same choice as the dispatcher, but without its forced kernel */
+static uint8_t pick_kernel( const crc_param_t* crc_params, uint8_t kernel )
+{
+  if( ( kernel != CRC_KERNEL_AUTO ) && 
+      crc_kernel_supported( kernel, crc_params ) )
+  {
+    return kernel;
+  }
+
+  if( crc_kernel_supported( CRC_KERNEL_SSE42, crc_params ) )
+  {
+    return CRC_KERNEL_SSE42;
+  }
+  if( crc_kernel_supported( CRC_KERNEL_CLMUL, crc_params ) )
+  {
+    return CRC_KERNEL_CLMUL;
+  }
+  return CRC_KERNEL_SLICE_16;
+}
+
+
+crc_ctx_t* crc_ctx_init( const crc_param_t* crc_params, uint8_t kernel )
+{
+  crc_ctx_t* ctx = NULL;
+
+  if( !crc_params->degree || ( crc_params->degree > REGISTER_BITS ) )
+  {
+    ( void )fprintf( stderr, "Unsupported polynomial degree: %d\n", 
+                             crc_params->degree );
+    return NULL;
+  }
+
+  if( kernel >= CRC_KERNEL_COUNT )
+  {
+    ( void )fprintf( stderr, "Unknown crc kernel: %d\n", kernel );
+    return NULL;
+  }
+
+  if( !( ctx = ( crc_ctx_t* )malloc( sizeof( crc_ctx_t ) ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate a crc context.\n" );
+    return NULL;
+  }
+
+  ctx->params = *crc_params;
+  ctx->kernel = pick_kernel( crc_params, kernel );
+  ctx->slices = 0U;
+  ctx->lut    = NULL;
+
+  switch( ctx->kernel )
+  {
+    case CRC_KERNEL_LUT:
+      ctx->slices = 1U;
+      break;
+    case CRC_KERNEL_SLICE_4:
+      ctx->slices = 4U;
+      break;
+    case CRC_KERNEL_SLICE_8:
+      ctx->slices = 8U;
+      break;
+    case CRC_KERNEL_SLICE_16:
+      ctx->slices = 16U;
+      break;
+    case CRC_KERNEL_CLMUL:
+      crc_clmul_build( &ctx->tables.clmul, crc_params );
+      break;
+    case CRC_KERNEL_SSE42:
+      crc32c_build( &ctx->tables.crc32c );
+      break;
+  }
+
+  if( ctx->slices && !( ctx->lut = crc_lut_find( crc_params ) ) )
+  {
+    crc_lut_build( &ctx->tables.lut, crc_params, ctx->slices );
+    ctx->lut = ( const crc_lut_tables_t* )&ctx->tables.lut;
+  }
+
+  crc_ctx_reset( ctx );
+
+  return ctx;
+}
+
+
+void crc_ctx_update( crc_ctx_t* ctx, const uint8_t* data, size_t len )
+{
+  switch( ctx->kernel )
+  {
+    case CRC_KERNEL_BITWISE:
+      ctx->crc = crc_bitwise_update( &ctx->params, ctx->crc, data, len );
+      break;
+    case CRC_KERNEL_LUT:
+    case CRC_KERNEL_SLICE_4:
+    case CRC_KERNEL_SLICE_8:
+    case CRC_KERNEL_SLICE_16:
+      ctx->crc = crc_lut_update( ctx->lut, &ctx->params, ctx->crc,
+                                 data, len, ctx->slices );
+      break;
+    case CRC_KERNEL_CLMUL:
+      ctx->crc = crc_clmul_update( &ctx->tables.clmul, &ctx->params, ctx->crc,
+                                   data, len );
+      break;
+    case CRC_KERNEL_SSE42:
+      ctx->crc = ( uint64_t )crc32c_update( &ctx->tables.crc32c, 
+                                            ( uint32_t )ctx->crc, data, len );
+      break;
+  }
+}
+
+
+uint64_t crc_ctx_final( const crc_ctx_t* ctx )
+{
+  uint64_t crc;
+
+  crc = ctx->crc;
+
+  /* the final xor comes after the reflection (Rocksoft model) */
+  if( ctx->params.reflect_remainder )
+  {
+    reflect_bits_64( &crc, 1U );
+    crc >>= ( REGISTER_BITS - ctx->params.degree );
+  }
+
+  return crc ^ get_param_value( &ctx->params.final_xor, ctx->params.degree );
+}
+
+
+void crc_ctx_reset( crc_ctx_t* ctx )
+{
+  ctx->crc = get_param_value( &ctx->params.initial_xor, ctx->params.degree );
+}
+
+
+void crc_ctx_free( crc_ctx_t* ctx )
+{
+  free( ctx );
+}
+
+
+uint8_t crc_ctx_kernel( const crc_ctx_t* ctx )
+{
+  return ctx->kernel;
+}
+
@@ -0,0 +1,210 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcdispatch.c
+ *
+ *
+ * Purpose:   This module picks the fastest crc
+ *            kernel for a parameter set at runtime,
+ *            depending on the features of the cpu
+ *            (cpuid). So one binary or library can
+ *            be shipped to different machines.
+ *
+ *
+ * Remarks:   - A kernel can be forced for comparisons.
+ *              If the forced kernel can not handle the
+ *              parameter set, the automatic choice is used.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crctypes.h>
+#include <crcapi.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+
+typedef void ( *crc_kernel_func )( const uint8_t*, const uint32_t,
+                                   const crc_param_t*, uint64_t*,
+                                   uint8_t, uint8_t );
+
+typedef struct crc_kernel
+{
+  const char*     name;
+  crc_kernel_func func;
+
+} crc_kernel_t;
+
+
+static uint8_t is_crc_32c( const crc_param_t* crc_params );
+
+
+/* indexed by the CRC_KERNEL_* ids of crctypes.h */
+static const crc_kernel_t kernels[ CRC_KERNEL_COUNT ] =
+{
+  { "auto",    NULL                      },
+  { "bitwise", &crc_algorithm            },
+  { "lut",     &crc_algorithm_lut        },
+  { "slice4",  &crc_algorithm_slicing_4  },
+  { "slice8",  &crc_algorithm_slicing_8  },
+  { "slice16", &crc_algorithm_slicing_16 },
+  { "clmul",   &crc_algorithm_clmul      },
+  { "sse42",   &crc_algorithm_sse42      }
+};
+
+static uint8_t forced_kernel = CRC_KERNEL_AUTO;
+static uint8_t active_kernel = CRC_KERNEL_AUTO;
+
+
+uint8_t crc_kernel_supported( uint8_t kernel, const crc_param_t* crc_params );
+uint8_t crc_select_kernel( const crc_param_t* crc_params );
+uint8_t crc_force_kernel( uint8_t kernel );
+uint8_t crc_kernel_from_name( const char* name );
+const char* crc_kernel_name( uint8_t kernel );
+uint8_t init_crc_dispatch( const crc_param_t* crc_params );
+void crc_algorithm_dispatch( const uint8_t* data, const uint32_t len,
+                             const crc_param_t* crc_params, uint64_t* p_crc,
+                             uint8_t first_call,
+                             uint8_t more_fragments );
+
+
+static uint8_t is_crc_32c( const crc_param_t* crc_params )
+{
+  return ( ( crc_params->degree == 32U ) &&
+           ( crc_params->coeff.u_32 == 0x1EDC6F41U ) &&
+           crc_params->reflect_input ) ? 0xFFU : 0x00U;
+}
+
+
+uint8_t crc_kernel_supported( uint8_t kernel, const crc_param_t* crc_params )
+{
+  switch( kernel )
+  {
+    case CRC_KERNEL_BITWISE:
+    case CRC_KERNEL_LUT:
+    case CRC_KERNEL_SLICE_4:
+    case CRC_KERNEL_SLICE_8:
+    case CRC_KERNEL_SLICE_16:
+      return 0xFFU;
+    case CRC_KERNEL_CLMUL:
+      return crc_clmul_supported();
+    case CRC_KERNEL_SSE42:
+      return ( is_crc_32c( crc_params ) && crc_sse42_supported() ) ? 0xFFU : 0x00U;
+  }
+  return 0x00U;
+}
+
+
+uint8_t crc_select_kernel( const crc_param_t* crc_params )
+{
+  if( ( forced_kernel != CRC_KERNEL_AUTO ) &&
+      crc_kernel_supported( forced_kernel, crc_params ) )
+  {
+    return forced_kernel;
+  }
+
+  if( crc_kernel_supported( CRC_KERNEL_SSE42, crc_params ) )
+  {
+    return CRC_KERNEL_SSE42;
+  }
+  if( crc_kernel_supported( CRC_KERNEL_CLMUL, crc_params ) )
+  {
+    return CRC_KERNEL_CLMUL;
+  }
+  return CRC_KERNEL_SLICE_16;
+}
+
+
+uint8_t crc_force_kernel( uint8_t kernel )
+{
+  if( kernel >= CRC_KERNEL_COUNT )
+  {
+    ( void )fprintf( stderr, "Unknown crc kernel: %d\n", kernel );
+    return 0x00U;
+  }
+  forced_kernel = kernel;
+  return 0xFFU;
+}
+
+
+uint8_t crc_kernel_from_name( const char* name )
+{
+  uint8_t i;
+
+  for( i = 0U; i < CRC_KERNEL_COUNT; i++ )
+  {
+    if( !strcmp( name, kernels[ i ].name ) )
+    {
+      return i;
+    }
+  }
+  return CRC_KERNEL_COUNT;
+}
+
+
+const char* crc_kernel_name( uint8_t kernel )
+{
+  if( kernel >= CRC_KERNEL_COUNT )
+  {
+    return "unknown";
+  }
+  return kernels[ kernel ].name;
+}
+
+
+uint8_t init_crc_dispatch( const crc_param_t* crc_params )
+{
+  active_kernel = crc_select_kernel( crc_params );
+
+  if( ( forced_kernel != CRC_KERNEL_AUTO ) && ( forced_kernel != active_kernel ) )
+  {
+    ( void )fprintf( stderr, "The %s kernel can not be used for this parameter set, "
+                             "using %s.\n",
+                             kernels[ forced_kernel ].name,
+                             kernels[ active_kernel ].name );
+  }
+
+  switch( active_kernel )
+  {
+    case CRC_KERNEL_LUT:
+      init_lut_crc( crc_params );
+      break;
+    case CRC_KERNEL_SLICE_4:
+    case CRC_KERNEL_SLICE_8:
+    case CRC_KERNEL_SLICE_16:
+      init_lut_crc_slicing( crc_params );
+      break;
+    case CRC_KERNEL_CLMUL:
+      init_clmul_crc( crc_params );
+      break;
+    case CRC_KERNEL_SSE42:
+      init_crc32c_sse42();
+      break;
+  }
+
+  return active_kernel;
+}
+
+
+void crc_algorithm_dispatch( const uint8_t* data, const uint32_t len,
+                             const crc_param_t* crc_params, uint64_t* p_crc,
+                             uint8_t first_call,
+                             uint8_t more_fragments )
+{
+  if( active_kernel == CRC_KERNEL_AUTO )
+  {
+    ( void )fprintf( stderr, "The crc dispatcher was not initialized.\n" );
+    return;
+  }
+  kernels[ active_kernel ].func( data, len, crc_params, p_crc,
+                                 first_call, more_fragments );
+}
@@ -0,0 +1,410 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcfile.c
+ *
+ *
+ * Purpose:   This module calculates the checksum of
+ *            a whole file for library users, with the
+ *            kernel picked by the runtime dispatcher.
+ *
+ *
+ * Remarks:   - The file is mapped read only, so the
+ *              kernels read straight from the page cache.
+ *              There is neither a copy nor a large
+ *              resident buffer.
+ *
+ *            - Runs on its own crc context, so several
+ *              files can be hashed concurrently.
+ *
+ *            - crc_files_uring keeps a slot (context and
+ *              buffer) per file in flight. A completion moves
+ *              its slot on: open -> read ... -> close and the
+ *              next file. The submissions of all slots are
+ *              batched into one io_uring_enter call.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crctypes.h>
+#include <crcapi.h>
+#include <uring.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+
+
+/* read size of crc_files_uring, small files take one read */
+#define FILES_BUF_SIZE ( 64UL * 1024UL )
+
+/* user data of the closes, nothing waits for them */
+#define FILES_CLOSE_TAG 0xFFFFFFFFFFFFFFFFUL
+
+#define SLOT_OPEN 0x00U
+#define SLOT_READ 0x01U
+
+
+typedef struct file_slot
+{
+  crc_ctx_t* ctx;
+  uint8_t*   buf;
+  size_t     index;
+  uint64_t   offset;
+  int        fd;
+  uint8_t    state;
+
+} file_slot_t;
+
+
+static struct io_uring_sqe* get_sqe( uring_t* ring );
+static void queue_open( uring_t* ring, file_slot_t* slot, uint32_t s,
+                        const char* file );
+static void queue_read( uring_t* ring, file_slot_t* slot, uint32_t s );
+static void queue_close( uring_t* ring, file_slot_t* slot );
+static uint8_t crc_file_read( const char* file, crc_ctx_t* ctx, uint8_t* buf,
+                              uint64_t* p_crc );
+static size_t crc_files_sequential( const char* const* files, size_t n,
+                                    file_slot_t* slot, uint64_t* crcs,
+                                    uint8_t* ok );
+
+uint8_t crc_file_mmap( const char* file, const crc_param_t* crc_params,
+                       uint64_t* p_crc );
+size_t crc_files_uring( const char* const* files, size_t n,
+                        const crc_param_t* crc_params, uint64_t* crcs,
+                        uint8_t* ok, uint32_t queue_depth );
+
+
+uint8_t crc_file_mmap( const char* file, const crc_param_t* crc_params,
+                       uint64_t* p_crc )
+{
+  struct stat file_stat;
+  crc_ctx_t* ctx = NULL;
+  uint8_t* map = NULL;
+  size_t len = 0U;
+  int fd = ( -1 );
+
+  if( ( fd = open( file, O_RDONLY ) ) == ( -1 ) )
+  {
+    ( void )fprintf( stderr, "%s: %s\n", file, strerror( errno ) );
+    return 0x00U;
+  }
+
+  if( fstat( fd, &file_stat ) )
+  {
+    ( void )fprintf( stderr, "%s: %s\n", file, strerror( errno ) );
+    ( void )close( fd );
+    return 0x00U;
+  }
+
+  if( !( ctx = crc_ctx_init( crc_params, CRC_KERNEL_AUTO ) ) )
+  {
+    ( void )close( fd );
+    return 0x00U;
+  }
+
+  len = ( size_t )file_stat.st_size;
+
+  /* an empty file can not be mapped */
+  if( len )
+  {
+    map = ( uint8_t* )mmap( NULL, len, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+    if( map == ( uint8_t* )MAP_FAILED )
+    {
+      ( void )fprintf( stderr, "%s: %s\n", file, strerror( errno ) );
+      ( void )close( fd );
+      crc_ctx_free( ctx );
+      return 0x00U;
+    }
+
+    ( void )madvise( ( void* )map, len, MADV_SEQUENTIAL );
+    ( void )madvise( ( void* )map, len, MADV_WILLNEED );
+
+    crc_ctx_update( ctx, map, len );
+
+    ( void )munmap( ( void* )map, len );
+  }
+  ( void )close( fd );
+
+  *p_crc = crc_ctx_final( ctx );
+  crc_ctx_free( ctx );
+
+  return 0xFFU;
+}
+
+
+/* submits the queued entries if the submission queue is full */
+static struct io_uring_sqe* get_sqe( uring_t* ring )
+{
+  struct io_uring_sqe* sqe;
+
+  while( !( sqe = uring_get_sqe( ring ) ) )
+  {
+    ( void )uring_submit( ring, 0U );
+  }
+  return sqe;
+}
+
+
+static void queue_open( uring_t* ring, file_slot_t* slot, uint32_t s,
+                        const char* file )
+{
+  struct io_uring_sqe* sqe = get_sqe( ring );
+
+  slot->state  = SLOT_OPEN;
+  slot->offset = 0UL;
+  slot->fd     = ( -1 );
+  crc_ctx_reset( slot->ctx );
+
+  sqe->opcode     = IORING_OP_OPENAT;
+  sqe->fd         = AT_FDCWD;
+  sqe->addr       = ( uint64_t )( uintptr_t )file;
+  sqe->open_flags = O_RDONLY;
+  sqe->user_data  = ( uint64_t )s;
+}
+
+
+static void queue_read( uring_t* ring, file_slot_t* slot, uint32_t s )
+{
+  struct io_uring_sqe* sqe = get_sqe( ring );
+
+  slot->state = SLOT_READ;
+
+  sqe->opcode    = IORING_OP_READ;
+  sqe->fd        = slot->fd;
+  sqe->addr      = ( uint64_t )( uintptr_t )slot->buf;
+  sqe->len       = ( uint32_t )FILES_BUF_SIZE;
+  sqe->off       = slot->offset;
+  sqe->user_data = ( uint64_t )s;
+}
+
+
+static void queue_close( uring_t* ring, file_slot_t* slot )
+{
+  struct io_uring_sqe* sqe = get_sqe( ring );
+
+  sqe->opcode    = IORING_OP_CLOSE;
+  sqe->fd        = slot->fd;
+  sqe->user_data = FILES_CLOSE_TAG;
+
+  slot->fd = ( -1 );
+}
+
+
+static uint8_t crc_file_read( const char* file, crc_ctx_t* ctx, uint8_t* buf,
+                              uint64_t* p_crc )
+{
+  ssize_t bytes_read;
+  int fd;
+
+  if( ( fd = open( file, O_RDONLY ) ) == ( -1 ) )
+  {
+    ( void )fprintf( stderr, "%s: %s\n", file, strerror( errno ) );
+    return 0x00U;
+  }
+
+  crc_ctx_reset( ctx );
+
+  while( ( bytes_read = read( fd, ( void* )buf, FILES_BUF_SIZE ) ) )
+  {
+    if( bytes_read < 0 )
+    {
+      if( errno == EINTR )
+      {
+        continue;
+      }
+      ( void )fprintf( stderr, "%s: %s\n", file, strerror( errno ) );
+      ( void )close( fd );
+      return 0x00U;
+    }
+    crc_ctx_update( ctx, buf, ( size_t )bytes_read );
+  }
+  ( void )close( fd );
+
+  *p_crc = crc_ctx_final( ctx );
+
+  return 0xFFU;
+}
+
+
+/* fallback without io_uring, one file after another on slot 0 */
+static size_t crc_files_sequential( const char* const* files, size_t n,
+                                    file_slot_t* slot, uint64_t* crcs,
+                                    uint8_t* ok )
+{
+  size_t i, count = 0U;
+
+  for( i = 0U; i < n; i++ )
+  {
+    ok[ i ] = crc_file_read( files[ i ], slot->ctx, slot->buf, &crcs[ i ] );
+    if( ok[ i ] )
+    {
+      count++;
+    }
+  }
+  return count;
+}
+
+
+size_t crc_files_uring( const char* const* files, size_t n,
+                        const crc_param_t* crc_params, uint64_t* crcs,
+                        uint8_t* ok, uint32_t queue_depth )
+{
+  struct io_uring_cqe* cqe;
+  file_slot_t* slots = NULL;
+  file_slot_t* slot;
+  uring_t ring;
+  size_t next = 0U, count = 0U;
+  uint32_t s, active = 0U, depth;
+  uint64_t tag;
+  int32_t res;
+  int ret;
+
+  if( !n )
+  {
+    return 0U;
+  }
+
+  ( void )memset( ( void* )ok, 0, n * sizeof( uint8_t ) );
+
+  if( ( queue_depth < 1U ) || ( queue_depth > URING_MAX_QUEUE_DEPTH ) )
+  {
+    ( void )fprintf( stderr, "Unsupported queue depth: %u\n", queue_depth );
+    return 0U;
+  }
+
+  depth = ( n < ( size_t )queue_depth ) ? ( uint32_t )n : queue_depth;
+
+  if( !( slots = ( file_slot_t* )calloc( depth, sizeof( file_slot_t ) ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    return 0U;
+  }
+
+  for( s = 0U; s < depth; s++ )
+  {
+    slots[ s ].fd  = ( -1 );
+    slots[ s ].ctx = crc_ctx_init( crc_params, CRC_KERNEL_AUTO );
+    slots[ s ].buf = ( uint8_t* )malloc( FILES_BUF_SIZE );
+    if( !slots[ s ].ctx || !slots[ s ].buf )
+    {
+      ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+      goto cleanup;
+    }
+  }
+
+  /* a close and the next open may be queued for every slot */
+  if( !uring_init( &ring, 2U * depth ) )
+  {
+    count = crc_files_sequential( files, n, slots, crcs, ok );
+    goto cleanup;
+  }
+
+  for( s = 0U; s < depth; s++ )
+  {
+    queue_open( &ring, &slots[ s ], s, files[ next ] );
+    slots[ s ].index = next++;
+    active++;
+  }
+
+  while( active )
+  {
+    if( ( ret = uring_submit( &ring, 1U ) ) < 0 )
+    {
+      ( void )fprintf( stderr, "io_uring_enter: %s\n", strerror( -ret ) );
+      break;
+    }
+
+    while( ( cqe = uring_peek_cqe( &ring ) ) )
+    {
+      tag = cqe->user_data;
+      res = cqe->res;
+      uring_cqe_seen( &ring );
+
+      if( tag == FILES_CLOSE_TAG )
+      {
+        continue;
+      }
+
+      s = ( uint32_t )tag;
+      slot = &slots[ s ];
+
+      if( res < 0 )
+      {
+        ( void )fprintf( stderr, "%s: %s\n", files[ slot->index ], strerror( -res ) );
+      }
+      else if( slot->state == SLOT_OPEN )
+      {
+        slot->fd = res;
+        queue_read( &ring, slot, s );
+        continue;
+      }
+      else if( res )
+      {
+        crc_ctx_update( slot->ctx, slot->buf, ( size_t )res );
+        slot->offset += ( uint64_t )res;
+        queue_read( &ring, slot, s );
+        continue;
+      }
+      else
+      {
+        /* end of file */
+        crcs[ slot->index ] = crc_ctx_final( slot->ctx );
+        ok[ slot->index ] = 0xFFU;
+        count++;
+      }
+
+      /* the file is done (or failed), the slot takes the next one */
+      if( slot->fd >= 0 )
+      {
+        queue_close( &ring, slot );
+      }
+      if( next < n )
+      {
+        queue_open( &ring, slot, s, files[ next ] );
+        slot->index = next++;
+      }
+      else
+      {
+        active--;
+      }
+    }
+  }
+
+  /* the last closes */
+  if( ring.pending )
+  {
+    ( void )uring_submit( &ring, 0U );
+  }
+  uring_exit( &ring );
+
+cleanup:
+  for( s = 0U; s < depth; s++ )
+  {
+    if( slots[ s ].ctx )
+    {
+      crc_ctx_free( slots[ s ].ctx );
+    }
+    free( ( void* )slots[ s ].buf );
+  }
+  free( ( void* )slots );
+
+  return count;
+}
@@ -0,0 +1,217 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcmodel.c
+ *
+ *
+ * Purpose:   This module stamps out a table driven
+ *            kernel for every model of CRC_MODEL_LIST
+ *            and holds the registry of these kernels.
+ *
+ *
+ * Remarks:   - The generic kernel functions of crcinline.h
+ *              are always inlined into the wrappers of a
+ *              model, which pass the spec as literals.
+ *              So the width, the xor values and the
+ *              reflection fold into immediates and the
+ *              dead branches vanish.
+ *              There is neither a parameter struct nor a
+ *              union access left in the byte loop.
+ *
+ *            - Reflected models keep the register reflected
+ *              and right aligned, the others left aligned
+ *              in 64 bit. So any width from 1 up to 64 goes
+ *              without a shift per byte.
+ *
+ *            - The registry is the model catalogue, see
+ *              crcmodel.h. crc_param_set fills in models
+ *              which are not listed.
+ *
+ *            - The const tables come from gen/crctables.h,
+ *              which the Makefile generates with crctabgen.
+ *              The other table driven kernels of the library
+ *              pick them up with crc_lut_find.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crctypes.h>
+#include <crcmodel.h>
+#include <crckernel.h>
+#include <crcinline.h>
+#include <crctables.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <strings.h>
+
+
+static const crc_model_t* find_tables_model( const crc_param_t* crc_params );
+
+
+#define CRC_MODEL_DEFINE( name, title, spec, check ) \
+  CRC_INLINE_MODEL( extern, name, lut_##name.slice[ 0U ], spec )
+
+
+CRC_MODEL_LIST( CRC_MODEL_DEFINE )
+
+
+#define CRC_MODEL_ENTRY( name, title, spec, check )                       \
+  { title, #name, CRC_PARAM_INIT_( spec ), check,                         \
+    &name, &name##_init, &name##_update, &name##_final },
+
+static const crc_model_t models[] =
+{
+  CRC_MODEL_LIST( CRC_MODEL_ENTRY )
+};
+
+#define MODEL_COUNT ( ( uint32_t )( sizeof( models ) / sizeof( models[ 0 ] ) ) )
+
+
+uint32_t crc_model_count( void );
+const crc_model_t* crc_model_get( uint32_t index );
+const crc_model_t* crc_model_find( const char* name );
+const crc_model_t* crc_model_find_params( const crc_param_t* crc_params );
+uint8_t crc_param_set( crc_param_t* crc_params, uint8_t degree,
+                       uint64_t coeff, uint64_t initial, uint64_t final,
+                       uint8_t refin, uint8_t refout );
+const crc_lut_tables_t* crc_lut_find( const crc_param_t* crc_params );
+const uint16_t ( *crc_lut_16_find( const crc_param_t* crc_params ) )[ 0x100U ];
+
+
+uint32_t crc_model_count( void )
+{
+  return MODEL_COUNT;
+}
+
+
+const crc_model_t* crc_model_get( uint32_t index )
+{
+  return ( index < MODEL_COUNT ) ? &models[ index ] : NULL;
+}
+
+
+const crc_model_t* crc_model_find( const char* name )
+{
+  uint32_t i;
+
+  for( i = 0U; i < MODEL_COUNT; i++ )
+  {
+    if( !strcasecmp( name, models[ i ].name ) ||
+        !strcmp( name, models[ i ].symbol ) )
+    {
+      return &models[ i ];
+    }
+  }
+  return NULL;
+}
+
+
+const crc_model_t* crc_model_find_params( const crc_param_t* crc_params )
+{
+  const crc_param_t* p;
+  uint64_t mask;
+  uint32_t i;
+
+  mask = CRC_WIDTH_MASK( crc_params->degree );
+
+  for( i = 0U; i < MODEL_COUNT; i++ )
+  {
+    p = &models[ i ].params;
+    if( ( p->degree == crc_params->degree ) &&
+        !( ( p->coeff.u_64 ^ crc_params->coeff.u_64 ) & mask ) &&
+        !( ( p->initial_xor.u_64 ^ crc_params->initial_xor.u_64 ) & mask ) &&
+        !( ( p->final_xor.u_64 ^ crc_params->final_xor.u_64 ) & mask ) &&
+        ( !p->reflect_input == !crc_params->reflect_input ) &&
+        ( !p->reflect_remainder == !crc_params->reflect_remainder ) )
+    {
+      return &models[ i ];
+    }
+  }
+  return NULL;
+}
+
+
+uint8_t crc_param_set( crc_param_t* crc_params, uint8_t degree,
+                       uint64_t coeff, uint64_t initial, uint64_t final,
+                       uint8_t refin, uint8_t refout )
+{
+  uint64_t mask;
+  uint8_t i;
+
+  if( !degree || ( degree > 64U ) )
+  {
+    return 0x00U;
+  }
+
+  mask = CRC_WIDTH_MASK( degree );
+
+  ( void )memset( ( void* )crc_params, 0x00, sizeof( crc_param_t ) );
+
+  /* little endian byte by byte, as CRC_PARAM_FIELD does it */
+  for( i = 0U; i < 8U; i++ )
+  {
+    crc_params->coeff.u_8_field[ i ]       = CRC_PARAM_BYTE( coeff & mask, i );
+    crc_params->initial_xor.u_8_field[ i ] = CRC_PARAM_BYTE( initial & mask, i );
+    crc_params->final_xor.u_8_field[ i ]   = CRC_PARAM_BYTE( final & mask, i );
+  }
+
+  crc_params->degree            = degree;
+  crc_params->reflect_input     = refin ? 0xFFU : 0x00U;
+  crc_params->reflect_remainder = refout ? 0xFFU : 0x00U;
+
+  return 0xFFU;
+}
+
+
+/* The tables only depend on the degree, the coefficients and the
+ * input reflection. So models which are not in the catalogue but
+ * share the polynomial of one get the generated tables too. */
+static const crc_model_t* find_tables_model( const crc_param_t* crc_params )
+{
+  const crc_param_t* p;
+  uint64_t mask;
+  uint32_t i;
+
+  mask = CRC_WIDTH_MASK( crc_params->degree );
+
+  for( i = 0U; i < MODEL_COUNT; i++ )
+  {
+    p = &models[ i ].params;
+    if( ( p->degree == crc_params->degree ) &&
+        !( ( p->coeff.u_64 ^ crc_params->coeff.u_64 ) & mask ) &&
+        ( !p->reflect_input == !crc_params->reflect_input ) )
+    {
+      return &models[ i ];
+    }
+  }
+  return NULL;
+}
+
+
+const crc_lut_tables_t* crc_lut_find( const crc_param_t* crc_params )
+{
+  const crc_model_t* model;
+
+  model = find_tables_model( crc_params );
+
+  return model ? model_luts[ model - models ] : NULL;
+}
+
+
+const uint16_t ( *crc_lut_16_find( const crc_param_t* crc_params ) )[ 0x100U ]
+{
+  const crc_model_t* model;
+
+  model = find_tables_model( crc_params );
+
+  return model ? model_luts_16[ model - models ] : NULL;
+}
@@ -0,0 +1,312 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcpar.c
+ * 
+ *
+ * Purpose:   This module calculates the checksum of one
+ *            file with several threads. Every worker
+ *            preads its own disjoint part of the file
+ *            and crunches it on its own crc context with
+ *            the fastest kernel. The partial checksums
+ *            are merged in file order with crc_combine.
+ *
+ * 
+ * Remarks:   - The parts are page aligned, every worker
+ *              reads through a PAR_BUF_SIZE buffer.
+ *
+ *            - The partial checksums are merged pairwise,
+ *              neighbours first, so the merge tree has a
+ *              depth of log2( threads ).
+ *
+ *            - The parameter sets are the ones of the
+ *              bitwise engine, so the output matches
+ *              calculate_crc_from_file_bitwise, a model
+ *              set with set_parallel_params replaces them.
+ *
+ *
+ * Date:      10/2026 
+ * 
+ */
+
+#include <crctypes.h>
+#include <crcparam_even.h>
+#include <crcapi.h>
+#include <crcpar.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+
+#define PAR_BUF_SIZE  ( 4UL * 1024UL * 1024UL ) /* unit is bytes */
+#define PAGE_SIZE     4096UL
+
+#define BYTES_TO_MEGABYTES ( 1.0 / ( 1024.0 * 1024.0 ) )
+
+
+typedef struct par_worker
+{
+  pthread_t          thread;
+  const crc_param_t* crc_params;
+  int                fd;
+  uint64_t           offset;
+  uint64_t           len;
+  uint64_t           crc;
+  uint8_t            failed;
+
+} par_worker_t;
+
+
+static crc_param_t polynomial_3  = CRC_3_POLY_PARAM;
+static crc_param_t polynomial_8  = CRC_8_POLY_PARAM;
+static crc_param_t polynomial_16 = CRC_16_BITWISE_POLY_PARAM;
+static crc_param_t polynomial_32 = CRC_32_POLY_PARAM;
+static crc_param_t polynomial_64 = CRC_64_POLY_PARAM;
+
+/* model set with set_parallel_params, replaces the defaults */
+static crc_param_t custom_polynomial;
+static uint8_t     custom_set = 0x00U;
+
+
+static const crc_param_t* get_polynomial( uint8_t degree );
+static void* crunch_part( void* arg );
+static uint64_t combine_parts( const crc_param_t* crc_params, 
+                               par_worker_t* workers, uint16_t n );
+
+
+static const crc_param_t* get_polynomial( uint8_t degree )
+{
+  if( custom_set )
+  {
+    return ( const crc_param_t* )&custom_polynomial;
+  }
+
+  switch( degree )
+  {
+    case 3:
+      return ( const crc_param_t* )&polynomial_3;
+    case 8:
+      return ( const crc_param_t* )&polynomial_8;
+    case 16:
+      return ( const crc_param_t* )&polynomial_16;
+    case 32:
+      return ( const crc_param_t* )&polynomial_32;
+    case 64:
+      return ( const crc_param_t* )&polynomial_64;
+  }
+  return NULL;
+}
+
+
+static void* crunch_part( void* arg )
+{
+  par_worker_t* worker = ( par_worker_t* )arg;
+  crc_ctx_t* ctx = NULL;
+  uint8_t* buf = NULL;
+  uint64_t done = 0UL;
+  ssize_t bytes_read;
+  size_t want;
+
+  worker->failed = 0xFFU;
+
+  if( !( ctx = crc_ctx_init( worker->crc_params, CRC_KERNEL_AUTO ) ) )
+  {
+    return NULL;
+  }
+
+  if( !( buf = ( uint8_t* )malloc( PAR_BUF_SIZE * sizeof( uint8_t ) ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    crc_ctx_free( ctx );
+    return NULL;
+  }
+
+  while( done < worker->len )
+  {
+    want = ( worker->len - done > PAR_BUF_SIZE ) ? 
+           ( size_t )PAR_BUF_SIZE : ( size_t )( worker->len - done );
+
+    bytes_read = pread( worker->fd, ( void* )buf, want, 
+                        ( off_t )( worker->offset + done ) );
+    if( bytes_read <= 0 )
+    {
+      ( void )fprintf( stderr, "%s\n", 
+                       bytes_read ? strerror( errno ) : "Unexpected end of file." );
+      free( buf );
+      crc_ctx_free( ctx );
+      return NULL;
+    }
+
+    crc_ctx_update( ctx, buf, ( size_t )bytes_read );
+    done += ( uint64_t )bytes_read;
+  }
+
+  worker->crc    = crc_ctx_final( ctx );
+  worker->failed = 0x00U;
+
+  free( buf );
+  crc_ctx_free( ctx );
+
+  return NULL;
+}
+
+
+/* Merges the neighbours at distance 1, 2, 4, ... until the
+ * checksum of the whole file ends up in the first worker. */
+static uint64_t combine_parts( const crc_param_t* crc_params, 
+                               par_worker_t* workers, uint16_t n )
+{
+  crc_combine_t comb;
+  uint16_t step, i;
+
+  init_crc_combine( &comb, crc_params );
+
+  for( step = 1U; step < n; step <<= 1U )
+  {
+    for( i = 0U; i + step < n; i += 2U * step )
+    {
+      workers[ i ].crc = crc_combine( ( const crc_combine_t* )&comb, 
+                                      workers[ i ].crc,
+                                      workers[ i + step ].crc, 
+                                      workers[ i + step ].len );
+      workers[ i ].len += workers[ i + step ].len;
+    }
+  }
+
+  return workers[ 0 ].crc;
+}
+
+
+void set_parallel_params( const crc_param_t* crc_params )
+{
+  if( !crc_params )
+  {
+    custom_set = 0x00U;
+    return;
+  }
+  custom_polynomial = *crc_params;
+  custom_set = 0xFFU;
+}
+
+
+void calculate_crc_from_file_parallel( const char* file, 
+                                       uint8_t polynomial_degree,
+                                       uint16_t threads )
+{
+  const crc_param_t* crc_params = NULL;
+  par_worker_t* workers = NULL;
+  struct stat file_stat;
+  uint64_t file_size, part, offset;
+  uint64_t crc;
+  uint16_t i, started;
+  uint8_t failed = 0x00U;
+  double seconds;
+  int fd = ( -1 );
+
+  if( !( crc_params = get_polynomial( polynomial_degree ) ) )
+  {
+    ( void )fprintf( stderr, "Unsupported polynomial degree: %d\n", polynomial_degree );
+    return;
+  }
+
+  if( !threads || ( threads > CRC_PAR_MAX_THREADS ) )
+  {
+    ( void )fprintf( stderr, "The number of threads must be 1 up to %d.\n", 
+                             CRC_PAR_MAX_THREADS );
+    return;
+  }
+
+  if( ( fd = open( file, O_RDONLY ) ) == ( -1 ) )
+  {
+    ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+    exit( EXIT_FAILURE );
+  }
+
+  if( fstat( fd, &file_stat ) )
+  {
+    ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+    ( void )close( fd );
+    exit( EXIT_FAILURE );
+  }
+  file_size = ( uint64_t )file_stat.st_size;
+  ( void )fprintf( stdout, "\nThe input file has a size of %ld bytes.\n", 
+                           file_stat.st_size );
+
+  if( !( workers = ( par_worker_t* )calloc( threads, sizeof( par_worker_t ) ) ) )
+  {
+    ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+    ( void )close( fd );
+    exit( EXIT_FAILURE );
+  }
+
+  /* equal page aligned parts, the last one takes the rest */
+  part = ( file_size / threads + PAGE_SIZE - 1UL ) & ~( PAGE_SIZE - 1UL );
+
+  ( void )posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+  seconds = get_monotonic_seconds();
+
+  offset = 0UL;
+  for( started = 0U; started < threads; started++ )
+  {
+    workers[ started ].crc_params = crc_params;
+    workers[ started ].fd         = fd;
+    workers[ started ].offset     = offset;
+    workers[ started ].len        = ( ( started + 1U < threads ) && 
+                                      ( file_size - offset > part ) ) ? 
+                                    part : file_size - offset;
+    offset += workers[ started ].len;
+
+    if( pthread_create( &workers[ started ].thread, NULL, 
+                        &crunch_part, ( void* )&workers[ started ] ) )
+    {
+      ( void )fprintf( stderr, "Failed to create worker thread.\n" );
+      failed = 0xFFU;
+      break;
+    }
+  }
+
+  for( i = 0U; i < started; i++ )
+  {
+    ( void )pthread_join( workers[ i ].thread, NULL );
+    failed |= workers[ i ].failed;
+  }
+
+  ( void )close( fd );
+
+  if( failed )
+  {
+    free( workers );
+    exit( EXIT_FAILURE );
+  }
+
+  crc = combine_parts( crc_params, workers, threads );
+
+  seconds = get_monotonic_seconds() - seconds;
+
+  ( void )fprintf( stdout, "\n\nCRC checksum: 0x%0*lx\n", 
+                           ( int )( 2U * ( ( crc_params->degree + 7U ) / 8U ) ), crc );
+  if( seconds > 0.0 )
+  {
+    ( void )fprintf( stdout, "Threads: %d, %.1f MB/s\n", threads,
+                             ( double )file_size * BYTES_TO_MEGABYTES / seconds );
+  }
+
+  free( workers );
+}
+
@@ -0,0 +1,351 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcsse42.c
+ *
+ *
+ * Purpose:   This module holds a CRC-32C (Castagnoli)
+ *            kernel which uses the crc32 instruction
+ *            of SSE4.2.
+ *
+ *
+ * Remarks:   - The crc32 instruction has a latency of
+ *              three cycles but a throughput of one per
+ *              cycle. The buffer is split into three
+ *              blocks which are crunched interleaved.
+ *              The three partial checksums are combined
+ *              by shifting them over the length of the
+ *              following blocks (appending zero bytes),
+ *              which is done with precomputed tables.
+ *
+ *            - The same approach is used by Mark Adler's
+ *              crc32c.c. Without SSE4.2 a reflected
+ *              lookup table is used.
+ *
+ *            - The crc register is kept reflected inside
+ *              this module, as the instruction does.
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crctypes.h>
+#include <crcapi.h>
+#include <crckernel.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+#if defined( __x86_64__ )
+#define SSE42_AVAILABLE
+#include <immintrin.h>
+#define SSE42_TARGET __attribute__( ( target( "sse4.2" ) ) )
+#endif
+
+
+/* reflected Castagnoli polynomial 0x1EDC6F41 */
+#define POLY_32C_REFLECTED 0x82F63B78U
+#define POLY_32C           0x1EDC6F41U
+
+/* block lengths of the interleaved streams, unit is bytes */
+#define LONG_BLOCK  8192U
+#define SHORT_BLOCK 256U
+
+
+static crc32c_tables_t tables;
+
+static uint8_t tables_ready = 0x00U;
+
+
+static uint32_t multiply_mod( uint32_t a, uint32_t b );
+static uint32_t xpow_8n_mod( uint32_t n );
+static void init_shift_tables( uint32_t shift[ 4 ][ 0x100U ], uint32_t n );
+static inline uint32_t shift_crc( const uint32_t ( *shift )[ 0x100U ], uint32_t crc );
+static uint32_t crc32c_table( const crc32c_tables_t* t, 
+                              const uint8_t* data, size_t len, uint32_t crc );
+
+void init_crc32c_sse42( void );
+uint8_t crc_sse42_supported( void );
+void crc_algorithm_sse42( const uint8_t* data, const uint32_t len,
+                          const crc_param_t* crc_params, uint64_t* p_crc,
+                          uint8_t first_call,
+                          uint8_t more_fragments );
+
+
+/* a * b mod P in the reflected domain, x^0 is the msb */
+static uint32_t multiply_mod( uint32_t a, uint32_t b )
+{
+  uint32_t m = 0x80000000U;
+  uint32_t p = 0x00000000U;
+
+  while( m )
+  {
+    if( a & m )
+    {
+      p ^= b;
+    }
+    m >>= 1U;
+    b = ( b & 1U ) ? ( b >> 1U ) ^ POLY_32C_REFLECTED : ( b >> 1U );
+  }
+  return p;
+}
+
+
+/* x^(8 * n) mod P in the reflected domain */
+static uint32_t xpow_8n_mod( uint32_t n )
+{
+  uint32_t p = 0x80000000U;
+  uint32_t i;
+
+  for( i = 0U; i < 8U * n; i++ )
+  {
+    p = ( p & 1U ) ? ( p >> 1U ) ^ POLY_32C_REFLECTED : ( p >> 1U );
+  }
+  return p;
+}
+
+
+static void init_shift_tables( uint32_t shift[ 4 ][ 0x100U ], uint32_t n )
+{
+  uint32_t xpow;
+  uint16_t i;
+  uint8_t k;
+
+  xpow = xpow_8n_mod( n );
+
+  for( k = 0U; k < 4U; k++ )
+  {
+    for( i = 0U; i < 0x100U; i++ )
+    {
+      shift[ k ][ i ] = multiply_mod( ( uint32_t )i << ( 8U * k ), xpow );
+    }
+  }
+}
+
+
+static inline uint32_t shift_crc( const uint32_t ( *shift )[ 0x100U ], uint32_t crc )
+{
+  return shift[ 0 ][ crc & 0xFFU ] ^
+         shift[ 1 ][ ( crc >> 8U ) & 0xFFU ] ^
+         shift[ 2 ][ ( crc >> 16U ) & 0xFFU ] ^
+         shift[ 3 ][ crc >> 24U ];
+}
+
+
+void crc32c_build( crc32c_tables_t* t )
+{
+  uint32_t cur_byte;
+  uint16_t i;
+  uint8_t j;
+
+  for( i = 0U; i < 0x100U; i++ )
+  {
+    cur_byte = ( uint32_t )i;
+    for( j = 0U; j < 8U; j++ )
+    {
+      cur_byte = ( cur_byte & 1U ) ? ( cur_byte >> 1U ) ^ POLY_32C_REFLECTED :
+                                     ( cur_byte >> 1U );
+    }
+    t->lut[ i ] = cur_byte;
+  }
+
+  init_shift_tables( t->long_shift,  LONG_BLOCK );
+  init_shift_tables( t->short_shift, SHORT_BLOCK );
+}
+
+
+void init_crc32c_sse42( void )
+{
+  if( tables_ready )
+  {
+    return;
+  }
+
+  crc32c_build( &tables );
+  tables_ready = 0xFFU;
+}
+
+
+static uint32_t crc32c_table( const crc32c_tables_t* t, 
+                              const uint8_t* data, size_t len, uint32_t crc )
+{
+  while( len-- )
+  {
+    crc = ( crc >> 8U ) ^ t->lut[ ( crc ^ *data++ ) & 0xFFU ];
+  }
+  return crc;
+}
+
+
+#ifdef SSE42_AVAILABLE
+
+SSE42_TARGET
+static inline uint64_t load_64( const uint8_t* data )
+{
+  uint64_t value;
+  ( void )memcpy( ( void* )&value, ( const void* )data, sizeof( uint64_t ) );
+  return value;
+}
+
+
+SSE42_TARGET
+static uint32_t crc32c_hw( const crc32c_tables_t* t, 
+                           const uint8_t* data, size_t len, uint32_t crc )
+{
+  uint64_t crc0, crc1, crc2;
+  const uint8_t* end;
+
+  crc0 = ( uint64_t )crc;
+
+  /* align the input to eight bytes */
+  while( len && ( ( uintptr_t )data & 7U ) )
+  {
+    crc0 = _mm_crc32_u8( ( uint32_t )crc0, *data++ );
+    len--;
+  }
+
+  while( len >= 3U * LONG_BLOCK )
+  {
+    crc1 = 0UL;
+    crc2 = 0UL;
+    end  = data + LONG_BLOCK;
+    do
+    {
+      crc0 = _mm_crc32_u64( crc0, load_64( data ) );
+      crc1 = _mm_crc32_u64( crc1, load_64( data + LONG_BLOCK ) );
+      crc2 = _mm_crc32_u64( crc2, load_64( data + 2U * LONG_BLOCK ) );
+      data += 8U;
+    } while( data < end );
+    crc0 = shift_crc( t->long_shift, ( uint32_t )crc0 ) ^ ( uint32_t )crc1;
+    crc0 = shift_crc( t->long_shift, ( uint32_t )crc0 ) ^ ( uint32_t )crc2;
+    data += 2U * LONG_BLOCK;
+    len  -= 3U * LONG_BLOCK;
+  }
+
+  while( len >= 3U * SHORT_BLOCK )
+  {
+    crc1 = 0UL;
+    crc2 = 0UL;
+    end  = data + SHORT_BLOCK;
+    do
+    {
+      crc0 = _mm_crc32_u64( crc0, load_64( data ) );
+      crc1 = _mm_crc32_u64( crc1, load_64( data + SHORT_BLOCK ) );
+      crc2 = _mm_crc32_u64( crc2, load_64( data + 2U * SHORT_BLOCK ) );
+      data += 8U;
+    } while( data < end );
+    crc0 = shift_crc( t->short_shift, ( uint32_t )crc0 ) ^ ( uint32_t )crc1;
+    crc0 = shift_crc( t->short_shift, ( uint32_t )crc0 ) ^ ( uint32_t )crc2;
+    data += 2U * SHORT_BLOCK;
+    len  -= 3U * SHORT_BLOCK;
+  }
+
+  while( len >= 8U )
+  {
+    crc0 = _mm_crc32_u64( crc0, load_64( data ) );
+    data += 8U;
+    len  -= 8U;
+  }
+
+  while( len-- )
+  {
+    crc0 = _mm_crc32_u8( ( uint32_t )crc0, *data++ );
+  }
+
+  return ( uint32_t )crc0;
+}
+
+#endif /* SSE42_AVAILABLE */
+
+
+uint32_t crc32c_update( const crc32c_tables_t* t, uint32_t crc,
+                        const uint8_t* data, size_t len )
+{
+  /* the caller's register is not reflected */
+  reflect_bits_32( &crc, 1U );
+
+#ifdef SSE42_AVAILABLE
+  if( crc_sse42_supported() )
+  {
+    crc = crc32c_hw( t, data, len, crc );
+  }
+  else
+#endif
+  {
+    crc = crc32c_table( t, data, len, crc );
+  }
+
+  reflect_bits_32( &crc, 1U );
+
+  return crc;
+}
+
+
+uint8_t crc_sse42_supported( void )
+{
+#ifdef SSE42_AVAILABLE
+  __builtin_cpu_init();
+  return __builtin_cpu_supports( "sse4.2" ) ? 0xFFU : 0x00U;
+#else
+  return 0x00U;
+#endif
+}
+
+
+void crc_algorithm_sse42( const uint8_t* data, const uint32_t len,
+                          const crc_param_t* crc_params, uint64_t* p_crc,
+                          uint8_t first_call,
+                          uint8_t more_fragments )
+{
+  uint32_t crc = 0x00000000U;
+
+  if( len >= UINT32_MAX )
+  {
+    ( void )fprintf( stderr, "Invalid number of bytes passed to crc algorithm.\n" );
+    return;
+  }
+
+  if( ( crc_params->degree != 32U ) ||
+      ( crc_params->coeff.u_32 != POLY_32C ) ||
+      !crc_params->reflect_input )
+  {
+    ( void )fprintf( stderr, "The crc32 instruction only supports CRC-32C.\n" );
+    return;
+  }
+
+  if( !tables_ready )
+  {
+    ( void )fprintf( stderr, "CRC-32C tables were not initialized.\n" );
+    return;
+  }
+
+  crc = ( uint32_t )*p_crc;
+
+  if( first_call )
+  {
+    crc ^= crc_params->initial_xor.u_32;
+  }
+
+  crc = crc32c_update( ( const crc32c_tables_t* )&tables, crc, data, ( size_t )len );
+
+  if( !more_fragments )
+  {
+    if( crc_params->reflect_remainder )
+    {
+      reflect_bits_32( &crc, 1U );
+    }
+
+    crc ^= crc_params->final_xor.u_32;
+  }
+
+  *p_crc = ( uint64_t )crc;
+}
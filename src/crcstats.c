@@ -0,0 +1,349 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crcstats.c
+ *
+ *
+ * Purpose:   This module holds the instrumentation of
+ *            the hot path, see crcstats.h.
+ *
+ *
+ * Remarks:   - The stages are timed with CLOCK_MONOTONIC
+ *              (get_monotonic_seconds), the clock of the
+ *              ctimer_t in mtimer.h. Per stage the number
+ *              of chunks, the bytes, the total and the
+ *              longest chunk are kept.
+ *
+ *            - cycles, instructions and cache misses come
+ *              from perf_event_open when it is permitted
+ *              (perf_event_paranoid). If the kernel may not
+ *              be counted, user space is counted only. The
+ *              values are scaled when the counters had to
+ *              be multiplexed.
+ *
+ *            - Without the cycle counter the cycles per byte
+ *              are taken from the time stamp counter (x86).
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crcstats.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <linux/perf_event.h>
+
+#if defined( __x86_64__ )
+#include <x86intrin.h>
+#endif
+
+#define COUNTER_CYCLES       0U
+#define COUNTER_INSTRUCTIONS 1U
+#define COUNTER_CACHE_MISSES 2U
+#define COUNTER_COUNT        3U
+
+#define SECONDS_TO_MS 1e3
+#define SECONDS_TO_US 1e6
+
+
+typedef struct crc_stage
+{
+  uint64_t chunks;
+  uint64_t bytes;
+  double   seconds;
+  double   max_seconds;
+
+} crc_stage_t;
+
+
+typedef struct perf_counter_read
+{
+  uint64_t value;
+  uint64_t time_enabled;
+  uint64_t time_running;
+
+} perf_counter_read_t;
+
+
+static const char* stage_names[ CRC_STAGE_COUNT ] = { "open", "read", "crc" };
+
+static const uint64_t counter_configs[ COUNTER_COUNT ] =
+{
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_MISSES
+};
+
+static crc_stage_t stages[ CRC_STAGE_COUNT ];
+
+static uint8_t  enabled     = 0x00U;
+static double   run_start   = 0.0;
+static uint64_t tsc_start   = 0UL;
+
+static int      counter_fd[ COUNTER_COUNT ] = { ( -1 ), ( -1 ), ( -1 ) };
+static uint8_t  user_only   = 0x00U;
+static int      counter_errno = 0;
+
+
+static int sys_perf_event_open( struct perf_event_attr* attr );
+static int open_counter( uint64_t config, uint8_t exclude_kernel );
+static void open_counters( void );
+static uint8_t read_counter( uint8_t counter, double* value );
+static uint64_t get_tsc( void );
+
+
+static int sys_perf_event_open( struct perf_event_attr* attr )
+{
+  /* this process and its threads to come, on any cpu */
+  return ( int )syscall( __NR_perf_event_open, attr, 0, -1, -1, 0UL );
+}
+
+
+static int open_counter( uint64_t config, uint8_t exclude_kernel )
+{
+  struct perf_event_attr attr;
+
+  ( void )memset( ( void* )&attr, 0x00, sizeof( attr ) );
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.size           = sizeof( attr );
+  attr.config         = config;
+  attr.disabled       = 1U;
+  attr.inherit        = 1U;
+  attr.exclude_hv     = 1U;
+  attr.exclude_kernel = exclude_kernel ? 1U : 0U;
+  attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  return sys_perf_event_open( &attr );
+}
+
+
+static void open_counters( void )
+{
+  uint8_t i;
+
+  for( i = 0U; i < COUNTER_COUNT; i++ )
+  {
+    counter_fd[ i ] = open_counter( counter_configs[ i ], user_only );
+    if( ( counter_fd[ i ] == ( -1 ) ) && !user_only &&
+        ( ( errno == EACCES ) || ( errno == EPERM ) ) )
+    {
+      /* perf_event_paranoid 2 still allows user space */
+      user_only = 0xFFU;
+      counter_fd[ i ] = open_counter( counter_configs[ i ], user_only );
+    }
+    if( counter_fd[ i ] == ( -1 ) )
+    {
+      counter_errno = errno;
+      continue;
+    }
+    ( void )ioctl( counter_fd[ i ], PERF_EVENT_IOC_RESET, 0 );
+    ( void )ioctl( counter_fd[ i ], PERF_EVENT_IOC_ENABLE, 0 );
+  }
+}
+
+
+static uint8_t read_counter( uint8_t counter, double* value )
+{
+  perf_counter_read_t r;
+
+  if( ( counter_fd[ counter ] == ( -1 ) ) ||
+      ( read( counter_fd[ counter ], ( void* )&r, sizeof( r ) ) != ( ssize_t )sizeof( r ) ) ||
+      !r.time_running )
+  {
+    return 0x00U;
+  }
+
+  *value = ( double )r.value;
+  if( r.time_running < r.time_enabled )
+  {
+    *value *= ( double )r.time_enabled / ( double )r.time_running;
+  }
+  return 0xFFU;
+}
+
+
+static uint64_t get_tsc( void )
+{
+#if defined( __x86_64__ )
+  return ( uint64_t )__rdtsc();
+#else
+  return 0UL;
+#endif
+}
+
+
+void crc_stats_enable( void )
+{
+  if( enabled )
+  {
+    return;
+  }
+  enabled = 0xFFU;
+
+  ( void )memset( ( void* )stages, 0x00, sizeof( stages ) );
+  open_counters();
+
+  run_start = get_monotonic_seconds();
+  tsc_start = get_tsc();
+}
+
+
+uint8_t crc_stats_enabled( void )
+{
+  return enabled;
+}
+
+
+double crc_stats_begin( void )
+{
+  return enabled ? get_monotonic_seconds() : 0.0;
+}
+
+
+void crc_stats_end( uint8_t stage, double start, uint64_t bytes )
+{
+  double seconds;
+
+  if( !enabled || ( stage >= CRC_STAGE_COUNT ) )
+  {
+    return;
+  }
+
+  seconds = get_monotonic_seconds() - start;
+
+  stages[ stage ].chunks++;
+  stages[ stage ].bytes   += bytes;
+  stages[ stage ].seconds += seconds;
+  if( seconds > stages[ stage ].max_seconds )
+  {
+    stages[ stage ].max_seconds = seconds;
+  }
+}
+
+
+void crc_stats_report( FILE* out )
+{
+  struct rusage usage;
+  double wall, other;
+  double cycles = 0.0, instructions = 0.0, misses = 0.0;
+  uint64_t tsc, bytes;
+  uint8_t has_cycles, has_instructions, has_misses;
+  uint8_t i;
+
+  if( !enabled )
+  {
+    return;
+  }
+
+  tsc  = get_tsc() - tsc_start;
+  wall = get_monotonic_seconds() - run_start;
+
+  has_cycles       = read_counter( COUNTER_CYCLES, &cycles );
+  has_instructions = read_counter( COUNTER_INSTRUCTIONS, &instructions );
+  has_misses       = read_counter( COUNTER_CACHE_MISSES, &misses );
+
+  bytes = stages[ CRC_STAGE_CRC ].bytes;
+
+  ( void )fprintf( out, "\nStats:\n%-7s %9s %14s %11s %11s %11s %7s\n",
+                        "stage", "chunks", "bytes", "total ms", "mean us", "max us", "share" );
+
+  other = wall;
+  for( i = 0U; i < CRC_STAGE_COUNT; i++ )
+  {
+    ( void )fprintf( out, "%-7s %9lu %14lu %11.3f %11.3f %11.3f %6.1f%%\n", stage_names[ i ],
+                          ( unsigned long )stages[ i ].chunks,
+                          ( unsigned long )stages[ i ].bytes,
+                          stages[ i ].seconds * SECONDS_TO_MS,
+                          stages[ i ].chunks ?
+                          stages[ i ].seconds / ( double )stages[ i ].chunks * SECONDS_TO_US : 0.0,
+                          stages[ i ].max_seconds * SECONDS_TO_US,
+                          ( wall > 0.0 ) ? 100.0 * stages[ i ].seconds / wall : 0.0 );
+    other -= stages[ i ].seconds;
+  }
+  ( void )fprintf( out, "%-7s %9s %14s %11.3f %11s %11s %6.1f%%\n", "other", "", "",
+                        other * SECONDS_TO_MS, "", "",
+                        ( wall > 0.0 ) ? 100.0 * other / wall : 0.0 );
+  ( void )fprintf( out, "%-7s %9s %14s %11.3f\n\n", "wall", "", "", wall * SECONDS_TO_MS );
+
+  if( has_cycles || has_instructions || has_misses )
+  {
+    ( void )fprintf( out, "Counters (%s):\n", user_only ? "user space" : "user space and kernel" );
+    if( has_cycles )
+    {
+      ( void )fprintf( out, "  cycles         %16.0f\n", cycles );
+    }
+    if( has_instructions )
+    {
+      ( void )fprintf( out, "  instructions   %16.0f", instructions );
+      if( has_cycles && ( cycles > 0.0 ) )
+      {
+        ( void )fprintf( out, "  (%.2f per cycle)", instructions / cycles );
+      }
+      ( void )fprintf( out, "\n" );
+    }
+    if( has_misses )
+    {
+      ( void )fprintf( out, "  cache misses   %16.0f\n", misses );
+    }
+  }
+  if( !has_cycles || !has_instructions || !has_misses )
+  {
+    ( void )fprintf( out, "%s counters are not available: %s%s\n",
+                          ( has_cycles || has_instructions || has_misses ) ? "Some" : "The",
+                          strerror( counter_errno ? counter_errno : ENOENT ),
+                          ( ( counter_errno == EACCES ) || ( counter_errno == EPERM ) ) ?
+                          ", see /proc/sys/kernel/perf_event_paranoid." : "." );
+  }
+
+  /* The run includes I/O and the comparison runs, the crc stage
+   * gets its share of the cycles by its share of the wall time. */
+  if( bytes && ( has_cycles || tsc ) && ( wall > 0.0 ) )
+  {
+    if( !has_cycles )
+    {
+      cycles = ( double )tsc;
+    }
+    ( void )fprintf( out, "Cycles per byte: %.3f of the run, %.3f of the crc stage%s\n",
+                          cycles / ( double )bytes,
+                          cycles * stages[ CRC_STAGE_CRC ].seconds / wall / ( double )bytes,
+                          has_cycles ? "" : " (time stamp counter)" );
+  }
+
+  if( !getrusage( RUSAGE_SELF, &usage ) )
+  {
+    ( void )fprintf( out, "Peak RSS: %.1f MiB\n"
+                          "Page faults: %ld minor, %ld major\n"
+                          "CPU time: %.3f s user, %.3f s system\n",
+                          ( double )usage.ru_maxrss / 1024.0,
+                          usage.ru_minflt, usage.ru_majflt,
+                          ( double )usage.ru_utime.tv_sec +
+                          ( double )usage.ru_utime.tv_usec * 1e-6,
+                          ( double )usage.ru_stime.tv_sec +
+                          ( double )usage.ru_stime.tv_usec * 1e-6 );
+  }
+
+  for( i = 0U; i < COUNTER_COUNT; i++ )
+  {
+    if( counter_fd[ i ] != ( -1 ) )
+    {
+      ( void )close( counter_fd[ i ] );
+      counter_fd[ i ] = ( -1 );
+    }
+  }
+}
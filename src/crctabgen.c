@@ -0,0 +1,400 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      crctabgen.c
+ *
+ *
+ * Purpose:   Host program of the build which writes the
+ *            lookup tables of every model in crcparam_even.h
+ *            (CRC_MODEL_LIST) as const C arrays to stdout.
+ *            The Makefile redirects them into the header
+ *            gen/crctables.h, which only crcmodel.c includes.
+ *
+ *
+ * Remarks:   - The 64 bit tables have the layout of
+ *              crc_lut_tables_t (crckernel.h) with all
+ *              CRC_MAX_SLICES slices. Reflected models are
+ *              reflected and right aligned, the others are
+ *              left aligned, as crc_lut_build does it.
+ *
+ *            - The tables only depend on the width, the
+ *              polynomial and refin. They are written once
+ *              per distinct set, named after its first model,
+ *              the names of the other models are macros
+ *              which refer to it.
+ *
+ *            - The models of degree 16 get the tables of
+ *              the dedicated CRC16 kernels of crcbyte.c too.
+ *
+ *            - The tables end up in .rodata, so the processes
+ *              share their pages and nothing is built at runtime.
+ *
+ *            - crctabgen -s HEADER... writes the amalgamation
+ *              lib/crcsingle.h instead: the headers without
+ *              their crc includes, slice 0 of every table set
+ *              and the model kernels as static inline
+ *              functions (crcinline.h).
+ *
+ *
+ * Date:      10/2026
+ *
+ */
+
+#include <crctypes.h>
+#include <crcparam_even.h>
+#include <crckernel.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+
+#define TOP_BIT 0x8000000000000000UL
+
+#define LINE_SIZE 1024U
+
+/* values per line of the emitted tables */
+#define LINE_VALUES_64 4U
+#define LINE_VALUES_16 8U
+
+
+typedef struct gen_model
+{
+  const char* name;
+  uint8_t     width;
+  uint64_t    poly;
+  uint8_t     refin;
+
+} gen_model_t;
+
+
+#define GEN_MODEL_ENTRY( name, title, spec, check ) GEN_MODEL_ENTRY_( name, spec )
+#define GEN_MODEL_ENTRY_( name, width, poly, initial, final, refin, refout ) \
+  { #name, width, poly, refin },
+
+static const gen_model_t models[] =
+{
+  CRC_MODEL_LIST( GEN_MODEL_ENTRY )
+};
+
+#define MODEL_COUNT ( ( uint32_t )( sizeof( models ) / sizeof( models[ 0 ] ) ) )
+
+
+static uint64_t slice[ CRC_MAX_SLICES ][ 0x100U ];
+
+
+static uint64_t reflect_width( uint64_t v, uint8_t width );
+static uint32_t table_owner( uint32_t index );
+static void emit_table_alias( const char* prefix, uint32_t index );
+static void build_slices( const gen_model_t* m );
+static void emit_tables_64( const gen_model_t* m );
+static void emit_tables_16( const gen_model_t* m );
+static void emit_table_single( const gen_model_t* m );
+static void copy_header( const char* file );
+static void emit_single( int count, char* headers[] );
+static void emit_tables( void );
+
+
+static uint64_t reflect_width( uint64_t v, uint8_t width )
+{
+  uint64_t r = 0UL;
+  uint8_t i;
+
+  for( i = 0U; i < width; i++ )
+  {
+    r = ( r << 1U ) | ( v & 1UL );
+    v >>= 1U;
+  }
+  return r;
+}
+
+
+/* first model with the tables of the model at index */
+static uint32_t table_owner( uint32_t index )
+{
+  uint32_t i;
+
+  for( i = 0U; i < index; i++ )
+  {
+    if( ( models[ i ].width == models[ index ].width ) &&
+        ( models[ i ].poly == models[ index ].poly ) &&
+        ( !models[ i ].refin == !models[ index ].refin ) )
+    {
+      break;
+    }
+  }
+  return i;
+}
+
+
+static void emit_table_alias( const char* prefix, uint32_t index )
+{
+  ( void )fprintf( stdout, "#define %s%s %s%s\n\n", prefix, models[ index ].name,
+                   prefix, models[ table_owner( index ) ].name );
+}
+
+
+static void build_slices( const gen_model_t* m )
+{
+  uint64_t reg, poly;
+  uint16_t i;
+  uint8_t j, k;
+
+  poly = m->refin ? reflect_width( m->poly, m->width ) :
+                    m->poly << ( 64U - m->width );
+
+  for( i = 0U; i < 0x100U; i++ )
+  {
+    if( m->refin )
+    {
+      reg = ( uint64_t )i;
+      for( j = 0U; j < 8U; j++ )
+      {
+        reg = ( reg & 1UL ) ? ( reg >> 1U ) ^ poly : ( reg >> 1U );
+      }
+    }
+    else
+    {
+      reg = ( uint64_t )i << 56U;
+      for( j = 0U; j < 8U; j++ )
+      {
+        reg = ( reg & TOP_BIT ) ? ( reg << 1U ) ^ poly : ( reg << 1U );
+      }
+    }
+    slice[ 0U ][ i ] = reg;
+  }
+
+  for( k = 1U; k < CRC_MAX_SLICES; k++ )
+  {
+    for( i = 0U; i < 0x100U; i++ )
+    {
+      reg = slice[ k - 1U ][ i ];
+      slice[ k ][ i ] = m->refin ?
+                        ( reg >> 8U ) ^ slice[ 0U ][ ( uint8_t )reg ] :
+                        ( reg << 8U ) ^ slice[ 0U ][ ( uint8_t )( reg >> 56U ) ];
+    }
+  }
+}
+
+
+static void emit_tables_64( const gen_model_t* m )
+{
+  uint16_t i;
+  uint8_t k;
+
+  ( void )fprintf( stdout, "static const crc_lut_tables_t lut_%s =\n{\n  {\n", m->name );
+  for( k = 0U; k < CRC_MAX_SLICES; k++ )
+  {
+    ( void )fprintf( stdout, "    {\n" );
+    for( i = 0U; i < 0x100U; i++ )
+    {
+      ( void )fprintf( stdout, "%s0x%016lXUL%s",
+                       ( i % LINE_VALUES_64 ) ? " " : "      ",
+                       ( unsigned long )slice[ k ][ i ],
+                       ( i == 0xFFU ) ? "\n" :
+                       ( ( i % LINE_VALUES_64 ) == LINE_VALUES_64 - 1U ) ? ",\n" : "," );
+    }
+    ( void )fprintf( stdout, "    }%s\n", ( k < CRC_MAX_SLICES - 1U ) ? "," : "" );
+  }
+  ( void )fprintf( stdout, "  }\n};\n\n" );
+}
+
+
+/* The CRC16 kernels of crcbyte.c keep the register in 16 bit, the
+ * reflected tables are right aligned anyway and the others are the
+ * upper quarter of the left aligned ones. */
+static void emit_tables_16( const gen_model_t* m )
+{
+  uint16_t i;
+  uint8_t k;
+  uint16_t value;
+
+  ( void )fprintf( stdout, "static const uint16_t lut_16_%s[ CRC_MAX_SLICES ][ 0x100U ] =\n{\n",
+                   m->name );
+  for( k = 0U; k < CRC_MAX_SLICES; k++ )
+  {
+    ( void )fprintf( stdout, "  {\n" );
+    for( i = 0U; i < 0x100U; i++ )
+    {
+      value = m->refin ? ( uint16_t )slice[ k ][ i ] :
+                         ( uint16_t )( slice[ k ][ i ] >> 48U );
+      ( void )fprintf( stdout, "%s0x%04XU%s",
+                       ( i % LINE_VALUES_16 ) ? " " : "    ",
+                       ( unsigned int )value,
+                       ( i == 0xFFU ) ? "\n" :
+                       ( ( i % LINE_VALUES_16 ) == LINE_VALUES_16 - 1U ) ? ",\n" : "," );
+    }
+    ( void )fprintf( stdout, "  }%s\n", ( k < CRC_MAX_SLICES - 1U ) ? "," : "" );
+  }
+  ( void )fprintf( stdout, "};\n\n" );
+}
+
+
+/* slice 0 only, the model kernels crunch byte by byte */
+static void emit_table_single( const gen_model_t* m )
+{
+  uint16_t i;
+
+  ( void )fprintf( stdout, "static const uint64_t crc_single_lut_%s[ 0x100U ] =\n{\n", m->name );
+  for( i = 0U; i < 0x100U; i++ )
+  {
+    ( void )fprintf( stdout, "%s0x%016lXUL%s",
+                     ( i % LINE_VALUES_64 ) ? " " : "  ",
+                     ( unsigned long )slice[ 0U ][ i ],
+                     ( i == 0xFFU ) ? "\n" :
+                     ( ( i % LINE_VALUES_64 ) == LINE_VALUES_64 - 1U ) ? ",\n" : "," );
+  }
+  ( void )fprintf( stdout, "};\n\n" );
+}
+
+
+/* the header without the includes of the crc headers,
+ * they are part of the amalgamation */
+static void copy_header( const char* file )
+{
+  char line[ LINE_SIZE ];
+  uint8_t line_start = 0xFFU;
+  FILE* f;
+
+  f = fopen( file, "r" );
+  if( f == NULL )
+  {
+    ( void )fprintf( stderr, "Failed to open %s.\n", file );
+    exit( EXIT_FAILURE );
+  }
+
+  while( fgets( line, ( int )sizeof( line ), f ) != NULL )
+  {
+    if( !line_start || strncmp( line, "#include <crc", 13U ) )
+    {
+      ( void )fputs( line, stdout );
+    }
+    line_start = ( line[ strlen( line ) - 1U ] == '\n' ) ? 0xFFU : 0x00U;
+  }
+
+  ( void )fclose( f );
+}
+
+
+static void emit_single( int count, char* headers[] )
+{
+  uint32_t i;
+  int j;
+
+  ( void )fprintf( stdout, "/* Generated by crctabgen from crcparam_even.h and crcinline.h,\n"
+                           " * do not edit.\n"
+                           " *\n"
+                           " * The model kernels of libcrc in a single header. Include it\n"
+                           " * instead of crcmodel.h, then NAME( data, len ), NAME_init,\n"
+                           " * NAME_update and NAME_final (see crcmodel.h) are inlined and\n"
+                           " * short messages go without a call into the library. Only the\n"
+                           " * tables of the models in use end up in the binary. */\n\n" );
+  ( void )fprintf( stdout, "#ifndef __CRC_SINGLE_H_\n"
+                           "#define __CRC_SINGLE_H_\n\n" );
+
+  for( j = 0; j < count; j++ )
+  {
+    copy_header( headers[ j ] );
+    ( void )fprintf( stdout, "\n\n" );
+  }
+
+  for( i = 0U; i < MODEL_COUNT; i++ )
+  {
+    if( table_owner( i ) < i )
+    {
+      emit_table_alias( "crc_single_lut_", i );
+      continue;
+    }
+    build_slices( &models[ i ] );
+    emit_table_single( &models[ i ] );
+  }
+
+  ( void )fprintf( stdout, "\n#define CRC_SINGLE_MODEL( name, title, spec, check ) \\\n"
+                           "  CRC_INLINE_MODEL( CRC_INLINE, name, crc_single_lut_##name, spec )\n\n"
+                           "CRC_MODEL_LIST( CRC_SINGLE_MODEL )\n\n"
+                           "#endif /* __CRC_SINGLE_H_ */\n" );
+}
+
+
+static void emit_tables( void )
+{
+  uint32_t i;
+
+  ( void )fprintf( stdout, "/* Generated by crctabgen from crcparam_even.h, do not edit. */\n\n"
+                           "#ifndef __CRC_TABLES_H_\n"
+                           "#define __CRC_TABLES_H_\n\n"
+                           "#include <crckernel.h>\n\n"
+                           "#include <stdint.h>\n"
+                           "#include <stddef.h>\n\n\n" );
+
+  for( i = 0U; i < MODEL_COUNT; i++ )
+  {
+    if( table_owner( i ) < i )
+    {
+      emit_table_alias( "lut_", i );
+      if( models[ i ].width == 16U )
+      {
+        emit_table_alias( "lut_16_", i );
+      }
+      continue;
+    }
+    build_slices( &models[ i ] );
+    emit_tables_64( &models[ i ] );
+    if( models[ i ].width == 16U )
+    {
+      emit_tables_16( &models[ i ] );
+    }
+  }
+
+  /* indexed like CRC_MODEL_LIST, models with
+   * the same tables point to the same set */
+  ( void )fprintf( stdout, "\nstatic const crc_lut_tables_t* const model_luts[] =\n{\n" );
+  for( i = 0U; i < MODEL_COUNT; i++ )
+  {
+    ( void )fprintf( stdout, "  &lut_%s%s\n", models[ i ].name,
+                     ( i < MODEL_COUNT - 1U ) ? "," : "" );
+  }
+  ( void )fprintf( stdout, "};\n\n" );
+
+  ( void )fprintf( stdout, "static const uint16_t ( * const model_luts_16[] )[ 0x100U ] =\n{\n" );
+  for( i = 0U; i < MODEL_COUNT; i++ )
+  {
+    if( models[ i ].width == 16U )
+    {
+      ( void )fprintf( stdout, "  lut_16_%s", models[ i ].name );
+    }
+    else
+    {
+      ( void )fprintf( stdout, "  NULL" );
+    }
+    ( void )fprintf( stdout, "%s\n", ( i < MODEL_COUNT - 1U ) ? "," : "" );
+  }
+  ( void )fprintf( stdout, "};\n\n#endif /* __CRC_TABLES_H_ */\n" );
+}
+
+
+int main( int argc, char* argv[] )
+{
+  if( ( argc > 1 ) && !strcmp( argv[ 1 ], "-s" ) )
+  {
+    emit_single( argc - 2, &argv[ 2 ] );
+  }
+  else
+  {
+    emit_tables();
+  }
+
+  if( fflush( stdout ) )
+  {
+    ( void )fprintf( stderr, "Failed to write the tables.\n" );
+    exit( EXIT_FAILURE );
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -25,52 +25,213 @@
 #include <util.h>
 #include <crcbit.h>
 #include <crcbyte.h>
+#include <crcapi.h>
+#include <crcpar.h>
+#include <crcmodel.h>
+#include <crcstats.h>
 
 #include <stdint.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
 
 #include <linux/limits.h>
 
 #define DEF_CRC_MODE  32
 #define DEF_OPT_LEVEL  0
+#define MAX_CHUNK_KIB  1048576
+
+/* fields of -p: width,poly,init,xorout,refin,refout */
+#define MODEL_FIELDS   6U
+
+/* long options without a short one */
+#define STATS_OPTION   256
 
 
 static uint8_t polynomial_degree = 0x00;
 /* the +1 is to assure that the path string is always 0 terminated. */
 static uint8_t file[ PATH_MAX + 1 ] = { 0x00 };
 static uint8_t optimize_level = 0x00;
+static uint8_t dispatch_report = 0x00;
+static uint16_t threads = 0U;
+static uint8_t stats = 0x00;
+
+/* catalogue model of -m or the parameters of -p */
+static crc_param_t model_params;
+static uint8_t model_set = 0x00;
+
+static const struct option long_options[] =
+{
+  { "stats", no_argument, NULL, STATS_OPTION },
+  { NULL,    0,           NULL, 0 }
+};
+
+/* more than one input file, -f and the operands */
+static const char** file_list = NULL;
+static uint32_t file_list_count = 0U;
+
+/* kernel of calculate_crc_of_files for every optimize level,
+ * the bitwise engine crunches one file at a time, so -o 0 is
+ * dispatched with the parameter set of the bitwise engine */
+static const uint8_t level_kernels[] =
+{
+  CRC_KERNEL_AUTO,    CRC_KERNEL_BITWISE, CRC_KERNEL_LUT, 
+  CRC_KERNEL_SLICE_4, CRC_KERNEL_SLICE_8, CRC_KERNEL_SLICE_16, 
+  CRC_KERNEL_CLMUL,   CRC_KERNEL_SSE42,   CRC_KERNEL_AUTO
+};
 
 
 static void parse_args( int argc, char** argv );
 static void print_usage( FILE* out );
+static uint8_t parse_model_params( const char* spec, crc_param_t* crc_params );
+static void print_model_list( FILE* out );
 
 
 static void print_usage( FILE* out )
 {
   ( void )fprintf( out, "\nUsage: \n"
-                        " crc [-w crc_polynomial_degree] -f ./valid/file/path\n\n"
+                        " crc [-w crc_polynomial_degree] -f ./valid/file/path\n"
+                        " crc [-w crc_polynomial_degree] file...\n"
+                        " crc -m CRC-32/ISCSI file...\n\n"
                         "=====================================================\n"
                         " Example: crc -w 32 -f /boot/vmlinuz-4.9.0-3-amd64\n" 
                         "=====================================================\n\n" );
   /* 
-   * Splitted into two fprintf calls because of the:
+   * Splitted into several fprintf calls because of the:
    * error: string length ‘n’ is greater than the length ‘509’ 
    * ISO C90 compilers are required to support [-Woverlength-strings]
    */
   ( void )fprintf( out, "   -w   CRC Polynomial degree / Checksum width\n"
                         "        Default vlaue is 32 (CRC32).\n" 
                         "   -f   Valid path (relative or absolute)\n"
-                        "        to an input file.\n"
-                        "   -o   0 (default):\n"
+                        "        to an input file, - reads stdin. Without\n"
+                        "        -f a pipe on stdin is read.\n" );
+  ( void )fprintf( out, "   -m   Named model of the catalogue, replaces -w.\n"
+                        "        -m list prints the catalogue and checks\n"
+                        "        every model against its check value.\n"
+                        "   -p   Model which is not in the catalogue:\n"
+                        "        width,poly,init,xorout,refin,refout\n"
+                        "        e.g. -p 16,0x8005,0,0,1,1 (CRC-16/ARC).\n" );
+  ( void )fprintf( out, "   -o   0 (default):\n"
                         "        No optimisation. Process the input stream\n" 
                         "        bitwise. (Shift register approach)\n"
                         "        1:\n"
                         "        Process bytewise\n"
                         "        2:\n"
-                        "        Process bytewise with lookup table.\n\n" );
+                        "        Process bytewise with lookup table.\n"
+                        "        3, 4, 5:\n"
+                        "        Process bytewise with slicing-by-4, -8\n"
+                        "        or -16 lookup tables.\n" );
+  ( void )fprintf( out, "        6:\n"
+                        "        Fold 64 byte blocks with carry-less\n"
+                        "        multiplication (PCLMULQDQ).\n"
+                        "        7:\n"
+                        "        CRC-32C (Castagnoli) with the SSE4.2\n"
+                        "        crc32 instruction, requires -w 32\n"
+                        "        or a model with that polynomial.\n"
+                        "        8:\n"
+                        "        Pick the fastest kernel for this cpu.\n\n" );
+  ( void )fprintf( out, "   -k   Force a kernel with -o 8: bitwise, lut,\n"
+                        "        slice4, slice8, slice16, clmul or sse42.\n"
+                        "   -d   Report the kernel the dispatcher picks\n"
+                        "        for every parameter set.\n" );
+  ( void )fprintf( out, "   -i   Input mode for -o 1 to 8: read (default)\n"
+                        "        copies chunks into a buffer, mmap maps\n"
+                        "        the file and crunches the page cache,\n"
+                        "        uring keeps reads in flight (io_uring),\n"
+                        "        pipe reads ahead in a thread of its own.\n"
+                        "        direct (O_DIRECT) and nocache (DONTNEED)\n"
+                        "        keep the file out of the page cache.\n" );
+  ( void )fprintf( out, "   -q   Number of reads in flight with -i uring\n"
+                        "        (default 8) or buffers of -i pipe (4).\n"
+                        "   -b   Chunk size in KiB of -i read (65536),\n"
+                        "        uring, pipe (4096), direct, nocache (16384)\n"
+                        "        and -o 0 (1024). Smaller files get\n"
+                        "        smaller buffers.\n" );
+  ( void )fprintf( out, "   -j   Number of threads. Every thread preads its\n"
+                        "        own part of the file, the partial checksums\n"
+                        "        are combined. Same checksum as -o 0.\n\n" );
+  ( void )fprintf( out, "   --stats\n"
+                        "        Time open, read and crc of every chunk and\n"
+                        "        report them with the cycles, instructions\n"
+                        "        and cache misses (perf_event_open), the\n"
+                        "        cycles per byte, peak RSS and page faults.\n\n" );
+  ( void )fprintf( out, " Several files get one checksum per line and the\n"
+                        " p50 and p99 latency per file. -o 0 uses -o 8 then.\n\n" );
+}
+
+
+/* Returns 0x00 if the spec is malformed or a value does not fit
+ * into the width. The values are not reflected. */
+static uint8_t parse_model_params( const char* spec, crc_param_t* crc_params )
+{
+  unsigned long value[ MODEL_FIELDS ];
+  const char* str = spec;
+  char* endptr;
+  uint8_t i;
+
+  for( i = 0U; i < MODEL_FIELDS; i++ )
+  {
+    errno = 0;
+    value[ i ] = strtoul( str, &endptr, 0 );
+    if( errno || ( endptr == str ) || ( *str == '-' ) ||
+        ( *endptr != ( ( i < MODEL_FIELDS - 1U ) ? ',' : '\0' ) ) )
+    {
+      return 0x00;
+    }
+    str = endptr + 1;
+  }
+
+  if( !value[ 0 ] || ( value[ 0 ] > 64UL ) || ( value[ 4 ] > 1UL ) || ( value[ 5 ] > 1UL ) )
+  {
+    return 0x00;
+  }
+  for( i = 1U; i < 4U; i++ )
+  {
+    if( ( value[ 0 ] < 64UL ) && ( value[ i ] >> value[ 0 ] ) )
+    {
+      return 0x00;
+    }
+  }
+
+  return crc_param_set( crc_params, ( uint8_t )value[ 0 ], value[ 1 ], value[ 2 ], 
+                        value[ 3 ], ( uint8_t )value[ 4 ], ( uint8_t )value[ 5 ] );
+}
+
+
+/* the check value is the checksum of "123456789" */
+static void print_model_list( FILE* out )
+{
+  const uint8_t check_input[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+  const crc_model_t* model;
+  uint32_t i;
+  int digits;
+
+  ( void )fprintf( out, "%-16s %5s %18s %18s %18s %5s %6s %18s\n", "name", "width", 
+                        "poly", "init", "xorout", "refin", "refout", "check" );
+
+  for( i = 0U; i < crc_model_count(); i++ )
+  {
+    model  = crc_model_get( i );
+    digits = ( int )( ( model->params.degree + 3U ) / 4U );
+
+    ( void )fprintf( out, "%-16s %5d %*s0x%0*lx %*s0x%0*lx %*s0x%0*lx %5s %6s %*s0x%0*lx %s\n",
+                          model->name, model->params.degree,
+                          16 - digits, "", digits, 
+                          get_param_value( &model->params.coeff, model->params.degree ),
+                          16 - digits, "", digits, 
+                          get_param_value( &model->params.initial_xor, model->params.degree ),
+                          16 - digits, "", digits, 
+                          get_param_value( &model->params.final_xor, model->params.degree ),
+                          model->params.reflect_input ? "true" : "false",
+                          model->params.reflect_remainder ? "true" : "false",
+                          16 - digits, "", digits, model->check,
+                          ( model->oneshot( check_input, sizeof( check_input ) ) == 
+                            model->check ) ? "ok" : "FAILED" );
+  }
 }
 
 
@@ -84,13 +245,17 @@ static void parse_args( int argc, char** argv )
   uint8_t ignore_poly     = 0;
   uint8_t optimize_count  = 0;
   uint8_t ignore_optimize = 0;
+  uint8_t kernel          = 0;
+  uint8_t ignore_model    = 0;
+  const crc_model_t* model;
 
-  if( argc <= 1 )
+  if( ( argc <= 1 ) && isatty( STDIN_FILENO ) )
   {
     goto parse_fail;
   }
 
-  while( ( option = getopt( argc, argv, "w:f:o:" ) ) != -1 )
+  while( ( option = getopt_long( argc, argv, "w:f:o:k:di:j:q:b:m:p:", 
+                                 long_options, NULL ) ) != -1 )
   {
     switch( option )
     {
@@ -123,7 +288,8 @@ static void parse_args( int argc, char** argv )
       {
         if( !ignore_file )
         {
-          ( void )strncpy( ( char* )&file[ 0 ], optarg, PATH_MAX );
+          ( void )strncpy( ( char* )&file[ 0 ], 
+                           strcmp( optarg, "-" ) ? optarg : STDIN_PATH, PATH_MAX );
           if( !access( ( const char* )&file[ 0 ], F_OK ) )
           {
             file_count++;
@@ -147,6 +313,12 @@ static void parse_args( int argc, char** argv )
             case 0:
             case 1:
             case 2:
+            case 3:
+            case 4:
+            case 5:
+            case 6:
+            case 7:
+            case 8:
               optimize_level = ( uint8_t )parsed_number;
               optimize_count++;
               break;
@@ -159,17 +331,204 @@ static void parse_args( int argc, char** argv )
         }
         break;
       }
+      case 'k':
+      {
+        kernel = crc_kernel_from_name( optarg );
+        if( kernel >= CRC_KERNEL_COUNT )
+        {
+          ( void )fprintf( stderr, "Unknown kernel: %s\n", optarg );
+          goto parse_fail;
+        }
+        ( void )crc_force_kernel( kernel );
+        break;
+      }
+      case 'd':
+      {
+        dispatch_report = 0xFF;
+        break;
+      }
+      case 'j':
+      {
+        parsed_number = try_strtol( optarg );
+        if( ( parsed_number < 1 ) || ( parsed_number > ( long )CRC_PAR_MAX_THREADS ) )
+        {
+          ( void )fprintf( stderr, "The number of threads must be 1 up to %d.\n",
+                                   CRC_PAR_MAX_THREADS );
+          goto parse_fail;
+        }
+        threads = ( uint16_t )parsed_number;
+        break;
+      }
+      case 'i':
+      {
+        if( !strcmp( optarg, "read" ) )
+        {
+          set_bytewise_input_mode( CRC_INPUT_READ );
+        }
+        else if( !strcmp( optarg, "mmap" ) )
+        {
+          set_bytewise_input_mode( CRC_INPUT_MMAP );
+        }
+        else if( !strcmp( optarg, "uring" ) )
+        {
+          set_bytewise_input_mode( CRC_INPUT_URING );
+        }
+        else if( !strcmp( optarg, "pipe" ) )
+        {
+          set_bytewise_input_mode( CRC_INPUT_PIPE );
+        }
+        else if( !strcmp( optarg, "direct" ) )
+        {
+          set_bytewise_input_mode( CRC_INPUT_DIRECT );
+        }
+        else if( !strcmp( optarg, "nocache" ) )
+        {
+          set_bytewise_input_mode( CRC_INPUT_NOCACHE );
+        }
+        else
+        {
+          ( void )fprintf( stderr, "Unknown input mode: %s\n", optarg );
+          goto parse_fail;
+        }
+        break;
+      }
+      case 'q':
+      {
+        parsed_number = try_strtol( optarg );
+        if( ( parsed_number < 1 ) || ( parsed_number > ( long )URING_MAX_QUEUE_DEPTH ) )
+        {
+          ( void )fprintf( stderr, "The queue depth must be 1 up to %d.\n",
+                                   URING_MAX_QUEUE_DEPTH );
+          goto parse_fail;
+        }
+        set_bytewise_queue_depth( ( uint32_t )parsed_number );
+        break;
+      }
+      case 'b':
+      {
+        parsed_number = try_strtol( optarg );
+        if( ( parsed_number < 1 ) || ( parsed_number > MAX_CHUNK_KIB ) )
+        {
+          ( void )fprintf( stderr, "The chunk size must be 1 up to %d KiB.\n",
+                                   MAX_CHUNK_KIB );
+          goto parse_fail;
+        }
+        set_bytewise_chunk_size( ( size_t )parsed_number * 1024U );
+        set_bitwise_chunk_size( ( size_t )parsed_number * 1024U );
+        break;
+      }
+      case 'm':
+      {
+        if( !strcmp( optarg, "list" ) )
+        {
+          print_model_list( stdout );
+          exit( EXIT_SUCCESS );
+        }
+        if( ignore_model++ )
+        {
+          ( void )fprintf( stdout, "Ignoring further model arguments.\n" );
+          break;
+        }
+        if( !( model = crc_model_find( optarg ) ) )
+        {
+          ( void )fprintf( stderr, "Unknown model: %s, crc -m list shows the "
+                                   "catalogue.\n", optarg );
+          goto parse_fail;
+        }
+        model_params = model->params;
+        model_set = 0xFF;
+        break;
+      }
+      case 'p':
+      {
+        if( ignore_model++ )
+        {
+          ( void )fprintf( stdout, "Ignoring further model arguments.\n" );
+          break;
+        }
+        if( !parse_model_params( optarg, &model_params ) )
+        {
+          ( void )fprintf( stderr, "Invalid model parameters: %s\n", optarg );
+          goto parse_fail;
+        }
+        model_set = 0xFF;
+        break;
+      }
+      case STATS_OPTION:
+      {
+        stats = 0xFF;
+        break;
+      }
       default:
       {
         goto parse_fail;
       }
     }
   }
+  if( ( optind < argc ) && !ignore_file && ( optind == argc - 1 ) )
+  {
+    /* crc file */
+    ( void )strncpy( ( char* )&file[ 0 ], 
+                     strcmp( argv[ optind ], "-" ) ? argv[ optind ] : STDIN_PATH, PATH_MAX );
+    if( !access( ( const char* )&file[ 0 ], F_OK ) )
+    {
+      file_count++;
+    }
+    ignore_file++;
+  }
+  else if( optind < argc )
+  {
+    /* crc file... , missing files are reported one by one */
+    if( !( file_list = ( const char** )malloc( ( size_t )( argc - optind + 1 ) * 
+                                               sizeof( const char* ) ) ) )
+    {
+      ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+      exit( EXIT_FAILURE );
+    }
+    if( ignore_file )
+    {
+      file_list[ file_list_count++ ] = ( const char* )&file[ 0 ];
+    }
+    for( ; optind < argc; optind++ )
+    {
+      file_list[ file_list_count++ ] = strcmp( argv[ optind ], "-" ) ? argv[ optind ] : 
+                                                                       STDIN_PATH;
+    }
+    file_count++;
+    ignore_file++;
+  }
+  if( dispatch_report )
+  {
+    print_dispatch_report( stdout );
+    if( !ignore_file )
+    {
+      exit( EXIT_SUCCESS );
+    }
+  }
+  if( !ignore_file && !isatty( STDIN_FILENO ) )
+  {
+    /* tar c dir | crc */
+    ( void )strncpy( ( char* )&file[ 0 ], STDIN_PATH, PATH_MAX );
+    file_count++;
+  }
   if( !file_count )
   {
     ( void )fprintf( stderr, "One input file that exists (valid path) must be specified.\n" );
     goto parse_fail;
   }
+  if( model_set )
+  {
+    if( ignore_poly && ( polynomial_degree != model_params.degree ) )
+    {
+      ( void )fprintf( stdout, "Ignoring -w, the model has a width of %d.\n", 
+                               model_params.degree );
+    }
+    polynomial_degree = model_params.degree;
+    poly_count++;
+    set_bitwise_params( ( const crc_param_t* )&model_params );
+    set_bytewise_params( ( const crc_param_t* )&model_params );
+    set_parallel_params( ( const crc_param_t* )&model_params );
+  }
   if( !poly_count )
   {
     polynomial_degree = ( uint8_t )DEF_CRC_MODE;
@@ -181,7 +540,7 @@ static void parse_args( int argc, char** argv )
   {
     optimize_level = ( uint8_t )DEF_OPT_LEVEL;
     ( void )fprintf( stdout, "No optimize level was specified. Using the default %d.\n"
-                             "valid optimize levels: [ 0 | 1 | 2 ]\n", DEF_OPT_LEVEL );
+                             "valid optimize levels: [ 0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 ]\n", DEF_OPT_LEVEL );
   }
   return;
   parse_fail:
@@ -193,6 +552,45 @@ static void parse_args( int argc, char** argv )
 int main( int argc, char** argv )
 {
   parse_args( argc, argv );
+  if( stats )
+  {
+    crc_stats_enable();
+  }
+  if( file_list_count )
+  {
+    if( threads )
+    {
+      ( void )fprintf( stdout, "Several files are crunched one after another, ignoring -j.\n" );
+    }
+    if( !optimize_level )
+    {
+      ( void )fprintf( stdout, "The bitwise engine crunches one file at a time, using -o 8.\n" );
+      /* -w 16 of the bitwise engine is CRC-16/KERMIT, the 
+       * checksums stay the ones of -o 0 with a single file */
+      set_bytewise_params( get_bitwise_params( polynomial_degree ) );
+    }
+    calculate_crc_of_files( file_list, file_list_count, 
+                            polynomial_degree, level_kernels[ optimize_level ] );
+    free( ( void* )file_list );
+    crc_stats_report( stdout );
+    return EXIT_SUCCESS;
+  }
+  if( is_stream_input( ( const char* )&file[ 0 ] ) )
+  {
+    /* the threads read the file at given offsets */
+    if( threads )
+    {
+      ( void )fprintf( stdout, "The input is not a regular file, ignoring -j.\n" );
+      threads = 0U;
+    }
+  }
+  if( threads )
+  {
+    calculate_crc_from_file_parallel( ( char* const )&file[ 0 ], 
+                                      polynomial_degree, threads );
+    crc_stats_report( stdout );
+    return EXIT_SUCCESS;
+  }
   switch( optimize_level )
   {
     case 0:
@@ -207,7 +605,32 @@ int main( int argc, char** argv )
       calculate_crc_from_file_bytewise_lut( ( char* const )&file[ 0 ], 
                                             polynomial_degree );
       break;
+    case 3:
+      calculate_crc_from_file_bytewise_slicing( ( char* const )&file[ 0 ], 
+                                                polynomial_degree, 4U );
+      break;
+    case 4:
+      calculate_crc_from_file_bytewise_slicing( ( char* const )&file[ 0 ], 
+                                                polynomial_degree, 8U );
+      break;
+    case 5:
+      calculate_crc_from_file_bytewise_slicing( ( char* const )&file[ 0 ], 
+                                                polynomial_degree, 16U );
+      break;
+    case 6:
+      calculate_crc_from_file_bytewise_clmul( ( char* const )&file[ 0 ], 
+                                              polynomial_degree );
+      break;
+    case 7:
+      calculate_crc_from_file_bytewise_sse42( ( char* const )&file[ 0 ], 
+                                              polynomial_degree );
+      break;
+    case 8:
+      calculate_crc_from_file_bytewise_dispatch( ( char* const )&file[ 0 ], 
+                                                 polynomial_degree );
+      break;
   }
+  crc_stats_report( stdout );
   return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,185 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      spsc.c
+ * 
+ *
+ * Purpose:   Lock free single producer / single
+ *            consumer ring of fixed size buffers.
+ *
+ * 
+ * Remarks:   - head is only written by the producer and
+ *              tail only by the consumer. A release store
+ *              publishes the slot contents together with the
+ *              counter, the other side loads it with acquire.
+ *
+ *            - Both counters live on their own cache line,
+ *              so the threads do not bounce a shared line.
+ *
+ *
+ * Date:      10/2026 
+ * 
+ */
+
+#include <spsc.h>
+#include <util.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+/* polls before a waiting side yields the cpu */
+#define SPIN_TRIES 256U
+
+#define SPSC_ALIGN 4096UL
+
+
+static inline void cpu_relax( void );
+static double wait_for( const uint32_t* counter, uint32_t value, uint8_t equal );
+
+
+static inline void cpu_relax( void )
+{
+#if defined( __x86_64__ )
+  __builtin_ia32_pause();
+#endif
+}
+
+
+/* Waits until *counter equals value (equal) or differs from it.
+ * Returns the seconds waited, 0.0 if no wait was necessary. */
+static double wait_for( const uint32_t* counter, uint32_t value, uint8_t equal )
+{
+  double start;
+  uint32_t tries = 0U;
+
+  if( ( __atomic_load_n( counter, __ATOMIC_ACQUIRE ) == value ) == !!equal )
+  {
+    return 0.0;
+  }
+
+  start = get_monotonic_seconds();
+
+  while( ( __atomic_load_n( counter, __ATOMIC_ACQUIRE ) == value ) != !!equal )
+  {
+    if( ++tries < SPIN_TRIES )
+    {
+      cpu_relax();
+    }
+    else
+    {
+      ( void )sched_yield();
+    }
+  }
+
+  return get_monotonic_seconds() - start;
+}
+
+
+uint8_t spsc_init( spsc_ring_t* ring, uint32_t depth, size_t slot_size )
+{
+  void* arena = NULL;
+
+  ( void )memset( ( void* )ring, 0, sizeof( spsc_ring_t ) );
+
+  if( !depth || !slot_size )
+  {
+    return 0x00U;
+  }
+
+  if( posix_memalign( &arena, SPSC_ALIGN, depth * slot_size ) )
+  {
+    return 0x00U;
+  }
+
+  ring->arena = ( uint8_t* )arena;
+  ring->len   = ( int64_t* )calloc( depth, sizeof( int64_t ) );
+  ring->last  = ( uint8_t* )calloc( depth, sizeof( uint8_t ) );
+
+  if( !ring->len || !ring->last )
+  {
+    spsc_free( ring );
+    return 0x00U;
+  }
+
+  ring->slot_size = slot_size;
+  ring->depth     = depth;
+
+  return 0xFFU;
+}
+
+
+void spsc_free( spsc_ring_t* ring )
+{
+  free( ( void* )ring->arena );
+  free( ( void* )ring->len );
+  free( ( void* )ring->last );
+  ( void )memset( ( void* )ring, 0, sizeof( spsc_ring_t ) );
+}
+
+
+uint8_t* spsc_produce_begin( spsc_ring_t* ring )
+{
+  uint32_t head;
+  double waited;
+
+  head = ring->head;
+
+  /* full while the consumer is depth slots behind */
+  waited = wait_for( &ring->tail, head - ring->depth, 0x00U );
+  if( waited > 0.0 )
+  {
+    ring->stats.producer_stalls++;
+    ring->stats.producer_wait += waited;
+  }
+
+  return ring->arena + ( size_t )( head % ring->depth ) * ring->slot_size;
+}
+
+
+void spsc_produce_commit( spsc_ring_t* ring, int64_t len, uint8_t last )
+{
+  uint32_t head = ring->head;
+
+  ring->len[ head % ring->depth ]  = len;
+  ring->last[ head % ring->depth ] = last;
+
+  __atomic_store_n( &ring->head, head + 1U, __ATOMIC_RELEASE );
+}
+
+
+const uint8_t* spsc_consume_begin( spsc_ring_t* ring, int64_t* len, 
+                                   uint8_t* last )
+{
+  uint32_t tail, slot;
+  double waited;
+
+  tail = ring->tail;
+
+  /* empty while the producer did not get ahead */
+  waited = wait_for( &ring->head, tail, 0x00U );
+  if( waited > 0.0 )
+  {
+    ring->stats.consumer_stalls++;
+    ring->stats.consumer_wait += waited;
+  }
+
+  slot  = tail % ring->depth;
+  *len  = ring->len[ slot ];
+  *last = ring->last[ slot ];
+
+  return ring->arena + ( size_t )slot * ring->slot_size;
+}
+
+
+void spsc_consume_release( spsc_ring_t* ring )
+{
+  __atomic_store_n( &ring->tail, ring->tail + 1U, __ATOMIC_RELEASE );
+}
+
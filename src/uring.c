@@ -0,0 +1,201 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <pl@vqe.ch> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   P. Leibundgut
+ * ----------------------------------------------------------------------------
+ *
+ * File:      uring.c
+ * 
+ *
+ * Purpose:   Minimal io_uring helper on top of the
+ *            raw system calls, so there is no
+ *            dependency on liburing.
+ *
+ * 
+ * Remarks:   - The ring indices are shared with the
+ *              kernel, they are read with acquire and
+ *              written with release semantics.
+ *
+ *
+ * Date:      10/2026 
+ * 
+ */
+
+#include <uring.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <sys/syscall.h>
+#include <sys/mman.h>
+
+
+static int sys_io_uring_setup( uint32_t entries, struct io_uring_params* p );
+static int sys_io_uring_enter( int fd, uint32_t to_submit, uint32_t min_complete,
+                               uint32_t flags );
+
+
+static int sys_io_uring_setup( uint32_t entries, struct io_uring_params* p )
+{
+  return ( int )syscall( __NR_io_uring_setup, entries, p );
+}
+
+
+static int sys_io_uring_enter( int fd, uint32_t to_submit, uint32_t min_complete,
+                               uint32_t flags )
+{
+  return ( int )syscall( __NR_io_uring_enter, fd, to_submit, min_complete, 
+                         flags, NULL, 0 );
+}
+
+
+uint8_t uring_init( uring_t* ring, uint32_t entries )
+{
+  struct io_uring_params p;
+  uint8_t* sq;
+  uint8_t* cq;
+
+  ( void )memset( ( void* )ring, 0, sizeof( uring_t ) );
+  ( void )memset( ( void* )&p, 0, sizeof( p ) );
+
+  ring->ring_fd = sys_io_uring_setup( entries, &p );
+  if( ring->ring_fd < 0 )
+  {
+    return 0x00U;
+  }
+
+  ring->sq_ring_len = p.sq_off.array + p.sq_entries * sizeof( uint32_t );
+  ring->cq_ring_len = p.cq_off.cqes + p.cq_entries * sizeof( struct io_uring_cqe );
+  ring->sqes_len    = p.sq_entries * sizeof( struct io_uring_sqe );
+
+  ring->sq_ring = mmap( NULL, ring->sq_ring_len, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING );
+  ring->cq_ring = mmap( NULL, ring->cq_ring_len, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_CQ_RING );
+  ring->sqes    = ( struct io_uring_sqe* )mmap( NULL, ring->sqes_len, 
+                                                PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, 
+                                                ring->ring_fd, IORING_OFF_SQES );
+
+  if( ( ring->sq_ring == MAP_FAILED ) || ( ring->cq_ring == MAP_FAILED ) ||
+      ( ( void* )ring->sqes == MAP_FAILED ) )
+  {
+    uring_exit( ring );
+    return 0x00U;
+  }
+
+  sq = ( uint8_t* )ring->sq_ring;
+  cq = ( uint8_t* )ring->cq_ring;
+
+  ring->sq_head  = ( uint32_t* )( sq + p.sq_off.head );
+  ring->sq_tail  = ( uint32_t* )( sq + p.sq_off.tail );
+  ring->sq_mask  = ( uint32_t* )( sq + p.sq_off.ring_mask );
+  ring->sq_array = ( uint32_t* )( sq + p.sq_off.array );
+
+  ring->cq_head  = ( uint32_t* )( cq + p.cq_off.head );
+  ring->cq_tail  = ( uint32_t* )( cq + p.cq_off.tail );
+  ring->cq_mask  = ( uint32_t* )( cq + p.cq_off.ring_mask );
+  ring->cqes     = ( struct io_uring_cqe* )( cq + p.cq_off.cqes );
+
+  return 0xFFU;
+}
+
+
+void uring_exit( uring_t* ring )
+{
+  if( ring->sq_ring && ( ring->sq_ring != MAP_FAILED ) )
+  {
+    ( void )munmap( ring->sq_ring, ring->sq_ring_len );
+  }
+  if( ring->cq_ring && ( ring->cq_ring != MAP_FAILED ) )
+  {
+    ( void )munmap( ring->cq_ring, ring->cq_ring_len );
+  }
+  if( ring->sqes && ( ( void* )ring->sqes != MAP_FAILED ) )
+  {
+    ( void )munmap( ( void* )ring->sqes, ring->sqes_len );
+  }
+  if( ring->ring_fd >= 0 )
+  {
+    ( void )close( ring->ring_fd );
+  }
+  ( void )memset( ( void* )ring, 0, sizeof( uring_t ) );
+  ring->ring_fd = ( -1 );
+}
+
+
+uint8_t uring_register_buffers( uring_t* ring, const struct iovec* iov, 
+                                uint32_t n )
+{
+  return ( syscall( __NR_io_uring_register, ring->ring_fd, 
+                    IORING_REGISTER_BUFFERS, iov, n ) < 0 ) ? 0x00U : 0xFFU;
+}
+
+
+struct io_uring_sqe* uring_get_sqe( uring_t* ring )
+{
+  struct io_uring_sqe* sqe;
+  uint32_t head, tail, index;
+
+  head = __atomic_load_n( ring->sq_head, __ATOMIC_ACQUIRE );
+  tail = *ring->sq_tail + ring->pending;
+
+  if( tail - head > *ring->sq_mask )
+  {
+    return NULL;
+  }
+
+  index = tail & *ring->sq_mask;
+  sqe = &ring->sqes[ index ];
+  ( void )memset( ( void* )sqe, 0, sizeof( struct io_uring_sqe ) );
+
+  ring->sq_array[ index ] = index;
+  ring->pending++;
+
+  return sqe;
+}
+
+
+int uring_submit( uring_t* ring, uint32_t wait_nr )
+{
+  uint32_t to_submit;
+  int ret;
+
+  to_submit = ring->pending;
+
+  /* publish the new entries before the kernel sees the tail */
+  __atomic_store_n( ring->sq_tail, *ring->sq_tail + to_submit, __ATOMIC_RELEASE );
+  ring->pending = 0U;
+
+  do
+  {
+    ret = sys_io_uring_enter( ring->ring_fd, to_submit, wait_nr,
+                              wait_nr ? IORING_ENTER_GETEVENTS : 0U );
+  } while( ( ret < 0 ) && ( errno == EINTR ) );
+
+  return ( ret < 0 ) ? -errno : ret;
+}
+
+
+struct io_uring_cqe* uring_peek_cqe( uring_t* ring )
+{
+  uint32_t head;
+
+  head = *ring->cq_head;
+  if( head == __atomic_load_n( ring->cq_tail, __ATOMIC_ACQUIRE ) )
+  {
+    return NULL;
+  }
+  return &ring->cqes[ head & *ring->cq_mask ];
+}
+
+
+void uring_cqe_seen( uring_t* ring )
+{
+  __atomic_store_n( ring->cq_head, *ring->cq_head + 1U, __ATOMIC_RELEASE );
+}
+
@@ -13,14 +13,42 @@
  *            functions to do this and that.
  *
  * 
- * Remarks:   -
+ * Remarks:   - The bit reflection of whole buffers uses
+ *              pshufb with a nibble table (SSSE3/AVX2)
+ *              when the cpu supports it. Otherwise and
+ *              for the tails a bswap based scalar path
+ *              is used.
+ *
+ *            - walk_file sizes its buffer from the file:
+ *              small files go into a static buffer, up to
+ *              POOL_BUF_SIZE the buffer is kept for the next
+ *              file, only larger ones get their own chunks.
+ *
+ *            - walk_file_uring keeps several reads in
+ *              flight with io_uring (see uring.c).
+ *
+ *            - walk_file_pipe reads ahead in a thread of its
+ *              own into a ring of buffers (see spsc.c).
+ *
+ *            - walk_file_direct keeps the file out of the
+ *              page cache (O_DIRECT or POSIX_FADV_DONTNEED).
+ *
+ *            - walk_stream handles pipes, sockets and devices,
+ *              whose length is only known at the end.
  *
  *
  * Date:      09/2017 
  * 
  */
 
+/* O_DIRECT */
+#define _GNU_SOURCE
+
+#include <crc.h>
 #include <util.h>
+#include <uring.h>
+#include <spsc.h>
+#include <crcstats.h>
 
 #include <stdint.h>
 #include <stdlib.h>
@@ -29,14 +57,82 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 
 
 #define BASE 10
 
+#define REFLECT_SIMD_UNKNOWN 0xFFU
+#define REFLECT_SIMD_NONE    0x00U
+#define REFLECT_SIMD_SSSE3   0x01U
+#define REFLECT_SIMD_AVX2    0x02U
+
+#if defined( __x86_64__ )
+#define REFLECT_SIMD_AVAILABLE
+#include <immintrin.h>
+#define SSSE3_TARGET __attribute__( ( target( "ssse3" ) ) )
+#define AVX2_TARGET  __attribute__( ( target( "avx2" ) ) )
+#endif
+
+#define URING_ALIGN 4096UL
+
+/* O_DIRECT wants buffers, offsets and lengths aligned to the 
+ * logical block size of the device, 4 KiB covers all common ones */
+#define DIRECT_ALIGN 4096UL
+
+/* pipe capacity asked for by walk_stream, the default of 64 KiB 
+ * makes the writer and reader ping pong at every 16 pages */
+#define STREAM_PIPE_SIZE ( 1024 * 1024 )
+
+
+/* State of walk_file_uring. Chunk k of the file is read into
+ * slot k % depth, so the slots complete in any order but are
+ * handed out in file order. */
+typedef struct uring_walk
+{
+  uring_t  ring;
+  uint8_t  use_ring;
+  uint8_t  fixed;
+  uint8_t  holding;
+  int      fd;
+  uint8_t* arena;
+  uint32_t depth;
+  uint32_t deliver_slot;
+  uint64_t chunk_len;
+  uint64_t file_len;
+  uint64_t submit_pos;
+  uint64_t deliver_pos;
+
+  uint64_t offset[ URING_MAX_QUEUE_DEPTH ];
+  uint64_t len[ URING_MAX_QUEUE_DEPTH ];
+  int32_t  result[ URING_MAX_QUEUE_DEPTH ];
+  uint8_t  done[ URING_MAX_QUEUE_DEPTH ];
+
+} uring_walk_t;
+
+
+/* State of walk_file_pipe, the reader thread owns fd. */
+typedef struct pipe_walk
+{
+  spsc_ring_t ring;
+  pthread_t   reader;
+  uint8_t     running;
+  uint8_t     holding;
+  uint8_t     done;
+  int         fd;
+  uint64_t    file_len;
+
+} pipe_walk_t;
+
+static spsc_stats_t pipe_stats;
+
 
 long try_strtol( char* str )
 {
@@ -66,115 +162,264 @@ long try_strtol( char* str )
 }
 
 
+double get_monotonic_seconds( void )
+{
+  struct timespec ts;
+
+  ( void )clock_gettime( CLOCK_MONOTONIC, &ts );
+
+  return ( double )ts.tv_sec + ( double )ts.tv_nsec / 1e9;
+}
+
+
+/* Reverses the bits inside every byte of v, the 
+ * byte order is kept. Three swap steps instead of 
+ * moving every single bit. */
+static inline uint64_t reflect_bytes_64( uint64_t v )
+{
+  v = ( ( v >> 1U ) & 0x5555555555555555UL ) | ( ( v & 0x5555555555555555UL ) << 1U );
+  v = ( ( v >> 2U ) & 0x3333333333333333UL ) | ( ( v & 0x3333333333333333UL ) << 2U );
+  v = ( ( v >> 4U ) & 0x0F0F0F0F0F0F0F0FUL ) | ( ( v & 0x0F0F0F0F0F0F0F0FUL ) << 4U );
+  return v;
+}
+
+
+static inline uint32_t reflect_bytes_32( uint32_t v )
+{
+  v = ( ( v >> 1U ) & 0x55555555U ) | ( ( v & 0x55555555U ) << 1U );
+  v = ( ( v >> 2U ) & 0x33333333U ) | ( ( v & 0x33333333U ) << 2U );
+  v = ( ( v >> 4U ) & 0x0F0F0F0FU ) | ( ( v & 0x0F0F0F0FU ) << 4U );
+  return v;
+}
+
+
+#ifdef REFLECT_SIMD_AVAILABLE
+
+/* shuffle masks which reverse the byte order inside 
+ * elements of 1, 2, 4 and 8 bytes, indexed by log2( size ) */
+static const uint8_t byte_order[ 4 ][ 16 ] =
+{
+  {  0U,  1U,  2U,  3U,  4U,  5U,  6U,  7U,  8U,  9U, 10U, 11U, 12U, 13U, 14U, 15U },
+  {  1U,  0U,  3U,  2U,  5U,  4U,  7U,  6U,  9U,  8U, 11U, 10U, 13U, 12U, 15U, 14U },
+  {  3U,  2U,  1U,  0U,  7U,  6U,  5U,  4U, 11U, 10U,  9U,  8U, 15U, 14U, 13U, 12U },
+  {  7U,  6U,  5U,  4U,  3U,  2U,  1U,  0U, 15U, 14U, 13U, 12U, 11U, 10U,  9U,  8U }
+};
+
+/* every nibble reflected, the low half is used for the 
+ * high nibble of a byte and vice versa */
+static const uint8_t nibble_lo[ 16 ] =
+{
+  0x00U, 0x80U, 0x40U, 0xC0U, 0x20U, 0xA0U, 0x60U, 0xE0U,
+  0x10U, 0x90U, 0x50U, 0xD0U, 0x30U, 0xB0U, 0x70U, 0xF0U
+};
+
+static const uint8_t nibble_hi[ 16 ] =
+{
+  0x00U, 0x08U, 0x04U, 0x0CU, 0x02U, 0x0AU, 0x06U, 0x0EU,
+  0x01U, 0x09U, 0x05U, 0x0DU, 0x03U, 0x0BU, 0x07U, 0x0FU
+};
+
+
+/* returns the number of bytes processed, 
+ * which is a multiple of 16 */
+SSSE3_TARGET
+static size_t reflect_bulk_ssse3( uint8_t* p, size_t len, uint8_t order )
+{
+  __m128i shuf, lo_tbl, hi_tbl, mask, v, lo, hi;
+  size_t i;
+
+  shuf   = _mm_loadu_si128( ( const __m128i* )byte_order[ order ] );
+  lo_tbl = _mm_loadu_si128( ( const __m128i* )nibble_lo );
+  hi_tbl = _mm_loadu_si128( ( const __m128i* )nibble_hi );
+  mask   = _mm_set1_epi8( 0x0F );
+
+  for( i = 0U; i + 16U <= len; i += 16U )
+  {
+    v  = _mm_loadu_si128( ( const __m128i* )( p + i ) );
+    v  = _mm_shuffle_epi8( v, shuf );
+    lo = _mm_and_si128( v, mask );
+    hi = _mm_and_si128( _mm_srli_epi16( v, 4 ), mask );
+    v  = _mm_or_si128( _mm_shuffle_epi8( lo_tbl, lo ),
+                       _mm_shuffle_epi8( hi_tbl, hi ) );
+    _mm_storeu_si128( ( __m128i* )( p + i ), v );
+  }
+  return i;
+}
+
+
+/* the same with 32 bytes per step, vpshufb works 
+ * per 128 bit lane so the tables are just doubled */
+AVX2_TARGET
+static size_t reflect_bulk_avx2( uint8_t* p, size_t len, uint8_t order )
+{
+  __m256i shuf, lo_tbl, hi_tbl, mask, v, lo, hi;
+  size_t i;
+
+  shuf   = _mm256_broadcastsi128_si256( 
+             _mm_loadu_si128( ( const __m128i* )byte_order[ order ] ) );
+  lo_tbl = _mm256_broadcastsi128_si256( 
+             _mm_loadu_si128( ( const __m128i* )nibble_lo ) );
+  hi_tbl = _mm256_broadcastsi128_si256( 
+             _mm_loadu_si128( ( const __m128i* )nibble_hi ) );
+  mask   = _mm256_set1_epi8( 0x0F );
+
+  for( i = 0U; i + 32U <= len; i += 32U )
+  {
+    v  = _mm256_loadu_si256( ( const __m256i* )( p + i ) );
+    v  = _mm256_shuffle_epi8( v, shuf );
+    lo = _mm256_and_si256( v, mask );
+    hi = _mm256_and_si256( _mm256_srli_epi16( v, 4 ), mask );
+    v  = _mm256_or_si256( _mm256_shuffle_epi8( lo_tbl, lo ),
+                          _mm256_shuffle_epi8( hi_tbl, hi ) );
+    _mm256_storeu_si256( ( __m256i* )( p + i ), v );
+  }
+  return i;
+}
+
+#endif /* REFLECT_SIMD_AVAILABLE */
+
+
+static uint8_t reflect_simd_level( void )
+{
+  static uint8_t level = REFLECT_SIMD_UNKNOWN;
+
+  if( level == REFLECT_SIMD_UNKNOWN )
+  {
+    level = REFLECT_SIMD_NONE;
+#ifdef REFLECT_SIMD_AVAILABLE
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx2" ) )
+    {
+      level = REFLECT_SIMD_AVX2;
+    }
+    else if( __builtin_cpu_supports( "ssse3" ) )
+    {
+      level = REFLECT_SIMD_SSSE3;
+    }
+#endif
+  }
+  return level;
+}
+
+
+/* Reflects as many whole vectors as possible, the 
+ * remaining bytes are left for the scalar code. */
+static size_t reflect_bulk( uint8_t* p, size_t len, uint8_t order )
+{
+#ifdef REFLECT_SIMD_AVAILABLE
+  switch( reflect_simd_level() )
+  {
+    case REFLECT_SIMD_AVX2:
+      return reflect_bulk_avx2( p, len, order );
+    case REFLECT_SIMD_SSSE3:
+      return reflect_bulk_ssse3( p, len, order );
+  }
+#else
+  ( void )p;
+  ( void )len;
+  ( void )order;
+#endif
+  return 0U;
+}
+
+
+const char* get_reflect_simd_name( void )
+{
+  switch( reflect_simd_level() )
+  {
+    case REFLECT_SIMD_AVX2:
+      return "avx2";
+    case REFLECT_SIMD_SSSE3:
+      return "ssse3";
+  }
+  return "scalar";
+}
+
+
 inline void reflect_bits_8( uint8_t* field, uint32_t n )
 {
-  uint32_t i;
-  uint8_t b;
+  size_t i;
+  uint64_t qw;
+  uint32_t w;
+
+  i = 0U;
+
+  /* single bytes, e.g. parameters, go straight to the tail loop */
+  if( n >= 16U )
+  {
+    i = reflect_bulk( field, ( size_t )n, 0U );
+
+    for( ; i + 8U <= n; i += 8U )
+    {
+      ( void )memcpy( ( void* )&qw, ( const void* )( field + i ), sizeof( uint64_t ) );
+      qw = reflect_bytes_64( qw );
+      ( void )memcpy( ( void* )( field + i ), ( const void* )&qw, sizeof( uint64_t ) );
+    }
+  }
 
-  for( i = 0; i < n; i++ )
+  for( ; i < n; i++ )
   {
-    b = *( field + i );
-    b = ( ( b & 0x80U ) >> 7U ) | ( ( b & 0x01U ) << 7U ) |
-        ( ( b & 0x40U ) >> 5U ) | ( ( b & 0x02U ) << 5U ) |
-        ( ( b & 0x20U ) >> 3U ) | ( ( b & 0x04U ) << 3U ) |
-        ( ( b & 0x10U ) >> 1U ) | ( ( b & 0x08U ) << 1U ) ;
-    *( field + i ) = b;
+    w = reflect_bytes_32( ( uint32_t )*( field + i ) );
+    *( field + i ) = ( uint8_t )w;
   }
 }
 
 
 inline void reflect_bits_16( uint16_t* field, uint32_t n )
 {
-  uint32_t i;
-  uint16_t db;
+  size_t i;
+
+  i = reflect_bulk( ( uint8_t* )field, 2U * ( size_t )n, 1U ) / 2U;
 
-  for( i = 0; i < n; i++ )
+  for( ; i < n; i++ )
   {
-    db = *( field + i );
-    db = ( ( db & 0x8000U ) >> 15U ) | ( ( db & 0x0001U ) << 15U ) |
-         ( ( db & 0x4000U ) >> 13U ) | ( ( db & 0x0002U ) << 13U ) |
-         ( ( db & 0x2000U ) >> 11U ) | ( ( db & 0x0004U ) << 11U ) |
-         ( ( db & 0x1000U ) >>  9U ) | ( ( db & 0x0008U ) <<  9U ) |
-         ( ( db & 0x0800U ) >>  7U ) | ( ( db & 0x0010U ) <<  7U ) |
-         ( ( db & 0x0400U ) >>  5U ) | ( ( db & 0x0020U ) <<  5U ) |
-         ( ( db & 0x0200U ) >>  3U ) | ( ( db & 0x0040U ) <<  3U ) |
-         ( ( db & 0x0100U ) >>  1U ) | ( ( db & 0x0080U ) <<  1U ) ;
-    *( field + i ) = db;
+    *( field + i ) = ( uint16_t )reflect_bytes_32( 
+                       ( uint32_t )__builtin_bswap16( *( field + i ) ) );
   }
 }
 
 
 inline void reflect_bits_32( uint32_t* field, uint32_t n )
 {
-  uint32_t i;
-  uint32_t w;
+  size_t i;
+
+  i = reflect_bulk( ( uint8_t* )field, 4U * ( size_t )n, 2U ) / 4U;
 
-  for( i = 0; i < n; i++ )
-  {
-    w = *( field + i );
-    w = ( ( w & 0x80000000U ) >> 31U ) | ( ( w & 0x00000001U ) << 31U ) |
-        ( ( w & 0x40000000U ) >> 29U ) | ( ( w & 0x00000002U ) << 29U ) |
-        ( ( w & 0x20000000U ) >> 27U ) | ( ( w & 0x00000004U ) << 27U ) |
-        ( ( w & 0x10000000U ) >> 25U ) | ( ( w & 0x00000008U ) << 25U ) |
-        ( ( w & 0x08000000U ) >> 23U ) | ( ( w & 0x00000010U ) << 23U ) |
-        ( ( w & 0x04000000U ) >> 21U ) | ( ( w & 0x00000020U ) << 21U ) |
-        ( ( w & 0x02000000U ) >> 19U ) | ( ( w & 0x00000040U ) << 19U ) |
-        ( ( w & 0x01000000U ) >> 17U ) | ( ( w & 0x00000080U ) << 17U ) |
-        ( ( w & 0x00800000U ) >> 15U ) | ( ( w & 0x00000100U ) << 15U ) |
-        ( ( w & 0x00400000U ) >> 13U ) | ( ( w & 0x00000200U ) << 13U ) |
-        ( ( w & 0x00200000U ) >> 11U ) | ( ( w & 0x00000400U ) << 11U ) |
-        ( ( w & 0x00100000U ) >>  9U ) | ( ( w & 0x00000800U ) <<  9U ) |
-        ( ( w & 0x00080000U ) >>  7U ) | ( ( w & 0x00001000U ) <<  7U ) |
-        ( ( w & 0x00040000U ) >>  5U ) | ( ( w & 0x00002000U ) <<  5U ) |
-        ( ( w & 0x00020000U ) >>  3U ) | ( ( w & 0x00004000U ) <<  3U ) |
-        ( ( w & 0x00010000U ) >>  1U ) | ( ( w & 0x00008000U ) <<  1U ) ;
-    *( field + i ) = w;
+  for( ; i < n; i++ )
+  {
+    *( field + i ) = reflect_bytes_32( __builtin_bswap32( *( field + i ) ) );
   }
 }
 
 
 inline void reflect_bits_64( uint64_t* field, uint32_t n )
 {
-  uint32_t i;
-  uint64_t dw;
-
-  for( i = 0; i < n; i++ )
-  {
-    dw = *( field + i );
-    dw = ( ( dw & 0x8000000000000000UL ) >> 63U ) | ( ( dw & 0x0000000000000001UL ) << 63U ) |
-         ( ( dw & 0x4000000000000000UL ) >> 61U ) | ( ( dw & 0x0000000000000002UL ) << 61U ) |
-         ( ( dw & 0x2000000000000000UL ) >> 59U ) | ( ( dw & 0x0000000000000004UL ) << 59U ) |
-         ( ( dw & 0x1000000000000000UL ) >> 57U ) | ( ( dw & 0x0000000000000008UL ) << 57U ) |
-         ( ( dw & 0x0800000000000000UL ) >> 55U ) | ( ( dw & 0x0000000000000010UL ) << 55U ) |
-         ( ( dw & 0x0400000000000000UL ) >> 53U ) | ( ( dw & 0x0000000000000020UL ) << 53U ) |
-         ( ( dw & 0x0200000000000000UL ) >> 51U ) | ( ( dw & 0x0000000000000040UL ) << 51U ) |
-         ( ( dw & 0x0100000000000000UL ) >> 49U ) | ( ( dw & 0x0000000000000080UL ) << 49U ) |
-         ( ( dw & 0x0080000000000000UL ) >> 47U ) | ( ( dw & 0x0000000000000100UL ) << 47U ) |
-         ( ( dw & 0x0040000000000000UL ) >> 45U ) | ( ( dw & 0x0000000000000200UL ) << 45U ) |
-         ( ( dw & 0x0020000000000000UL ) >> 43U ) | ( ( dw & 0x0000000000000400UL ) << 43U ) |
-         ( ( dw & 0x0010000000000000UL ) >> 41U ) | ( ( dw & 0x0000000000000800UL ) << 41U ) |
-         ( ( dw & 0x0008000000000000UL ) >> 39U ) | ( ( dw & 0x0000000000001000UL ) << 39U ) |
-         ( ( dw & 0x0004000000000000UL ) >> 37U ) | ( ( dw & 0x0000000000002000UL ) << 37U ) |
-         ( ( dw & 0x0002000000000000UL ) >> 35U ) | ( ( dw & 0x0000000000004000UL ) << 35U ) |
-         ( ( dw & 0x0001000000000000UL ) >> 33U ) | ( ( dw & 0x0000000000008000UL ) << 33U ) |
-         ( ( dw & 0x0000800000000000UL ) >> 31U ) | ( ( dw & 0x0000000000010000UL ) << 31U ) |
-         ( ( dw & 0x0000400000000000UL ) >> 29U ) | ( ( dw & 0x0000000000020000UL ) << 29U ) |
-         ( ( dw & 0x0000200000000000UL ) >> 27U ) | ( ( dw & 0x0000000000040000UL ) << 27U ) |
-         ( ( dw & 0x0000100000000000UL ) >> 25U ) | ( ( dw & 0x0000000000080000UL ) << 25U ) |
-         ( ( dw & 0x0000080000000000UL ) >> 23U ) | ( ( dw & 0x0000000000100000UL ) << 23U ) |
-         ( ( dw & 0x0000040000000000UL ) >> 21U ) | ( ( dw & 0x0000000000200000UL ) << 21U ) |
-         ( ( dw & 0x0000020000000000UL ) >> 19U ) | ( ( dw & 0x0000000000400000UL ) << 19U ) |
-         ( ( dw & 0x0000010000000000UL ) >> 17U ) | ( ( dw & 0x0000000000800000UL ) << 17U ) |
-         ( ( dw & 0x0000008000000000UL ) >> 15U ) | ( ( dw & 0x0000000001000000UL ) << 15U ) |
-         ( ( dw & 0x0000004000000000UL ) >> 13U ) | ( ( dw & 0x0000000002000000UL ) << 13U ) |
-         ( ( dw & 0x0000002000000000UL ) >> 11U ) | ( ( dw & 0x0000000004000000UL ) << 11U ) |
-         ( ( dw & 0x0000001000000000UL ) >>  9U ) | ( ( dw & 0x0000000008000000UL ) <<  9U ) |
-         ( ( dw & 0x0000000800000000UL ) >>  7U ) | ( ( dw & 0x0000000010000000UL ) <<  7U ) |
-         ( ( dw & 0x0000000400000000UL ) >>  5U ) | ( ( dw & 0x0000000020000000UL ) <<  5U ) |
-         ( ( dw & 0x0000000200000000UL ) >>  3U ) | ( ( dw & 0x0000000040000000UL ) <<  3U ) |
-         ( ( dw & 0x0000000100000000UL ) >>  1U ) | ( ( dw & 0x0000000080000000UL ) <<  1U ) ;
-    *( field + i ) = dw;
+  size_t i;
+
+  i = reflect_bulk( ( uint8_t* )field, 8U * ( size_t )n, 3U ) / 8U;
+
+  for( ; i < n; i++ )
+  {
+    *( field + i ) = reflect_bytes_64( __builtin_bswap64( *( field + i ) ) );
+  }
+}
+
+
+uint64_t get_param_value( const data_u* field, uint8_t degree )
+{
+  if( degree <= 8U )
+  {
+    return ( uint64_t )field->u_8;
   }
+  else if( degree <= 16U )
+  {
+    return ( uint64_t )field->u_16;
+  }
+  else if( degree <= 32U )
+  {
+    return ( uint64_t )field->u_32;
+  }
+  return field->u_64;
 }
 
 
@@ -194,10 +439,16 @@ int32_t walk_file( uint8_t** buf, ssize_t buf_len,
   static uint8_t reset = 0x00;
   static int fd = ( -1 );
 
+  static uint64_t file_size_byte = 0;
+  static uint64_t file_pos = 0;
+
+  static uint8_t  small_buf[ SMALL_FILE_SIZE ];
+  static uint8_t* pool = NULL;
+  static size_t   pool_len = 0U;
+
   struct stat file_stat;
-  uint64_t file_size_byte = 0;
   int32_t bytes_read = ( -1 );
-  off_t cur_file_pos;
+  double stage_start;
  
   /* the function parameters are only stored
    * the first time this function gets called. */
@@ -210,11 +461,17 @@ int32_t walk_file( uint8_t** buf, ssize_t buf_len,
     first_call = 0xFF;
     reset = 0x00;
 
-    free( *buf_local );
+    if( ( *buf_local != small_buf ) && ( *buf_local != pool ) )
+    {
+      free( *buf_local );
+    }
     *buf_local = NULL;
 
     buf_len_local = 0;
     file_local = NULL;
+
+    file_size_byte = 0;
+    file_pos = 0;
     
     bytes_read = 0;
     return bytes_read;
@@ -223,51 +480,972 @@ int32_t walk_file( uint8_t** buf, ssize_t buf_len,
   if( first_call )
   {
     first_call = 0x00;
+    stage_start = crc_stats_begin();
     
     buf_local = buf;
     buf_len_local = buf_len;
     file_local = file;
 
-    if( !( *buf_local = ( uint8_t* )malloc( buf_len_local * sizeof( uint8_t ) ) ) )
-    {
-      ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
-      exit( EXIT_FAILURE );
-    }
-
     if( ( fd = open( file_local, O_RDONLY ) ) == ( -1 ) )
     {
       ( void )fprintf( stderr, "%s\n", strerror( errno ) );
-      free( *buf_local );
       exit( EXIT_FAILURE );
     }
 
-    if( stat( file_local, &file_stat ) )
+    if( fstat( fd, &file_stat ) )
     {
       ( void )fprintf( stderr, "%s\n", strerror( errno ) );
-      free( *buf_local );
+      ( void )close( fd );
       exit( EXIT_FAILURE );
     }
     file_size_byte = file_stat.st_size;
     ( void )fprintf( stdout, "\nThe input file has a size of %ld bytes.\n", 
                              file_size_byte );
+
+    /* no chunk larger than the file */
+    if( S_ISREG( file_stat.st_mode ) && ( file_size_byte < ( uint64_t )buf_len_local ) )
+    {
+      buf_len_local = file_size_byte ? ( ssize_t )file_size_byte : 1;
+    }
+
+    if( buf_len_local <= ( ssize_t )SMALL_FILE_SIZE )
+    {
+      *buf_local = small_buf;
+    }
+    else if( buf_len_local <= ( ssize_t )POOL_BUF_SIZE )
+    {
+      if( pool_len < ( size_t )buf_len_local )
+      {
+        free( pool );
+        pool_len = 0U;
+        if( !( pool = ( uint8_t* )malloc( ( size_t )buf_len_local ) ) )
+        {
+          ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+          ( void )close( fd );
+          exit( EXIT_FAILURE );
+        }
+        pool_len = ( size_t )buf_len_local;
+      }
+      *buf_local = pool;
+    }
+    else if( !( *buf_local = ( uint8_t* )malloc( ( size_t )buf_len_local ) ) )
+    {
+      ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+      ( void )close( fd );
+      exit( EXIT_FAILURE );
+    }
+    crc_stats_end( CRC_STAGE_OPEN, stage_start, 0UL );
   }
 
+  stage_start = crc_stats_begin();
   bytes_read = ( int32_t )read( fd, ( void* )( *buf_local ), buf_len_local );
+  crc_stats_end( CRC_STAGE_READ, stage_start, ( bytes_read > 0 ) ? ( uint64_t )bytes_read : 0UL );
 
-  cur_file_pos = lseek( fd, 0, SEEK_CUR );
-  if( cur_file_pos == lseek( fd, 0, SEEK_END ) )
+  if( bytes_read <= 0 )
   {
-    /* we are at the end of the file and can free resources */
+    /* empty file or read error, nothing is handed out 
+     * so clean up right away instead of the next call */
     ( void )close( fd );
     fd = ( -1 );
     reset = 0xFFU;
     *more_fragments = 0x00U;
+    return walk_file( buf, buf_len, file, more_fragments );
   }
-  else
+
+  file_pos += ( uint64_t )bytes_read;
+
+  /* the size is known from stat, no need to seek around */
+  if( file_pos >= file_size_byte )
   {
-    ( void )lseek( fd, cur_file_pos, SEEK_SET );
+    /* we are at the end of the file and can free resources */
+    ( void )close( fd );
+    fd = ( -1 );
+    reset = 0xFFU;
+    *more_fragments = 0x00U;
   }
 
   return bytes_read;
 }
 
+
+int32_t walk_file_mmap( const uint8_t** buf, ssize_t chunk_len, 
+                        const char* file, uint8_t* more_fragments )
+{
+  static uint8_t* map = NULL;
+  static uint64_t map_len = 0UL;
+  static uint64_t map_pos = 0UL;
+
+  struct stat file_stat;
+  int32_t chunk = 0;
+  int fd = ( -1 );
+  double stage_start;
+
+  if( map && ( map_pos >= map_len ) )
+  {
+    /* the caller is done with the last chunk */
+    ( void )munmap( ( void* )map, map_len );
+    map = NULL;
+    map_len = 0UL;
+    map_pos = 0UL;
+    return 0;
+  }
+
+  if( !map )
+  {
+    stage_start = crc_stats_begin();
+
+    if( ( fd = open( file, O_RDONLY ) ) == ( -1 ) )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      exit( EXIT_FAILURE );
+    }
+
+    if( fstat( fd, &file_stat ) )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      ( void )close( fd );
+      exit( EXIT_FAILURE );
+    }
+    ( void )fprintf( stdout, "\nThe input file has a size of %ld bytes.\n", 
+                             file_stat.st_size );
+
+    if( file_stat.st_size <= 0 )
+    {
+      /* nothing to map */
+      ( void )close( fd );
+      *more_fragments = 0x00U;
+      return 0;
+    }
+
+    map_len = ( uint64_t )file_stat.st_size;
+    map = ( uint8_t* )mmap( NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0 );
+    /* the mapping stays valid without the descriptor */
+    ( void )close( fd );
+
+    if( map == ( uint8_t* )MAP_FAILED )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      map = NULL;
+      exit( EXIT_FAILURE );
+    }
+
+    /* read ahead aggressively and drop pages behind */
+    ( void )madvise( ( void* )map, map_len, MADV_SEQUENTIAL );
+    ( void )madvise( ( void* )map, map_len, MADV_WILLNEED );
+
+    /* the pages fault in while the crc runs */
+    crc_stats_end( CRC_STAGE_OPEN, stage_start, 0UL );
+  }
+
+  chunk = ( map_len - map_pos > ( uint64_t )chunk_len ) ? 
+          ( int32_t )chunk_len : ( int32_t )( map_len - map_pos );
+
+  *buf = map + map_pos;
+  map_pos += ( uint64_t )chunk;
+
+  if( map_pos >= map_len )
+  {
+    *more_fragments = 0x00U;
+  }
+
+  return chunk;
+}
+
+
+
+/* Hands slot s the chunk at submit_pos. With the ring the read
+ * is only queued, without it the chunk is read right away. */
+static void uring_walk_queue( uring_walk_t* w, uint32_t s )
+{
+  struct io_uring_sqe* sqe;
+  uint64_t left;
+  ssize_t r;
+
+  left = w->file_len - w->submit_pos;
+
+  w->offset[ s ] = w->submit_pos;
+  w->len[ s ]    = ( left > w->chunk_len ) ? w->chunk_len : left;
+  w->result[ s ] = 0;
+  w->done[ s ]   = 0x00U;
+
+  w->submit_pos += w->len[ s ];
+
+  if( w->use_ring && ( sqe = uring_get_sqe( &w->ring ) ) )
+  {
+    sqe->opcode    = w->fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe->fd        = w->fd;
+    sqe->addr      = ( uint64_t )( uintptr_t )( w->arena + s * w->chunk_len );
+    sqe->len       = ( uint32_t )w->len[ s ];
+    sqe->off       = w->offset[ s ];
+    sqe->buf_index = ( uint16_t )s;
+    sqe->user_data = ( uint64_t )s;
+    return;
+  }
+
+  do
+  {
+    r = pread( w->fd, ( void* )( w->arena + s * w->chunk_len ), 
+               ( size_t )w->len[ s ], ( off_t )w->offset[ s ] );
+  } while( ( r < 0 ) && ( errno == EINTR ) );
+
+  w->result[ s ] = ( r < 0 ) ? -errno : ( int32_t )r;
+  w->done[ s ]   = 0xFFU;
+}
+
+
+/* Waits until slot s is read completely. Short reads
+ * (signals, page cache pressure) are completed with pread. */
+static void uring_walk_wait( uring_walk_t* w, uint32_t s )
+{
+  struct io_uring_cqe* cqe;
+  uint8_t* dst;
+  ssize_t r;
+  int ret;
+
+  while( !w->done[ s ] || w->ring.pending )
+  {
+    ret = uring_submit( &w->ring, w->done[ s ] ? 0U : 1U );
+    if( ret < 0 )
+    {
+      ( void )fprintf( stderr, "io_uring_enter: %s\n", strerror( -ret ) );
+      exit( EXIT_FAILURE );
+    }
+
+    while( ( cqe = uring_peek_cqe( &w->ring ) ) )
+    {
+      w->result[ cqe->user_data ] = cqe->res;
+      w->done[ cqe->user_data ]   = 0xFFU;
+      uring_cqe_seen( &w->ring );
+    }
+  }
+
+  if( w->result[ s ] < 0 )
+  {
+    ( void )fprintf( stderr, "%s\n", strerror( -w->result[ s ] ) );
+    exit( EXIT_FAILURE );
+  }
+
+  dst = w->arena + s * w->chunk_len;
+
+  while( ( uint64_t )w->result[ s ] < w->len[ s ] )
+  {
+    r = pread( w->fd, ( void* )( dst + w->result[ s ] ), 
+               ( size_t )( w->len[ s ] - ( uint64_t )w->result[ s ] ),
+               ( off_t )( w->offset[ s ] + ( uint64_t )w->result[ s ] ) );
+    if( ( r < 0 ) && ( errno == EINTR ) )
+    {
+      continue;
+    }
+    if( r < 0 )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      exit( EXIT_FAILURE );
+    }
+    if( !r )
+    {
+      /* the file shrank since the stat */
+      break;
+    }
+    w->result[ s ] += ( int32_t )r;
+  }
+}
+
+
+static void uring_walk_cleanup( uring_walk_t* w )
+{
+  if( w->use_ring )
+  {
+    uring_exit( &w->ring );
+  }
+  if( w->fd >= 0 )
+  {
+    ( void )close( w->fd );
+  }
+  free( ( void* )w->arena );
+  ( void )memset( ( void* )w, 0, sizeof( uring_walk_t ) );
+  w->fd = ( -1 );
+}
+
+
+int32_t walk_file_uring( const uint8_t** buf, ssize_t chunk_len, 
+                         uint32_t queue_depth, const char* file, 
+                         uint8_t* more_fragments )
+{
+  static uring_walk_t w = { 0 };
+
+  struct iovec iov[ URING_MAX_QUEUE_DEPTH ];
+  struct stat file_stat;
+  uint32_t s;
+  void* arena = NULL;
+  double stage_start;
+
+  if( w.arena && w.holding )
+  {
+    /* the caller is done with the last chunk, its 
+     * slot takes the next read which is not in flight */
+    w.holding = 0x00U;
+    s = w.deliver_slot;
+    w.deliver_slot = ( s + 1U ) % w.depth;
+
+    if( w.submit_pos < w.file_len )
+    {
+      uring_walk_queue( &w, s );
+    }
+  }
+
+  if( w.arena && ( w.deliver_pos >= w.file_len ) )
+  {
+    uring_walk_cleanup( &w );
+    return 0;
+  }
+
+  if( !w.arena )
+  {
+    stage_start = crc_stats_begin();
+
+    if( ( queue_depth < 1U ) || ( queue_depth > URING_MAX_QUEUE_DEPTH ) ||
+        ( chunk_len <= 0 ) || ( chunk_len > INT32_MAX ) )
+    {
+      ( void )fprintf( stderr, "Invalid io_uring queue depth or chunk length.\n" );
+      exit( EXIT_FAILURE );
+    }
+
+    w.fd = ( -1 );
+    if( ( w.fd = open( file, O_RDONLY ) ) == ( -1 ) )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      exit( EXIT_FAILURE );
+    }
+
+    if( fstat( w.fd, &file_stat ) )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      ( void )close( w.fd );
+      exit( EXIT_FAILURE );
+    }
+    ( void )fprintf( stdout, "\nThe input file has a size of %ld bytes.\n", 
+                             file_stat.st_size );
+
+    if( file_stat.st_size <= 0 )
+    {
+      ( void )close( w.fd );
+      w.fd = ( -1 );
+      *more_fragments = 0x00U;
+      return 0;
+    }
+
+    w.file_len  = ( uint64_t )file_stat.st_size;
+    w.chunk_len = ( uint64_t )chunk_len;
+
+    /* no more slots than chunks */
+    w.depth = ( uint32_t )( ( w.file_len + w.chunk_len - 1UL ) / w.chunk_len );
+    if( w.depth > queue_depth )
+    {
+      w.depth = queue_depth;
+    }
+
+    /* page aligned, the buffers get pinned when registered */
+    if( posix_memalign( &arena, URING_ALIGN, ( size_t )( w.depth * w.chunk_len ) ) )
+    {
+      ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+      ( void )close( w.fd );
+      exit( EXIT_FAILURE );
+    }
+    w.arena = ( uint8_t* )arena;
+
+    if( ( w.use_ring = uring_init( &w.ring, w.depth ) ) )
+    {
+      for( s = 0U; s < w.depth; s++ )
+      {
+        iov[ s ].iov_base = ( void* )( w.arena + s * w.chunk_len );
+        iov[ s ].iov_len  = ( size_t )w.chunk_len;
+      }
+      /* without registered buffers (memlock limit) plain reads do */
+      w.fixed = uring_register_buffers( &w.ring, iov, w.depth );
+    }
+    else
+    {
+      ( void )fprintf( stdout, "io_uring is not available, using pread.\n" );
+    }
+
+    ( void )posix_fadvise( w.fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+    for( s = 0U; ( s < w.depth ) && ( w.submit_pos < w.file_len ); s++ )
+    {
+      uring_walk_queue( &w, s );
+    }
+    crc_stats_end( CRC_STAGE_OPEN, stage_start, 0UL );
+  }
+
+  s = w.deliver_slot;
+  stage_start = crc_stats_begin();
+  uring_walk_wait( &w, s );
+  crc_stats_end( CRC_STAGE_READ, stage_start, 
+                 ( w.result[ s ] > 0 ) ? ( uint64_t )w.result[ s ] : 0UL );
+
+  if( !w.result[ s ] )
+  {
+    /* truncated while reading, nothing left to hand out */
+    uring_walk_cleanup( &w );
+    *more_fragments = 0x00U;
+    return 0;
+  }
+
+  *buf = w.arena + s * w.chunk_len;
+  w.deliver_pos += w.len[ s ];
+  w.holding = 0xFFU;
+
+  if( w.deliver_pos >= w.file_len )
+  {
+    *more_fragments = 0x00U;
+  }
+
+  return w.result[ s ];
+}
+
+
+/* Producer of walk_file_pipe, reads the file front to back 
+ * into the ring. A read error ends the file with -errno. */
+static void* pipe_reader( void* arg )
+{
+  pipe_walk_t* w = ( pipe_walk_t* )arg;
+  uint64_t pos = 0UL;
+  uint64_t want;
+  uint8_t* dst;
+  ssize_t r;
+  int64_t got;
+
+  do
+  {
+    dst  = spsc_produce_begin( &w->ring );
+    want = w->file_len - pos;
+    if( want > w->ring.slot_size )
+    {
+      want = w->ring.slot_size;
+    }
+
+    got = 0;
+    while( ( uint64_t )got < want )
+    {
+      r = pread( w->fd, ( void* )( dst + got ), ( size_t )( want - ( uint64_t )got ),
+                 ( off_t )( pos + ( uint64_t )got ) );
+      if( ( r < 0 ) && ( errno == EINTR ) )
+      {
+        continue;
+      }
+      if( r <= 0 )
+      {
+        /* error or the file shrank since the stat */
+        if( r < 0 )
+        {
+          got = -errno;
+        }
+        want = 0UL;
+        break;
+      }
+      got += ( int64_t )r;
+    }
+
+    if( got <= 0 )
+    {
+      spsc_produce_commit( &w->ring, got, 0xFFU );
+      break;
+    }
+
+    pos += ( uint64_t )got;
+    spsc_produce_commit( &w->ring, got, ( pos >= w->file_len ) ? 0xFFU : 0x00U );
+
+  } while( pos < w->file_len );
+
+  return NULL;
+}
+
+
+static void pipe_walk_cleanup( pipe_walk_t* w )
+{
+  if( w->running )
+  {
+    ( void )pthread_join( w->reader, NULL );
+  }
+  pipe_stats = w->ring.stats;
+  spsc_free( &w->ring );
+  if( w->fd >= 0 )
+  {
+    ( void )close( w->fd );
+  }
+  ( void )memset( ( void* )w, 0, sizeof( pipe_walk_t ) );
+  w->fd = ( -1 );
+}
+
+
+int32_t walk_file_pipe( const uint8_t** buf, ssize_t chunk_len, 
+                        uint32_t depth, const char* file, 
+                        uint8_t* more_fragments )
+{
+  static pipe_walk_t w = { 0 };
+
+  struct stat file_stat;
+  int64_t len;
+  uint8_t last;
+  double stage_start;
+
+  if( w.running && w.holding )
+  {
+    /* the caller is done with the last chunk */
+    w.holding = 0x00U;
+    spsc_consume_release( &w.ring );
+  }
+
+  if( w.running && w.done )
+  {
+    pipe_walk_cleanup( &w );
+    return 0;
+  }
+
+  if( !w.running )
+  {
+    stage_start = crc_stats_begin();
+
+    if( ( depth < 1U ) || ( depth > PIPE_MAX_DEPTH ) ||
+        ( chunk_len <= 0 ) || ( chunk_len > INT32_MAX ) )
+    {
+      ( void )fprintf( stderr, "Invalid pipeline depth or chunk length.\n" );
+      exit( EXIT_FAILURE );
+    }
+
+    ( void )memset( ( void* )&pipe_stats, 0, sizeof( spsc_stats_t ) );
+
+    if( ( w.fd = open( file, O_RDONLY ) ) == ( -1 ) )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      exit( EXIT_FAILURE );
+    }
+
+    if( fstat( w.fd, &file_stat ) )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      ( void )close( w.fd );
+      exit( EXIT_FAILURE );
+    }
+    ( void )fprintf( stdout, "\nThe input file has a size of %ld bytes.\n", 
+                             file_stat.st_size );
+
+    if( file_stat.st_size <= 0 )
+    {
+      ( void )close( w.fd );
+      w.fd = ( -1 );
+      *more_fragments = 0x00U;
+      return 0;
+    }
+    w.file_len = ( uint64_t )file_stat.st_size;
+
+    if( !spsc_init( &w.ring, depth, ( size_t )chunk_len ) )
+    {
+      ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+      ( void )close( w.fd );
+      exit( EXIT_FAILURE );
+    }
+
+    ( void )posix_fadvise( w.fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+    if( pthread_create( &w.reader, NULL, &pipe_reader, ( void* )&w ) )
+    {
+      ( void )fprintf( stderr, "Failed to start the reader thread.\n" );
+      ( void )close( w.fd );
+      spsc_free( &w.ring );
+      exit( EXIT_FAILURE );
+    }
+    w.running = 0xFFU;
+    crc_stats_end( CRC_STAGE_OPEN, stage_start, 0UL );
+  }
+
+  /* the reader thread reads, this is the wait for it */
+  stage_start = crc_stats_begin();
+  *buf = spsc_consume_begin( &w.ring, &len, &last );
+  crc_stats_end( CRC_STAGE_READ, stage_start, ( len > 0 ) ? ( uint64_t )len : 0UL );
+
+  if( len < 0 )
+  {
+    ( void )fprintf( stderr, "%s\n", strerror( ( int )-len ) );
+    exit( EXIT_FAILURE );
+  }
+
+  if( last )
+  {
+    w.done = 0xFFU;
+    *more_fragments = 0x00U;
+  }
+
+  if( !len )
+  {
+    /* truncated while reading, nothing left to hand out */
+    spsc_consume_release( &w.ring );
+    pipe_walk_cleanup( &w );
+    return 0;
+  }
+
+  w.holding = 0xFFU;
+
+  return ( int32_t )len;
+}
+
+
+void get_walk_file_pipe_stats( spsc_stats_t* stats )
+{
+  *stats = pipe_stats;
+}
+
+
+int32_t walk_file_direct( const uint8_t** buf, ssize_t chunk_len, 
+                          uint8_t direct, const char* file, 
+                          uint8_t* more_fragments )
+{
+  static uint8_t* aligned = NULL;
+  static uint64_t aligned_len = 0UL;
+  static uint64_t file_len = 0UL;
+  static uint64_t file_pos = 0UL;
+  static uint64_t chunk_pos = 0UL;
+  static uint8_t  o_direct = 0x00U;
+  static int fd = ( -1 );
+
+  struct stat file_stat;
+  void* mem = NULL;
+  uint64_t want, request;
+  int64_t got = 0;
+  ssize_t r;
+  double stage_start;
+
+  if( aligned && ( chunk_pos < file_pos ) && !o_direct )
+  {
+    /* the caller is done with the last chunk, drop its pages */
+    ( void )posix_fadvise( fd, ( off_t )chunk_pos, ( off_t )( file_pos - chunk_pos ), 
+                           POSIX_FADV_DONTNEED );
+  }
+  chunk_pos = file_pos;
+
+  if( aligned && ( file_pos >= file_len ) )
+  {
+    ( void )close( fd );
+    free( ( void* )aligned );
+    aligned = NULL;
+    aligned_len = 0UL;
+    file_len = 0UL;
+    file_pos = 0UL;
+    chunk_pos = 0UL;
+    fd = ( -1 );
+    return 0;
+  }
+
+  if( !aligned )
+  {
+    stage_start = crc_stats_begin();
+    o_direct = direct ? 0xFFU : 0x00U;
+
+    fd = open( file, O_RDONLY | ( o_direct ? O_DIRECT : 0 ) );
+    if( ( fd == ( -1 ) ) && o_direct && ( errno == EINVAL ) )
+    {
+      ( void )fprintf( stdout, "O_DIRECT is not supported by the file system, "
+                               "dropping the pages behind instead.\n" );
+      o_direct = 0x00U;
+      fd = open( file, O_RDONLY );
+    }
+    if( fd == ( -1 ) )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      exit( EXIT_FAILURE );
+    }
+
+    if( fstat( fd, &file_stat ) )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      ( void )close( fd );
+      exit( EXIT_FAILURE );
+    }
+    ( void )fprintf( stdout, "\nThe input file has a size of %ld bytes.\n", 
+                             file_stat.st_size );
+
+    if( file_stat.st_size <= 0 )
+    {
+      ( void )close( fd );
+      fd = ( -1 );
+      *more_fragments = 0x00U;
+      return 0;
+    }
+    file_len = ( uint64_t )file_stat.st_size;
+
+    if( ( chunk_len <= 0 ) || ( chunk_len > INT32_MAX ) )
+    {
+      ( void )fprintf( stderr, "Invalid chunk length.\n" );
+      ( void )close( fd );
+      exit( EXIT_FAILURE );
+    }
+
+    /* whole blocks, so every read but the last starts aligned */
+    aligned_len = ( ( uint64_t )chunk_len + DIRECT_ALIGN - 1UL ) & ~( DIRECT_ALIGN - 1UL );
+    if( aligned_len > ( uint64_t )INT32_MAX )
+    {
+      aligned_len -= DIRECT_ALIGN;
+    }
+
+    if( posix_memalign( &mem, DIRECT_ALIGN, ( size_t )aligned_len ) )
+    {
+      ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+      ( void )close( fd );
+      exit( EXIT_FAILURE );
+    }
+    aligned = ( uint8_t* )mem;
+
+    if( !o_direct )
+    {
+      ( void )posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+    }
+    crc_stats_end( CRC_STAGE_OPEN, stage_start, 0UL );
+  }
+
+  want = file_len - file_pos;
+  if( want > aligned_len )
+  {
+    want = aligned_len;
+  }
+
+  stage_start = crc_stats_begin();
+
+  while( ( uint64_t )got < want )
+  {
+    /* O_DIRECT reads whole blocks, the tail of the file included */
+    request = want - ( uint64_t )got;
+    if( o_direct )
+    {
+      request = ( request + DIRECT_ALIGN - 1UL ) & ~( DIRECT_ALIGN - 1UL );
+    }
+
+    r = pread( fd, ( void* )( aligned + got ), ( size_t )request, 
+               ( off_t )( file_pos + ( uint64_t )got ) );
+    if( ( r < 0 ) && ( errno == EINTR ) )
+    {
+      continue;
+    }
+    if( r < 0 )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      exit( EXIT_FAILURE );
+    }
+    if( !r )
+    {
+      /* the file shrank since the stat */
+      file_len = file_pos + ( uint64_t )got;
+      break;
+    }
+    got += ( int64_t )r;
+  }
+
+  if( ( uint64_t )got > want )
+  {
+    /* the file grew since the stat */
+    got = ( int64_t )want;
+  }
+  crc_stats_end( CRC_STAGE_READ, stage_start, ( uint64_t )got );
+
+  *buf = aligned;
+  file_pos += ( uint64_t )got;
+
+  if( file_pos >= file_len )
+  {
+    *more_fragments = 0x00U;
+  }
+
+  return ( int32_t )got;
+}
+
+
+double get_file_cache_residency( const char* file )
+{
+  struct stat file_stat;
+  unsigned char* vec = NULL;
+  uint64_t pages, i, resident = 0UL;
+  long page_size;
+  void* map;
+  int fd;
+
+  if( ( fd = open( file, O_RDONLY ) ) == ( -1 ) )
+  {
+    return -1.0;
+  }
+
+  if( fstat( fd, &file_stat ) || ( file_stat.st_size <= 0 ) )
+  {
+    ( void )close( fd );
+    return -1.0;
+  }
+
+  page_size = sysconf( _SC_PAGESIZE );
+  pages = ( ( uint64_t )file_stat.st_size + ( uint64_t )page_size - 1UL ) / 
+          ( uint64_t )page_size;
+
+  /* mapping the file does not fault any page in */
+  map = mmap( NULL, ( size_t )file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+  ( void )close( fd );
+
+  if( map == MAP_FAILED )
+  {
+    return -1.0;
+  }
+
+  if( ( vec = ( unsigned char* )malloc( ( size_t )pages ) ) && 
+      !mincore( map, ( size_t )file_stat.st_size, vec ) )
+  {
+    for( i = 0UL; i < pages; i++ )
+    {
+      resident += ( uint64_t )( vec[ i ] & 1U );
+    }
+  }
+  else
+  {
+    pages = 0UL;
+  }
+
+  free( ( void* )vec );
+  ( void )munmap( map, ( size_t )file_stat.st_size );
+
+  return pages ? 100.0 * ( double )resident / ( double )pages : -1.0;
+}
+
+
+uint8_t is_stream_input( const char* file )
+{
+  struct stat file_stat;
+
+  if( stat( file, &file_stat ) )
+  {
+    return 0x00U;
+  }
+  return S_ISREG( file_stat.st_mode ) ? 0x00U : 0xFFU;
+}
+
+
+/* Reads until buf is full or the end of the stream, 
+ * returns the number of bytes read. */
+static int64_t fill_from_stream( int fd, uint8_t* buf, uint64_t len )
+{
+  uint64_t got = 0UL;
+  ssize_t r;
+  double stage_start;
+
+  stage_start = crc_stats_begin();
+  while( got < len )
+  {
+    r = read( fd, ( void* )( buf + got ), ( size_t )( len - got ) );
+    if( ( r < 0 ) && ( errno == EINTR ) )
+    {
+      continue;
+    }
+    if( r < 0 )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      exit( EXIT_FAILURE );
+    }
+    if( !r )
+    {
+      break;
+    }
+    got += ( uint64_t )r;
+  }
+  crc_stats_end( CRC_STAGE_READ, stage_start, got );
+  return ( int64_t )got;
+}
+
+
+int32_t walk_stream( const uint8_t** buf, ssize_t chunk_len, 
+                     const char* file, uint8_t* more_fragments )
+{
+  static uint8_t* bufs[ 2 ] = { NULL, NULL };
+  static int64_t  pending_len = 0;
+  static uint8_t  pending = 0U;
+  static uint8_t  at_end = 0x00U;
+  static int fd = ( -1 );
+
+  struct stat file_stat;
+  int64_t len;
+  uint8_t out;
+  double stage_start;
+
+  if( !bufs[ 0 ] )
+  {
+    stage_start = crc_stats_begin();
+
+    if( ( chunk_len <= 0 ) || ( chunk_len > INT32_MAX ) )
+    {
+      ( void )fprintf( stderr, "Invalid chunk length.\n" );
+      exit( EXIT_FAILURE );
+    }
+
+    /* a socket on stdin can not be opened through /proc */
+    if( !strcmp( file, STDIN_PATH ) )
+    {
+      fd = STDIN_FILENO;
+    }
+    else if( ( fd = open( file, O_RDONLY ) ) == ( -1 ) )
+    {
+      ( void )fprintf( stderr, "%s\n", strerror( errno ) );
+      exit( EXIT_FAILURE );
+    }
+
+    if( !fstat( fd, &file_stat ) && S_ISFIFO( file_stat.st_mode ) )
+    {
+      /* fewer and larger reads, fails quietly if not permitted */
+      ( void )fcntl( fd, F_SETPIPE_SZ, STREAM_PIPE_SIZE );
+    }
+    ( void )fprintf( stdout, "\nReading a stream of unknown length.\n" );
+
+    bufs[ 0 ] = ( uint8_t* )malloc( ( size_t )chunk_len );
+    bufs[ 1 ] = ( uint8_t* )malloc( ( size_t )chunk_len );
+    if( !bufs[ 0 ] || !bufs[ 1 ] )
+    {
+      ( void )fprintf( stderr, "Failed to allocate workspace memory.\n" );
+      exit( EXIT_FAILURE );
+    }
+    crc_stats_end( CRC_STAGE_OPEN, stage_start, 0UL );
+
+    pending = 0U;
+    pending_len = fill_from_stream( fd, bufs[ 0 ], ( uint64_t )chunk_len );
+    at_end = ( pending_len < ( int64_t )chunk_len ) ? 0xFFU : 0x00U;
+  }
+
+  if( !pending_len )
+  {
+    /* end of the stream, the caller is done with the last chunk */
+    if( fd != STDIN_FILENO )
+    {
+      ( void )close( fd );
+    }
+    free( ( void* )bufs[ 0 ] );
+    free( ( void* )bufs[ 1 ] );
+    bufs[ 0 ] = NULL;
+    bufs[ 1 ] = NULL;
+    fd = ( -1 );
+    *more_fragments = 0x00U;
+    return 0;
+  }
+
+  /* Without a length the last chunk is only known once the 
+   * stream ends, so the next chunk is read ahead first. */
+  out = pending;
+  len = pending_len;
+
+  pending = ( uint8_t )( 1U - out );
+  pending_len = at_end ? 0 : fill_from_stream( fd, bufs[ pending ], 
+                                               ( uint64_t )chunk_len );
+  if( pending_len < ( int64_t )chunk_len )
+  {
+    at_end = 0xFFU;
+  }
+
+  if( !pending_len )
+  {
+    *more_fragments = 0x00U;
+  }
+
+  *buf = bufs[ out ];
+
+  return ( int32_t )len;
+}